@@ -0,0 +1,134 @@
+
+#include <tuple>
+#include <string>   // for to_string()
+#include <cstddef>  // for size_t
+
+#include <patton/memory.hpp>  // for cache_line_alignment
+#include <patton/buffer.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+
+namespace {
+
+
+using row_buffer = patton::aligned_row_buffer<float, patton::cache_line_alignment>;
+
+struct particle
+{
+    float x, y, z;
+    float vx, vy, vz;
+    float mass;
+    float charge;
+};
+using particle_fields = std::tuple<float, float, float, float, float, float, float, float>;
+
+void
+transpose(row_buffer& dest, row_buffer const& src)
+{
+        // Process the source in blocks of columns, so every block of destination rows is written column by column.
+    constexpr std::size_t blockSize = 16;
+    std::size_t n = src.rows();
+    for (std::size_t jb = 0; jb < n; jb += blockSize)
+    {
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            auto srcRow = src[i];
+            for (std::size_t j = jb, je = jb + blockSize < n ? jb + blockSize : n; j != je; ++j)
+            {
+                dest[j][i] = srcRow[j];
+            }
+        }
+    }
+}
+
+void
+stencil(row_buffer& dest, row_buffer const& src)
+{
+        // 5-point stencil which reads three rows and writes one row per step.
+    std::size_t n = src.rows();
+    for (std::size_t i = 1; i != n - 1; ++i)
+    {
+        auto above = src[i - 1];
+        auto center = src[i];
+        auto below = src[i + 1];
+        auto out = dest[i];
+        for (std::size_t j = 1; j != n - 1; ++j)
+        {
+            out[j] = 0.2f*(center[j] + center[j - 1] + center[j + 1] + above[j] + below[j]);
+        }
+    }
+}
+
+
+TEST_CASE("aligned_row_buffer<>: transpose and stencil with power-of-two rows")
+{
+    std::size_t n = GENERATE(std::size_t(512), std::size_t(1024), std::size_t(2048));
+    auto policy = GENERATE(patton::row_stride_policy::aligned, patton::row_stride_policy::anti_aliased);
+    char const* policyName = policy == patton::row_stride_policy::aligned ? "aligned" : "anti-aliased";
+
+    auto src = row_buffer(n, n, policy, std::in_place, 1.f);
+    auto dest = row_buffer(n, n, policy, std::in_place, 0.f);
+
+    BENCHMARK("transpose " + std::to_string(n) + "x" + std::to_string(n) + ", " + policyName + " rows (stride " + std::to_string(src.row_stride()) + " bytes)")
+    {
+        transpose(dest, src);
+        return dest[n - 1][0];
+    };
+    BENCHMARK("stencil " + std::to_string(n) + "x" + std::to_string(n) + ", " + policyName + " rows (stride " + std::to_string(src.row_stride()) + " bytes)")
+    {
+        stencil(dest, src);
+        return dest[1][1];
+    };
+}
+
+TEST_CASE("aligned_soa_buffer<>: particle update compared to aligned_buffer<>")
+{
+        // The update touches two of the eight fields of every particle.
+    constexpr std::size_t n = 1 << 20;
+    constexpr float dt = 0.01f;
+
+    auto aos = patton::aligned_buffer<particle, alignof(particle)>(n, particle{ 0, 0, 0, 1, 1, 1, 1, 0 });
+    auto paddedAos = patton::aligned_buffer<particle, patton::cache_line_alignment>(n, particle{ 0, 0, 0, 1, 1, 1, 1, 0 });
+    auto soa = patton::aligned_soa_buffer<particle_fields, patton::cache_line_alignment>(n, { 0, 0, 0, 1, 1, 1, 1, 0 });
+
+    BENCHMARK("AoS, aligned_buffer<> with natural alignment")
+    {
+        for (particle& p : aos)
+        {
+            p.x += p.vx*dt;
+        }
+        return aos[n - 1].x;
+    };
+    BENCHMARK("AoS, aligned_buffer<> with cache line alignment")
+    {
+        for (particle& p : paddedAos)
+        {
+            p.x += p.vx*dt;
+        }
+        return paddedAos[n - 1].x;
+    };
+    BENCHMARK("SoA, aligned_soa_buffer<> with field spans")
+    {
+        auto x = soa.field<0>();
+        auto vx = soa.field<3>();
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            x[i] += vx[i]*dt;
+        }
+        return x[n - 1];
+    };
+    BENCHMARK("SoA, aligned_soa_buffer<> with proxy iterator")
+    {
+        for (auto&& [x, y, z, vx, vy, vz, mass, charge] : soa)
+        {
+            x += vx*dt;
+        }
+        return soa.field<0>()[n - 1];
+    };
+}
+
+
+} // anonymous namespace
@@ -1,4 +1,13 @@
 
+#include <atomic>
+#include <thread>   // for this_thread::yield()
+#include <vector>
+#include <cstddef>  // for size_t
+
+#include <patton/new.hpp>
+#include <patton/memory.hpp>    // for numa_allocator<>
+#include <patton/buffer.hpp>
+#include <patton/topology.hpp>
 #include <patton/thread_squad.hpp>
 
 #include <catch2/catch_test_macros.hpp>
@@ -12,6 +21,52 @@
 #endif // defined(_WIN32) || defined(__linux__)
 
 
+namespace {
+
+
+    // Emulates the squad's barrier, whose data layout cannot be changed at runtime: thread i writes its flag `upward(i)`,
+    // and thread 0 collects all upward flags and then writes the flags `downward(i)` of all threads.
+template <typename DownwardT, typename UpwardT>
+void
+run_emulated_barriers(patton::thread_squad& threadSquad, DownwardT downward, UpwardT upward)
+{
+    threadSquad.run(
+        [downward, upward]
+        (patton::thread_squad::task_context ctx)
+        {
+            auto spinUntil = [](std::atomic_ref<int> flag, int value)
+            {
+                while (flag.load(std::memory_order_acquire) != value)
+                {
+                    std::this_thread::yield();
+                }
+            };
+
+            int i = ctx.thread_index();
+            for (int k = 1; k <= 100; ++k)
+            {
+                int sense = k & 1;
+                upward(i).store(sense, std::memory_order_release);
+                if (i == 0)
+                {
+                    for (int j = 0; j != ctx.num_threads(); ++j)
+                    {
+                        spinUntil(upward(j), sense);
+                    }
+                    for (int j = 0; j != ctx.num_threads(); ++j)
+                    {
+                        downward(j).store(sense, std::memory_order_release);
+                    }
+                }
+                spinUntil(downward(i), sense);
+            }
+        });
+}
+
+
+} // anonymous namespace
+
+
 TEST_CASE("thread_squad: create-run-destroy")
 {
     auto params = patton::thread_squad::params{
@@ -53,3 +108,148 @@ TEST_CASE("thread_squad: run")
         threadSquad.run(action);
     };
 }
+
+TEST_CASE("thread_squad: synchronize")
+{
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ global_benchmark_params.num_threads
+    };
+#ifdef THREAD_PINNING_SUPPORTED
+    params.pin_to_hardware_threads = true;
+#endif // !THREAD_PINNING_SUPPORTED
+
+    auto action = []
+    (patton::thread_squad::task_context ctx)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            ctx.synchronize();
+        }
+    };
+
+    auto threadSquad = patton::thread_squad(params);
+
+    BENCHMARK("run with 100 x synchronize()")
+    {
+        threadSquad.run(action);
+    };
+}
+
+TEST_CASE("thread_squad: sync block padding")
+{
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ global_benchmark_params.num_threads
+    };
+#ifdef THREAD_PINNING_SUPPORTED
+    params.pin_to_hardware_threads = true;
+#endif // !THREAD_PINNING_SUPPORTED
+
+    auto threadSquad = patton::thread_squad(params);
+
+        // Every thread has a block holding its downward flag and, one stride further, its upward flag. With a stride of one
+        // cache line, the line thread i writes to is adjacent to the line thread 0 writes to for thread i+1. The flags are
+        // stored contiguously in page-aligned storage, so only the stride determines their spacing.
+    auto runWithStride = [&threadSquad](std::size_t stride)
+    {
+        std::size_t intStride = stride/sizeof(int);
+        auto flags = patton::aligned_buffer<int, alignof(int), patton::page_allocator<int>>(2*intStride*threadSquad.num_threads(), 0);
+        run_emulated_barriers(threadSquad,
+            [&flags, intStride](int i) { return std::atomic_ref<int>(flags[2*intStride*i]); },
+            [&flags, intStride](int i) { return std::atomic_ref<int>(flags[2*intStride*i + intStride]); });
+    };
+
+    BENCHMARK("100 x barrier, sync blocks padded to hardware_cache_line_size()")
+    {
+        runWithStride(patton::hardware_cache_line_size());
+    };
+    BENCHMARK("100 x barrier, sync blocks padded to hardware_destructive_interference_size()")
+    {
+        runWithStride(patton::hardware_destructive_interference_size());
+    };
+}
+
+#ifdef THREAD_PINNING_SUPPORTED
+TEST_CASE("thread_squad: sync block NUMA placement")
+{
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ global_benchmark_params.num_threads
+    };
+    params.pin_to_hardware_threads = true;
+
+    auto threadSquad = patton::thread_squad(params);
+    auto threadNumaNodes = std::vector<int>(static_cast<std::size_t>(threadSquad.num_threads()));
+    threadSquad.run(
+        [&threadNumaNodes]
+        (patton::thread_squad::task_context ctx)
+        {
+            threadNumaNodes[static_cast<std::size_t>(ctx.thread_index())] = ctx.numa_node();
+        });
+
+        // Every thread has a page of its own which holds its downward flag and, on a separate line, its upward flag. The page is
+        // placed either on the NUMA node of the thread, as the squad does for its per-thread data, or on the first NUMA node.
+    auto runWithPlacement = [&threadSquad, &threadNumaNodes](bool placeOnThreadNode)
+    {
+        using block_allocator = patton::numa_allocator<int>;
+        constexpr std::size_t intStride = patton::max_hardware_destructive_interference_size/sizeof(int);
+        int firstNode = patton::cpu_topology::system().numa_nodes().front();
+        auto blocks = std::vector<std::vector<int, block_allocator>>{ };
+        for (int numaNode : threadNumaNodes)
+        {
+            auto alloc = block_allocator(patton::numa_policy::preferred, placeOnThreadNode ? numaNode : firstNode);
+            blocks.emplace_back(2*intStride, 0, alloc);
+        }
+        run_emulated_barriers(threadSquad,
+            [&blocks](int i) { return std::atomic_ref<int>(blocks[static_cast<std::size_t>(i)][0]); },
+            [&blocks](int i) { return std::atomic_ref<int>(blocks[static_cast<std::size_t>(i)][intStride]); });
+    };
+
+    BENCHMARK("100 x barrier, sync blocks on the first NUMA node")
+    {
+        runWithPlacement(false);
+    };
+    BENCHMARK("100 x barrier, sync blocks on the NUMA node of their thread")
+    {
+        runWithPlacement(true);
+    };
+}
+#endif // THREAD_PINNING_SUPPORTED
+
+TEST_CASE("thread_squad: per-thread counters")
+{
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ global_benchmark_params.num_threads
+    };
+#ifdef THREAD_PINNING_SUPPORTED
+    params.pin_to_hardware_threads = true;
+#endif // !THREAD_PINNING_SUPPORTED
+
+    auto threadSquad = patton::thread_squad(params);
+
+        // Every thread increments a counter of its own. With counters only one cache line apart, threads can still interfere
+        // through the adjacent-line prefetcher. The counters are stored contiguously in page-aligned storage, so only the
+        // stride determines their spacing.
+    auto runWithStride = [&threadSquad](std::size_t stride)
+    {
+        std::size_t intStride = stride/sizeof(int);
+        auto counters = patton::aligned_buffer<int, alignof(int), patton::page_allocator<int>>(intStride*threadSquad.num_threads(), 0);
+        threadSquad.run(
+            [&counters, intStride]
+            (patton::thread_squad::task_context ctx)
+            {
+                auto counter = std::atomic_ref<int>(counters[intStride*ctx.thread_index()]);
+                for (int i = 0; i < 10000; ++i)
+                {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    };
+
+    BENCHMARK("counters padded to hardware_cache_line_size()")
+    {
+        runWithStride(patton::hardware_cache_line_size());
+    };
+    BENCHMARK("counters padded to hardware_destructive_interference_size()")
+    {
+        runWithStride(patton::hardware_destructive_interference_size());
+    };
+}
@@ -5,19 +5,28 @@
 
 #include <new>           // for bad_alloc
 #include <span>
-#include <memory>        // for unique_ptr<>, allocator_traits<>
+#include <array>
+#include <tuple>         // for tuple<>, tuple_element<>, apply(), get<>()
+#include <memory>        // for unique_ptr<>, allocator_traits<>, uninitialized_fill(), uninitialized_value_construct()
+#include <vector>
 #include <cstddef>       // for size_t, ptrdiff_t
-#include <utility>       // for move(), forward<>(), exchange(), in_place
-#include <type_traits>   // for is_const<>, is_volatile<>, is_reference<>, is_nothrow_constructible<>, enable_if<>, negation<>
+#include <limits>
+#include <algorithm>     // for copy(), count(), max()
+#include <utility>       // for move(), move_if_noexcept(), forward<>(), exchange(), in_place, index_sequence<>
+#include <type_traits>   // for is_const<>, is_volatile<>, is_reference<>, is_nothrow_constructible<>, is_trivially_copyable<>, enable_if<>, negation<>
 #include <system_error>  // for errc
 
 #include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects(), owner<>
 
-#include <patton/memory.hpp>  // for aligned_allocator<>, aligned_allocator_adaptor<>
+#include <patton/thread.hpp>        // for current_numa_node()
+#include <patton/memory.hpp>        // for aligned_allocator<>, aligned_allocator_adaptor<>, aligned_allocator_traits<>, numa_allocator<>, default_init_allocator<>
+#include <patton/topology.hpp>
+#include <patton/thread_squad.hpp>
 
 #include <patton/detail/buffer.hpp>
 #include <patton/detail/arithmetic.hpp>   // for try_multiply_unsigned(), try_ceili()
 #include <patton/detail/transaction.hpp>
+#include <patton/detail/type_traits.hpp>  // for can_instantiate<>
 
 
 namespace patton {
@@ -34,6 +43,9 @@ namespace gsl = ::gsl_lite;
     //ᅟ
     // Supports special alignment values such as `cache_line_alignment`.
     // Multiple alignment requirements can be combined using bitmask operations, e.g. `cache_line_alignment | alignof(T)`.
+    // If a thread squad is passed to the constructor, the elements are constructed in parallel by the threads of the squad, each
+    // thread constructing the elements it is assigned by `thread_squad::task_context::partition(size)`. With a first-touch page
+    // placement policy, the pages of the buffer are then placed on the NUMA nodes of the threads which process them.
     //
 template <typename T, std::size_t Alignment, typename A = aligned_allocator<T, Alignment>>
 class aligned_buffer : private aligned_allocator_adaptor<T, Alignment | alignof(T), A>
@@ -63,7 +75,7 @@ private:
     }
 
     template <typename... Ts>
-    aligned_buffer(internal_constructor, std::size_t _size, allocator_type _allocator, Ts&&... args)
+    aligned_buffer(internal_constructor, thread_squad* squad, std::size_t _size, allocator_type _allocator, Ts&&... args)
         : allocator_type(std::move(_allocator)), size_(_size), bytesPerElement_(computeBytesPerElement())
     {
         if (_size == 0)
@@ -79,18 +91,50 @@ private:
             auto alloc = byte_allocator_(get_allocator());
             data_ = std::allocator_traits<byte_allocator_>::allocate(alloc, numBytes);
 
-            std::size_t numElementsConstructed;
-            auto transaction = detail::make_transaction(
-                std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
-                [this, &numElementsConstructed]
-                {
-                    detail::destroy_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, bytesPerElement_);
-                    auto alloc = byte_allocator_(get_allocator());
-                    std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, size_ * bytesPerElement_);
-                });
-            detail::construct_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, _size, bytesPerElement_,
-                std::is_nothrow_constructible<T, Ts...>{ }, std::forward<Ts>(args)...);
-            transaction.commit();
+            if (squad != nullptr)
+            {
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                    [this]
+                    {
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, size_ * bytesPerElement_);
+                    });
+                detail::construct_with_squad(*squad, _size, std::is_nothrow_constructible<T, Ts...>{ },
+                    [&](std::size_t first, std::size_t last)
+                    {
+                        std::size_t numElementsConstructed = 0;
+                        auto rangeTransaction = detail::make_transaction(
+                            std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                            [this, first, &numElementsConstructed]
+                            {
+                                detail::destroy_aligned_buffer<T>(data_ + first * bytesPerElement_, get_allocator(), numElementsConstructed, bytesPerElement_);
+                            });
+                        detail::construct_aligned_buffer<T>(data_ + first * bytesPerElement_, get_allocator(), numElementsConstructed, last - first, bytesPerElement_,
+                            std::is_nothrow_constructible<T, Ts...>{ }, args...);
+                        rangeTransaction.commit();
+                    },
+                    [this](std::size_t first, std::size_t last)
+                    {
+                        detail::destroy_aligned_buffer<T>(data_ + first * bytesPerElement_, get_allocator(), last - first, bytesPerElement_);
+                    });
+                transaction.commit();
+            }
+            else
+            {
+                std::size_t numElementsConstructed = 0;
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                    [this, &numElementsConstructed]
+                    {
+                        detail::destroy_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, bytesPerElement_);
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, size_ * bytesPerElement_);
+                    });
+                detail::construct_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, _size, bytesPerElement_,
+                    std::is_nothrow_constructible<T, Ts...>{ }, std::forward<Ts>(args)...);
+                transaction.commit();
+            }
         }
     }
     void
@@ -124,36 +168,67 @@ public:
     }
     template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
     explicit aligned_buffer(std::size_t _size)
-        : aligned_buffer(internal_constructor{ }, _size, { })
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, { })
     {
     }
     template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
     explicit aligned_buffer(std::size_t _size, T const& _value)
-        : aligned_buffer(internal_constructor{ }, _size, { }, _value)
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, { }, _value)
     {
     }
     explicit aligned_buffer(std::size_t _size, A _alloc)
-        : aligned_buffer(internal_constructor{ }, _size, std::move(_alloc))
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, std::move(_alloc))
     {
     }
     explicit aligned_buffer(std::size_t _size, T const& _value, A _alloc)
-        : aligned_buffer(internal_constructor{ }, _size, std::move(_alloc), _value)
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, std::move(_alloc), _value)
     {
     }
     template <typename... Ts,
               typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
     explicit aligned_buffer(std::size_t _size, std::in_place_t, Ts&&... _args)
-        : aligned_buffer(internal_constructor{ }, _size, { }, std::forward<Ts>(_args)...)
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, { }, std::forward<Ts>(_args)...)
     {
     }
     template <typename... Ts>
     explicit aligned_buffer(std::size_t _size, A _alloc, std::in_place_t, Ts&&... _args)
-        : aligned_buffer(internal_constructor{ }, _size, std::move(_alloc), std::forward<Ts>(_args)...)
+        : aligned_buffer(internal_constructor{ }, nullptr, _size, std::move(_alloc), std::forward<Ts>(_args)...)
+    {
+    }
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size, T const& _value)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, { }, _value)
+    {
+    }
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size, A _alloc)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, std::move(_alloc))
+    {
+    }
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size, T const& _value, A _alloc)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, std::move(_alloc), _value)
+    {
+    }
+    template <typename... Ts,
+              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size, std::in_place_t, Ts&&... _args)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, { }, std::forward<Ts>(_args)...)
+    {
+    }
+    template <typename... Ts>
+    explicit aligned_buffer(thread_squad& _squad, std::size_t _size, A _alloc, std::in_place_t, Ts&&... _args)
+        : aligned_buffer(internal_constructor{ }, &_squad, _size, std::move(_alloc), std::forward<Ts>(_args)...)
     {
     }
 
     constexpr aligned_buffer(aligned_buffer&& rhs) noexcept
-        : data_(std::exchange(rhs.data_, { })),
+        : allocator_type(std::move(rhs)),
+          data_(std::exchange(rhs.data_, { })),
           size_(std::exchange(rhs.size_, { })),
           bytesPerElement_(rhs.bytesPerElement_)
     {
@@ -167,6 +242,7 @@ public:
             {
                 destroy_and_free();
             }
+            static_cast<allocator_type&>(*this) = std::move(rhs);
             data_ = std::exchange(rhs.data_, { });
             size_ = std::exchange(rhs.size_, { });
             bytesPerElement_ = std::exchange(rhs.bytesPerElement_, 0);
@@ -263,21 +339,23 @@ public:
 
 
     //
-    // Two-dimensional buffer with aligned rows.
+    // Growable sequence of aligned elements.
     //ᅟ
-    //ᅟ    auto threadData = aligned_row_buffer<float, cache_line_alignment>(rows, cols);
-    //ᅟ    // every `threadData[i][0]` has cache-line alignment => no false sharing
+    //ᅟ    auto results = aligned_vector<Result, cache_line_alignment>{ };
+    //ᅟ    results.push_back(result);  // every element has cache-line alignment
     //ᅟ
-    // Supports special alignment values such as `cache_line_alignment`.
-    // Multiple alignment requirements can be combined using bitmask operations, e.g. `cache_line_alignment | alignof(T)`.
+    // Elements are padded to the given alignment like the elements of `aligned_buffer<>`. Supports special alignment values such
+    // as `cache_line_alignment`. Multiple alignment requirements can be combined using bitmask operations, e.g.
+    // `cache_line_alignment | alignof(T)`.
+    // If the element type is trivially copyable and the allocator provides a `reallocate()` member function, as
+    // `page_allocator<>` and `large_page_allocator<>` do, growth uses `reallocate()`, which remaps the pages of the storage on
+    // Linux rather than copying the elements.
     //
 template <typename T, std::size_t Alignment, typename A = aligned_allocator<T, Alignment>>
-class aligned_row_buffer : private aligned_allocator_adaptor<T, Alignment | alignof(T), A>
+class aligned_vector : private aligned_allocator_adaptor<T, Alignment | alignof(T), A>
 {
-    static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "buffer element type must not have cv qualifiers");
-    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
-
-    struct internal_constructor { };
+    static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "vector element type must not have cv qualifiers");
+    static_assert(!std::is_reference<T>::value, "vector element type must not be a reference");
 
 public:
     using allocator_type = aligned_allocator_adaptor<T, Alignment | alignof(T), A>;
@@ -286,108 +364,158 @@ private:
     using byte_allocator_ = typename std::allocator_traits<allocator_type>::template rebind_alloc<char>;
     static constexpr bool allocator_is_default_constructible_ = std::is_default_constructible<allocator_type>::value;
 
+        // The allocator can resize the storage in place only if it does not need to be adapted for alignment.
+    static constexpr bool can_reallocate_ = std::is_trivially_copyable<T>::value
+        && aligned_allocator_traits<A>::provides_static_alignment(Alignment | alignof(T))
+        && detail::can_instantiate_v<detail::allocator_reallocate_r, byte_allocator_>;
+
     gsl::owner<char*> data_;
-    std::size_t rows_;
-    std::size_t cols_;
-    std::size_t bytesPerRow_;
+    std::size_t size_; // # elements
+    std::size_t capacity_; // # elements
+    std::size_t bytesPerElement_;
 
-    template <typename... Ts>
-    aligned_row_buffer(internal_constructor, std::size_t _rows, std::size_t _cols, allocator_type _allocator, Ts&&... args)
-        : allocator_type(std::move(_allocator)), rows_(_rows), cols_(_cols)
+    std::size_t
+    static computeBytesPerElement()
     {
-        auto rawBytesPerRowR = detail::try_multiply_unsigned(sizeof(T), _cols);
-        auto bytesPerRowR = detail::try_ceili(rawBytesPerRowR.value, detail::alignment_in_bytes(Alignment | alignof(T)));
-        auto numBytesR = detail::try_multiply_unsigned(_rows, bytesPerRowR.value);
-        if (rawBytesPerRowR.ec != std::errc{ } || bytesPerRowR.ec != std::errc{ } || numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
-        bytesPerRow_ = bytesPerRowR.value;
+        auto bytesPerElementR = detail::try_ceili(sizeof(T), detail::alignment_in_bytes(Alignment | alignof(T)));
+        if (bytesPerElementR.ec != std::errc{ }) throw std::bad_alloc{ };
+        return bytesPerElementR.value;
+    }
 
-        if (_rows == 0 || _cols == 0)
+    void
+    reallocate(std::size_t newCapacity)
+    {
+        auto numBytesR = detail::try_multiply_unsigned(newCapacity, bytesPerElement_);
+        if (numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
+        std::size_t numBytes = numBytesR.value;
+
+        auto alloc = byte_allocator_(get_allocator());
+        if constexpr (can_reallocate_)
         {
-            data_ = nullptr;
+            if (data_ != nullptr)
+            {
+                data_ = alloc.reallocate(data_, capacity_ * bytesPerElement_, numBytes);
+                capacity_ = newCapacity;
+                return;
+            }
         }
-        else
-        {
-            auto alloc = byte_allocator_(get_allocator());
-            data_ = std::allocator_traits<byte_allocator_>::allocate(alloc, numBytesR.value);
 
-            std::size_t numElementsConstructed;
+        char* newData = std::allocator_traits<byte_allocator_>::allocate(alloc, numBytes);
+        std::size_t numElementsConstructed = 0;
+        {
             auto transaction = detail::make_transaction(
-                std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
-                [this, &numElementsConstructed]
+                [this, newData, numBytes, &numElementsConstructed]
                 {
-                    detail::destroy_aligned_row_buffer<T>(data_, get_allocator(), rows_, cols_, bytesPerRow_, numElementsConstructed);
+                    detail::destroy_aligned_buffer<T>(newData, get_allocator(), numElementsConstructed, bytesPerElement_);
                     auto alloc = byte_allocator_(get_allocator());
-                    std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, rows_ * bytesPerRow_);
+                    std::allocator_traits<byte_allocator_>::deallocate(alloc, newData, numBytes);
                 });
-            detail::construct_aligned_row_buffer<T>(data_, get_allocator(), numElementsConstructed, _rows, _cols, bytesPerRow_,
-                std::is_nothrow_constructible<T, Ts...>{ }, std::forward<Ts>(args)...);
+            auto elementAlloc = get_allocator();
+            for (std::size_t i = 0; i != size_; ++i)
+            {
+                std::allocator_traits<allocator_type>::construct(elementAlloc, reinterpret_cast<T*>(&newData[i * bytesPerElement_]),
+                    std::move_if_noexcept(*reinterpret_cast<T*>(&data_[i * bytesPerElement_])));
+                ++numElementsConstructed;
+            }
             transaction.commit();
         }
+        if (data_ != nullptr)
+        {
+            destroy_and_free();
+        }
+        data_ = newData;
+        capacity_ = newCapacity;
     }
-    void destroy_and_free() noexcept
+    void
+    grow_to(std::size_t newSize)
     {
-        detail::destroy_aligned_row_buffer<T>(data_, get_allocator(), rows_, cols_, bytesPerRow_);
+        if (newSize > capacity_)
+        {
+                // Grow geometrically to amortize the cost of reallocation.
+            std::size_t newCapacity = capacity_ <= std::numeric_limits<std::size_t>::max() / 2
+                ? std::max(newSize, 2*capacity_)
+                : newSize;
+            reallocate(newCapacity);
+        }
+    }
+    template <typename... Ts>
+    void
+    construct_back(std::size_t newSize, Ts&&... args)
+    {
+        std::size_t numElementsConstructed = 0;
+        auto transaction = detail::make_transaction(
+            std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+            [this, &numElementsConstructed]
+            {
+                detail::destroy_aligned_buffer<T>(data_ + size_ * bytesPerElement_, get_allocator(), numElementsConstructed, bytesPerElement_);
+            });
+        detail::construct_aligned_buffer<T>(data_ + size_ * bytesPerElement_, get_allocator(), numElementsConstructed, newSize - size_, bytesPerElement_,
+            std::is_nothrow_constructible<T, Ts...>{ }, std::forward<Ts>(args)...);
+        transaction.commit();
+        size_ = newSize;
+    }
+    void
+    destroy_and_free() noexcept
+    {
+        detail::destroy_aligned_buffer<T>(data_, get_allocator(), size_, bytesPerElement_);
         auto alloc = byte_allocator_(get_allocator());
-        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, rows_ * bytesPerRow_);
+        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, capacity_ * bytesPerElement_);
     }
 
 public:
+    using value_type = T;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
-    using reference = std::span<T>;
-    using const_reference = std::span<T const>;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using reference = T&;
+    using const_reference = T const&;
 
-    using iterator = detail::aligned_row_buffer_iterator<T>;
-    using const_iterator = detail::aligned_row_buffer_iterator<T const>;
+    using iterator = detail::aligned_buffer_iterator<T>;
+    using const_iterator = detail::aligned_buffer_iterator<T const>;
 
     template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
-    aligned_row_buffer() noexcept
-        : allocator_type{ }, data_(nullptr), rows_(0), cols_(0), bytesPerRow_(0)
+    aligned_vector()
+        : allocator_type{ }, data_(nullptr), size_(0), capacity_(0), bytesPerElement_(computeBytesPerElement())
     {
     }
-    aligned_row_buffer(allocator_type _alloc) noexcept
-        : allocator_type(std::move(_alloc)), data_(nullptr), rows_(0), cols_(0), bytesPerRow_(0)
+    explicit aligned_vector(A _alloc)
+        : allocator_type(std::move(_alloc)), data_(nullptr), size_(0), capacity_(0), bytesPerElement_(computeBytesPerElement())
     {
     }
     template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, { })
+    explicit aligned_vector(std::size_t _size)
+        : aligned_vector()
     {
+        resize(_size);
     }
     template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, T const& _value)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, { }, _value)
-    {
-    }
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, A _alloc)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, std::move(_alloc))
+    explicit aligned_vector(std::size_t _size, T const& _value)
+        : aligned_vector()
     {
+        resize(_size, _value);
     }
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, T const& _value, A _alloc)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, std::move(_alloc), _value)
-    {
-    }
-    template <typename... Ts,
-              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, std::in_place_t, Ts&&... _args)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, { }, std::forward<Ts>(_args)...)
+    explicit aligned_vector(std::size_t _size, A _alloc)
+        : aligned_vector(std::move(_alloc))
     {
+        resize(_size);
     }
-    template <typename... Ts>
-    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, A _alloc, std::in_place_t, Ts&&... _args)
-        : aligned_row_buffer(internal_constructor{ }, _rows, _cols, std::move(_alloc), std::forward<Ts>(_args)...)
+    explicit aligned_vector(std::size_t _size, T const& _value, A _alloc)
+        : aligned_vector(std::move(_alloc))
     {
+        resize(_size, _value);
     }
 
-    constexpr aligned_row_buffer(aligned_row_buffer&& rhs) noexcept
-        : data_(std::exchange(rhs.data_, { })),
-          rows_(std::exchange(rhs.rows_, { })),
-          cols_(std::exchange(rhs.cols_, { })),
-          bytesPerRow_(std::exchange(rhs.bytesPerRow_, { }))
+    aligned_vector(aligned_vector&& rhs) noexcept
+        : allocator_type(std::move(rhs)),
+          data_(std::exchange(rhs.data_, { })),
+          size_(std::exchange(rhs.size_, { })),
+          capacity_(std::exchange(rhs.capacity_, { })),
+          bytesPerElement_(rhs.bytesPerElement_)
     {
     }
-    constexpr aligned_row_buffer&
-    operator =(aligned_row_buffer&& rhs) noexcept
+    aligned_vector&
+    operator =(aligned_vector&& rhs) noexcept
     {
         if (this != &rhs)
         {
@@ -395,14 +523,16 @@ public:
             {
                 destroy_and_free();
             }
+            static_cast<allocator_type&>(*this) = std::move(rhs);
             data_ = std::exchange(rhs.data_, { });
-            rows_ = std::exchange(rhs.rows_, { });
-            cols_ = std::exchange(rhs.cols_, { });
-            bytesPerRow_ = std::exchange(rhs.bytesPerRow_, { });
+            size_ = std::exchange(rhs.size_, { });
+            capacity_ = std::exchange(rhs.capacity_, { });
+            bytesPerElement_ = rhs.bytesPerElement_;
         }
+        return *this;
     }
 
-    ~aligned_row_buffer()
+    ~aligned_vector()
     {
         if (data_ != nullptr)
         {
@@ -417,61 +547,146 @@ public:
     }
 
     [[nodiscard]] std::size_t
-    rows() const noexcept
+    size() const noexcept
     {
-        return rows_;
+        return size_;
     }
     [[nodiscard]] std::size_t
-    columns() const noexcept
+    capacity() const noexcept
     {
-        return cols_;
+        return capacity_;
+    }
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return size_ == 0;
     }
 
-    [[nodiscard]] std::size_t
-    size() const noexcept
+        //
+        // Ensures that the vector can hold at least `newCapacity` elements without reallocation.
+        //
+    void
+    reserve(std::size_t newCapacity)
     {
-        return rows();
+        if (newCapacity > capacity_)
+        {
+            reallocate(newCapacity);
+        }
     }
-    [[nodiscard]] std::span<T>
+
+        //
+        // Resizes the vector. New elements are value-initialized, or copy-constructed from `value`.
+        //
+    void
+    resize(std::size_t newSize)
+    {
+        if (newSize > size_)
+        {
+            grow_to(newSize);
+            construct_back(newSize);
+        }
+        else
+        {
+            detail::destroy_aligned_buffer<T>(data_ + newSize * bytesPerElement_, get_allocator(), size_ - newSize, bytesPerElement_);
+            size_ = newSize;
+        }
+    }
+    void
+    resize(std::size_t newSize, T const& value)
+    {
+        if (newSize > size_)
+        {
+            if (newSize > capacity_)
+            {
+                auto valueCopy = T(value);  // `value` may refer to an element of the vector
+                grow_to(newSize);
+                construct_back(newSize, valueCopy);
+            }
+            else
+            {
+                construct_back(newSize, value);
+            }
+        }
+        else
+        {
+            detail::destroy_aligned_buffer<T>(data_ + newSize * bytesPerElement_, get_allocator(), size_ - newSize, bytesPerElement_);
+            size_ = newSize;
+        }
+    }
+
+    template <typename... Ts>
+    reference
+    emplace_back(Ts&&... args)
+    {
+        if (size_ == capacity_)
+        {
+            auto value = T(std::forward<Ts>(args)...);  // the arguments may refer to elements of the vector
+            grow_to(size_ + 1);
+            construct_back(size_ + 1, std::move(value));
+        }
+        else
+        {
+            construct_back(size_ + 1, std::forward<Ts>(args)...);
+        }
+        return back();
+    }
+    void
+    push_back(T const& value)
+    {
+        emplace_back(value);
+    }
+    void
+    push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+    void
+    pop_back()
+    {
+        gsl_Expects(!empty());
+        resize(size_ - 1);
+    }
+    void
+    clear() noexcept
+    {
+        detail::destroy_aligned_buffer<T>(data_, get_allocator(), size_, bytesPerElement_);
+        size_ = 0;
+    }
+
+    [[nodiscard]] reference
     operator [](std::size_t i)
     {
-        gsl_Expects(i < rows_);
+        gsl_Expects(i < size_);
 
-        return { reinterpret_cast<T*>(&data_[i * bytesPerRow_]), cols_ };
+        return *reinterpret_cast<pointer>(&data_[i * bytesPerElement_]);
     }
-    [[nodiscard]] std::span<T const>
+    [[nodiscard]] const_reference
     operator [](std::size_t i) const
     {
-        gsl_Expects(i < rows_);
+        gsl_Expects(i < size_);
 
-        return { reinterpret_cast<T*>(&data_[i * bytesPerRow_]), cols_ };
+        return *reinterpret_cast<pointer>(&data_[i * bytesPerElement_]);
     }
 
     [[nodiscard]] iterator
     begin() noexcept
     {
-        return { data_, 0, cols_, bytesPerRow_ };
+        return { data_, 0, bytesPerElement_ };
     }
     [[nodiscard]] const_iterator
     begin() const noexcept
     {
-        return { data_, 0, cols_, bytesPerRow_ };
+        return { data_, 0, bytesPerElement_ };
     }
     [[nodiscard]] iterator
     end() noexcept
     {
-        return { data_, rows_, cols_, bytesPerRow_ };
+        return { data_, size_, bytesPerElement_ };
     }
     [[nodiscard]] const_iterator
     end() const noexcept
     {
-        return { data_, rows_, cols_, bytesPerRow_ };
-    }
-
-    [[nodiscard]] constexpr bool
-    empty() const noexcept
-    {
-        return rows_ == 0;
+        return { data_, size_, bytesPerElement_ };
     }
 
     [[nodiscard]] reference
@@ -501,6 +716,890 @@ public:
 };
 
 
+    //
+    // How the rows of `aligned_row_buffer<>` are laid out.
+    //
+enum class row_stride_policy
+{
+        //
+        // Every row is padded to the next multiple of the alignment.
+        //
+    aligned,
+
+        //
+        // Every row is padded further by multiples of the alignment if necessary, such that consecutive rows are spread across
+        // the sets of the L1 and L2 data caches.
+        //ᅟ
+        // With power-of-two row sizes, e.g. 1024 `float` elements, all rows start at the same cache set, so accessing a column
+        // or a stencil of neighbouring rows competes for the few ways of a single set, and loads and stores to different rows
+        // suffer from 4K aliasing. If the cache geometry is unknown, rows are padded only to the alignment.
+        //
+    anti_aliased
+};
+
+
+    //
+    // Two-dimensional buffer with aligned rows.
+    //ᅟ
+    //ᅟ    auto threadData = aligned_row_buffer<float, cache_line_alignment>(rows, cols);
+    //ᅟ    // every `threadData[i][0]` has cache-line alignment => no false sharing
+    //ᅟ
+    //ᅟ    auto image = aligned_row_buffer<float, cache_line_alignment>(1024, 1024, row_stride_policy::anti_aliased);
+    //ᅟ    // `image.row_stride() != 1024*sizeof(float)` => columns do not map to a single cache set
+    //ᅟ
+    // Supports special alignment values such as `cache_line_alignment`.
+    // Multiple alignment requirements can be combined using bitmask operations, e.g. `cache_line_alignment | alignof(T)`.
+    // If a thread squad is passed to the constructor, the rows are constructed in parallel by the threads of the squad, each
+    // thread constructing the rows it is assigned by `thread_squad::task_context::partition(rows)`.
+    //
+template <typename T, std::size_t Alignment, typename A = aligned_allocator<T, Alignment>>
+class aligned_row_buffer : private aligned_allocator_adaptor<T, Alignment | alignof(T), A>
+{
+    static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "buffer element type must not have cv qualifiers");
+    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
+
+    struct internal_constructor { };
+
+public:
+    using allocator_type = aligned_allocator_adaptor<T, Alignment | alignof(T), A>;
+
+private:
+    using byte_allocator_ = typename std::allocator_traits<allocator_type>::template rebind_alloc<char>;
+    static constexpr bool allocator_is_default_constructible_ = std::is_default_constructible<allocator_type>::value;
+
+    gsl::owner<char*> data_;
+    std::size_t rows_;
+    std::size_t cols_;
+    std::size_t bytesPerRow_;
+
+    template <typename... Ts>
+    aligned_row_buffer(internal_constructor, thread_squad* squad, std::size_t _rows, std::size_t _cols, row_stride_policy policy, allocator_type _allocator, Ts&&... args)
+        : allocator_type(std::move(_allocator)), rows_(_rows), cols_(_cols)
+    {
+        std::size_t alignment = detail::alignment_in_bytes(Alignment | alignof(T));
+        auto rawBytesPerRowR = detail::try_multiply_unsigned(sizeof(T), _cols);
+        auto bytesPerRowR = detail::try_ceili(rawBytesPerRowR.value, alignment);
+        if (rawBytesPerRowR.ec != std::errc{ } || bytesPerRowR.ec != std::errc{ }) throw std::bad_alloc{ };
+        bytesPerRow_ = policy == row_stride_policy::anti_aliased && _rows > 1
+            ? detail::anti_aliased_row_stride(bytesPerRowR.value, alignment)
+            : bytesPerRowR.value;
+        auto numBytesR = detail::try_multiply_unsigned(_rows, bytesPerRow_);
+        if (numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
+
+        if (_rows == 0 || _cols == 0)
+        {
+            data_ = nullptr;
+        }
+        else
+        {
+            auto alloc = byte_allocator_(get_allocator());
+            data_ = std::allocator_traits<byte_allocator_>::allocate(alloc, numBytesR.value);
+
+            if (squad != nullptr)
+            {
+                    // Rows are distributed across threads, so the elements of a row are always first touched by the same thread.
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                    [this]
+                    {
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, rows_ * bytesPerRow_);
+                    });
+                detail::construct_with_squad(*squad, _rows, std::is_nothrow_constructible<T, Ts...>{ },
+                    [&](std::size_t first, std::size_t last)
+                    {
+                        std::size_t numElementsConstructed = 0;
+                        auto rangeTransaction = detail::make_transaction(
+                            std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                            [this, first, last, &numElementsConstructed]
+                            {
+                                detail::destroy_aligned_row_buffer<T>(data_ + first * bytesPerRow_, get_allocator(), last - first, cols_, bytesPerRow_, numElementsConstructed);
+                            });
+                        detail::construct_aligned_row_buffer<T>(data_ + first * bytesPerRow_, get_allocator(), numElementsConstructed, last - first, cols_, bytesPerRow_,
+                            std::is_nothrow_constructible<T, Ts...>{ }, args...);
+                        rangeTransaction.commit();
+                    },
+                    [this](std::size_t first, std::size_t last)
+                    {
+                        detail::destroy_aligned_row_buffer<T>(data_ + first * bytesPerRow_, get_allocator(), last - first, cols_, bytesPerRow_);
+                    });
+                transaction.commit();
+            }
+            else
+            {
+                std::size_t numElementsConstructed = 0;
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_constructible<T, Ts...>>{ },
+                    [this, &numElementsConstructed]
+                    {
+                        detail::destroy_aligned_row_buffer<T>(data_, get_allocator(), rows_, cols_, bytesPerRow_, numElementsConstructed);
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, rows_ * bytesPerRow_);
+                    });
+                detail::construct_aligned_row_buffer<T>(data_, get_allocator(), numElementsConstructed, _rows, _cols, bytesPerRow_,
+                    std::is_nothrow_constructible<T, Ts...>{ }, std::forward<Ts>(args)...);
+                transaction.commit();
+            }
+        }
+    }
+    void destroy_and_free() noexcept
+    {
+        detail::destroy_aligned_row_buffer<T>(data_, get_allocator(), rows_, cols_, bytesPerRow_);
+        auto alloc = byte_allocator_(get_allocator());
+        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, rows_ * bytesPerRow_);
+    }
+
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::span<T>;
+    using const_reference = std::span<T const>;
+
+    using iterator = detail::aligned_row_buffer_iterator<T>;
+    using const_iterator = detail::aligned_row_buffer_iterator<T const>;
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    aligned_row_buffer() noexcept
+        : allocator_type{ }, data_(nullptr), rows_(0), cols_(0), bytesPerRow_(0)
+    {
+    }
+    aligned_row_buffer(allocator_type _alloc) noexcept
+        : allocator_type(std::move(_alloc)), data_(nullptr), rows_(0), cols_(0), bytesPerRow_(0)
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, T const& _value)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, { }, _value)
+    {
+    }
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, std::move(_alloc))
+    {
+    }
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, T const& _value, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, std::move(_alloc), _value)
+    {
+    }
+    template <typename... Ts,
+              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, { }, std::forward<Ts>(_args)...)
+    {
+    }
+    template <typename... Ts>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, A _alloc, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, row_stride_policy::aligned, std::move(_alloc), std::forward<Ts>(_args)...)
+    {
+    }
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, T const& _value)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, { }, _value)
+    {
+    }
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, std::move(_alloc))
+    {
+    }
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, T const& _value, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, std::move(_alloc), _value)
+    {
+    }
+    template <typename... Ts,
+              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, { }, std::forward<Ts>(_args)...)
+    {
+    }
+    template <typename... Ts>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, A _alloc, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, row_stride_policy::aligned, std::move(_alloc), std::forward<Ts>(_args)...)
+    {
+    }
+
+        //
+        // Constructs a buffer whose rows are laid out according to the given policy.
+        //
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy, T const& _value)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, { }, _value)
+    {
+    }
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, std::move(_alloc))
+    {
+    }
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy, T const& _value, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, std::move(_alloc), _value)
+    {
+    }
+    template <typename... Ts,
+              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, { }, std::forward<Ts>(_args)...)
+    {
+    }
+    template <typename... Ts>
+    explicit aligned_row_buffer(std::size_t _rows, std::size_t _cols, row_stride_policy _policy, A _alloc, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, nullptr, _rows, _cols, _policy, std::move(_alloc), std::forward<Ts>(_args)...)
+    {
+    }
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy, T const& _value)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, { }, _value)
+    {
+    }
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, std::move(_alloc))
+    {
+    }
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy, T const& _value, A _alloc)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, std::move(_alloc), _value)
+    {
+    }
+    template <typename... Ts,
+              typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, { }, std::forward<Ts>(_args)...)
+    {
+    }
+    template <typename... Ts>
+    explicit aligned_row_buffer(thread_squad& _squad, std::size_t _rows, std::size_t _cols, row_stride_policy _policy, A _alloc, std::in_place_t, Ts&&... _args)
+        : aligned_row_buffer(internal_constructor{ }, &_squad, _rows, _cols, _policy, std::move(_alloc), std::forward<Ts>(_args)...)
+    {
+    }
+
+    constexpr aligned_row_buffer(aligned_row_buffer&& rhs) noexcept
+        : allocator_type(std::move(rhs)),
+          data_(std::exchange(rhs.data_, { })),
+          rows_(std::exchange(rhs.rows_, { })),
+          cols_(std::exchange(rhs.cols_, { })),
+          bytesPerRow_(std::exchange(rhs.bytesPerRow_, { }))
+    {
+    }
+    constexpr aligned_row_buffer&
+    operator =(aligned_row_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (data_ != nullptr)
+            {
+                destroy_and_free();
+            }
+            static_cast<allocator_type&>(*this) = std::move(rhs);
+            data_ = std::exchange(rhs.data_, { });
+            rows_ = std::exchange(rhs.rows_, { });
+            cols_ = std::exchange(rhs.cols_, { });
+            bytesPerRow_ = std::exchange(rhs.bytesPerRow_, { });
+        }
+        return *this;
+    }
+
+    ~aligned_row_buffer()
+    {
+        if (data_ != nullptr)
+        {
+            destroy_and_free();
+        }
+    }
+
+    [[nodiscard]] allocator_type
+    get_allocator() const noexcept
+    {
+        return *this;
+    }
+
+    [[nodiscard]] std::size_t
+    rows() const noexcept
+    {
+        return rows_;
+    }
+    [[nodiscard]] std::size_t
+    columns() const noexcept
+    {
+        return cols_;
+    }
+
+        //
+        // The distance in bytes between the beginnings of consecutive rows.
+        //
+    [[nodiscard]] std::size_t
+    row_stride() const noexcept
+    {
+        return bytesPerRow_;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return rows();
+    }
+    [[nodiscard]] std::span<T>
+    operator [](std::size_t i)
+    {
+        gsl_Expects(i < rows_);
+
+        return { reinterpret_cast<T*>(&data_[i * bytesPerRow_]), cols_ };
+    }
+    [[nodiscard]] std::span<T const>
+    operator [](std::size_t i) const
+    {
+        gsl_Expects(i < rows_);
+
+        return { reinterpret_cast<T*>(&data_[i * bytesPerRow_]), cols_ };
+    }
+
+    [[nodiscard]] iterator
+    begin() noexcept
+    {
+        return { data_, 0, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] const_iterator
+    begin() const noexcept
+    {
+        return { data_, 0, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] iterator
+    end() noexcept
+    {
+        return { data_, rows_, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] const_iterator
+    end() const noexcept
+    {
+        return { data_, rows_, cols_, bytesPerRow_ };
+    }
+
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return rows_ == 0;
+    }
+
+    [[nodiscard]] reference
+    front()
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] const_reference
+    front() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] reference
+    back()
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+    [[nodiscard]] const_reference
+    back() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+};
+
+
+    //
+    // Buffer which stores every field of its elements in a separate aligned array, i.e. in structure-of-arrays layout.
+    //ᅟ
+    //ᅟ    auto particles = aligned_soa_buffer<std::tuple<float, float, float>, cache_line_alignment>(n);
+    //ᅟ    for (auto [x, v, m] : particles)  // element-wise access through tuples of references
+    //ᅟ    {
+    //ᅟ        x += v*dt;
+    //ᅟ    }
+    //ᅟ    std::span<float> xs = particles.field<0>();  // contiguous field access for vectorized kernels
+    //ᅟ
+    // The element type must be a `std::tuple<>` of trivially copyable and nothrow default constructible field types. All field
+    // arrays are placed in a single allocation, and every array begins at an address aligned to the given alignment.
+    // Supports special alignment values such as `cache_line_alignment`. Multiple alignment requirements can be combined using
+    // bitmask operations, e.g. `cache_line_alignment | page_alignment`.
+    // If a thread squad is passed to the constructor, the elements are constructed in parallel by the threads of the squad, each
+    // thread constructing the fields of the elements it is assigned by `thread_squad::task_context::partition(size)`.
+    //
+template <typename T, std::size_t Alignment, typename A = aligned_allocator<T, Alignment>>
+class aligned_soa_buffer;
+template <typename... Ts, std::size_t Alignment, typename A>
+class aligned_soa_buffer<std::tuple<Ts...>, Alignment, A> : private aligned_allocator_adaptor<std::tuple<Ts...>, (Alignment | ... | alignof(Ts)), A>
+{
+    static_assert(sizeof...(Ts) > 0, "buffer element type must have at least one field");
+    static_assert(((!std::is_const<Ts>::value && !std::is_volatile<Ts>::value) && ...), "buffer field types must not have cv qualifiers");
+    static_assert((std::is_trivially_copyable<Ts>::value && ...), "buffer field types must be trivially copyable");
+    static_assert((std::is_nothrow_default_constructible<Ts>::value && ...), "buffer field types must be nothrow default constructible");
+
+    struct internal_constructor { };
+
+public:
+    using allocator_type = aligned_allocator_adaptor<std::tuple<Ts...>, (Alignment | ... | alignof(Ts)), A>;
+
+private:
+    using byte_allocator_ = typename std::allocator_traits<allocator_type>::template rebind_alloc<char>;
+    static constexpr bool allocator_is_default_constructible_ = std::is_default_constructible<allocator_type>::value;
+    static constexpr std::size_t numFields_ = sizeof...(Ts);
+
+    gsl::owner<char*> data_;
+    std::size_t size_; // # elements
+    std::array<std::size_t, numFields_> offsets_;  // byte offsets of the field arrays
+    std::size_t numBytes_;
+
+    std::tuple<Ts*...>
+    field_pointers() const noexcept
+    {
+        return [this]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            return std::tuple<Ts*...>(reinterpret_cast<Ts*>(data_ + offsets_[Is])...);
+        }(std::index_sequence_for<Ts...>{ });
+    }
+
+    void
+    construct_range(std::size_t first, std::size_t last, std::tuple<Ts...> const* value) noexcept
+    {
+        std::apply(
+            [first, last, value](Ts*... fields)
+            {
+                if (value != nullptr)
+                {
+                    auto fill = [first, last](auto* field, auto const& fieldValue) { std::uninitialized_fill(field + first, field + last, fieldValue); };
+                    std::apply([&](Ts const&... fieldValues) { (fill(fields, fieldValues), ...); }, *value);
+                }
+                else
+                {
+                    (std::uninitialized_value_construct(fields + first, fields + last), ...);
+                }
+            },
+            field_pointers());
+    }
+
+    aligned_soa_buffer(internal_constructor, thread_squad* squad, std::size_t _size, allocator_type _allocator, std::tuple<Ts...> const* value)
+        : allocator_type(std::move(_allocator)), data_(nullptr), size_(_size), offsets_{ }, numBytes_(0)
+    {
+        std::size_t alignment = detail::alignment_in_bytes((Alignment | ... | alignof(Ts)));
+        constexpr std::size_t fieldSizes[] = { sizeof(Ts)... };
+        for (std::size_t i = 0; i != numFields_; ++i)
+        {
+            auto rawFieldBytesR = detail::try_multiply_unsigned(_size, fieldSizes[i]);
+            auto fieldBytesR = detail::try_ceili(rawFieldBytesR.value, alignment);
+            if (rawFieldBytesR.ec != std::errc{ } || fieldBytesR.ec != std::errc{ } || fieldBytesR.value > std::numeric_limits<std::size_t>::max() - numBytes_) throw std::bad_alloc{ };
+            offsets_[i] = numBytes_;
+            numBytes_ += fieldBytesR.value;
+        }
+
+        if (_size != 0)
+        {
+            auto alloc = byte_allocator_(get_allocator());
+            data_ = std::allocator_traits<byte_allocator_>::allocate(alloc, numBytes_);
+
+            if (squad != nullptr)
+            {
+                    // Every thread touches the same index range in all field arrays.
+                detail::construct_with_squad(*squad, _size, std::true_type{ },
+                    [this, value](std::size_t first, std::size_t last)
+                    {
+                        construct_range(first, last, value);
+                    },
+                    [](std::size_t, std::size_t) { });
+            }
+            else
+            {
+                construct_range(0, _size, value);
+            }
+        }
+    }
+    void
+    deallocate_storage() noexcept
+    {
+            // The fields are trivially destructible.
+        auto alloc = byte_allocator_(get_allocator());
+        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, numBytes_);
+    }
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<Ts const&...>;
+
+    using iterator = detail::aligned_soa_buffer_iterator<Ts...>;
+    using const_iterator = detail::aligned_soa_buffer_iterator<Ts const...>;
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    aligned_soa_buffer() noexcept
+        : allocator_type{ }, data_(nullptr), size_(0), offsets_{ }, numBytes_(0)
+    {
+    }
+    aligned_soa_buffer(allocator_type _alloc) noexcept
+        : allocator_type(std::move(_alloc)), data_(nullptr), size_(0), offsets_{ }, numBytes_(0)
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_soa_buffer(std::size_t _size)
+        : aligned_soa_buffer(internal_constructor{ }, nullptr, _size, { }, nullptr)
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_soa_buffer(std::size_t _size, value_type const& _value)
+        : aligned_soa_buffer(internal_constructor{ }, nullptr, _size, { }, &_value)
+    {
+    }
+    explicit aligned_soa_buffer(std::size_t _size, A _alloc)
+        : aligned_soa_buffer(internal_constructor{ }, nullptr, _size, std::move(_alloc), nullptr)
+    {
+    }
+    explicit aligned_soa_buffer(std::size_t _size, value_type const& _value, A _alloc)
+        : aligned_soa_buffer(internal_constructor{ }, nullptr, _size, std::move(_alloc), &_value)
+    {
+    }
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_soa_buffer(thread_squad& _squad, std::size_t _size)
+        : aligned_soa_buffer(internal_constructor{ }, &_squad, _size, { }, nullptr)
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_soa_buffer(thread_squad& _squad, std::size_t _size, value_type const& _value)
+        : aligned_soa_buffer(internal_constructor{ }, &_squad, _size, { }, &_value)
+    {
+    }
+    explicit aligned_soa_buffer(thread_squad& _squad, std::size_t _size, A _alloc)
+        : aligned_soa_buffer(internal_constructor{ }, &_squad, _size, std::move(_alloc), nullptr)
+    {
+    }
+    explicit aligned_soa_buffer(thread_squad& _squad, std::size_t _size, value_type const& _value, A _alloc)
+        : aligned_soa_buffer(internal_constructor{ }, &_squad, _size, std::move(_alloc), &_value)
+    {
+    }
+
+    constexpr aligned_soa_buffer(aligned_soa_buffer&& rhs) noexcept
+        : allocator_type(std::move(rhs)),
+          data_(std::exchange(rhs.data_, { })),
+          size_(std::exchange(rhs.size_, { })),
+          offsets_(std::exchange(rhs.offsets_, { })),
+          numBytes_(std::exchange(rhs.numBytes_, { }))
+    {
+    }
+    constexpr aligned_soa_buffer&
+    operator =(aligned_soa_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (data_ != nullptr)
+            {
+                deallocate_storage();
+            }
+            static_cast<allocator_type&>(*this) = std::move(rhs);
+            data_ = std::exchange(rhs.data_, { });
+            size_ = std::exchange(rhs.size_, { });
+            offsets_ = std::exchange(rhs.offsets_, { });
+            numBytes_ = std::exchange(rhs.numBytes_, { });
+        }
+        return *this;
+    }
+
+    ~aligned_soa_buffer()
+    {
+        if (data_ != nullptr)
+        {
+            deallocate_storage();
+        }
+    }
+
+    [[nodiscard]] allocator_type
+    get_allocator() const noexcept
+    {
+        return *this;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+        //
+        // The contiguous array of field `I` of all elements.
+        //
+    template <std::size_t I>
+    [[nodiscard]] std::span<std::tuple_element_t<I, value_type>>
+    field() noexcept
+    {
+        return { std::get<I>(field_pointers()), size_ };
+    }
+    template <std::size_t I>
+    [[nodiscard]] std::span<std::tuple_element_t<I, value_type> const>
+    field() const noexcept
+    {
+        return { std::get<I>(field_pointers()), size_ };
+    }
+
+    [[nodiscard]] reference
+    operator [](std::size_t i)
+    {
+        gsl_Expects(i < size_);
+
+        return *iterator(field_pointers(), i);
+    }
+    [[nodiscard]] const_reference
+    operator [](std::size_t i) const
+    {
+        gsl_Expects(i < size_);
+
+        return *const_iterator(field_pointers(), i);
+    }
+
+    [[nodiscard]] iterator
+    begin() noexcept
+    {
+        return { field_pointers(), 0 };
+    }
+    [[nodiscard]] const_iterator
+    begin() const noexcept
+    {
+        return { field_pointers(), 0 };
+    }
+    [[nodiscard]] iterator
+    end() noexcept
+    {
+        return { field_pointers(), size_ };
+    }
+    [[nodiscard]] const_iterator
+    end() const noexcept
+    {
+        return { field_pointers(), size_ };
+    }
+
+    [[nodiscard]] reference
+    front()
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] const_reference
+    front() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] reference
+    back()
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+    [[nodiscard]] const_reference
+    back() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+};
+
+
+    //
+    // Read-mostly buffer which keeps a replica of its elements on every NUMA node.
+    //ᅟ
+    //ᅟ    auto table = replicated_buffer<float>(squad, std::span<float const>(values));
+    //ᅟ    squad.run([&](thread_squad::task_context& ctx)
+    //ᅟ    {
+    //ᅟ        std::span<float const> localTable = table.local(ctx);
+    //ᅟ        ...
+    //ᅟ    });
+    //ᅟ
+    // Every replica is allocated with `numa_allocator<>` on its NUMA node and filled in parallel by the threads of the squad
+    // which run on that node. Reading the node-local replica avoids cross-node memory traffic for data accessed by all threads.
+    // Modifications must be applied to every replica, cf. `replica()`. Like `numa_allocator<>`, the buffer supports only NUMA nodes
+    // with ids below 64.
+    //
+template <typename T>
+class replicated_buffer
+{
+    static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "buffer element type must not have cv qualifiers");
+    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
+
+public:
+        // Replicas default-initialize their elements, so the elements copied by the span constructor are written only once.
+    using replica_type = aligned_buffer<T, alignof(T), default_init_allocator<T, numa_allocator<T>>>;
+
+private:
+    std::size_t size_;
+    std::vector<int> numaNodes_;       // NUMA node ids of the replicas
+    std::vector<int> replicaIndices_;  // maps NUMA node ids to indices in `replicas_`, or -1
+    std::vector<replica_type> replicas_;
+
+    static default_init_allocator<T, numa_allocator<T>>
+    allocator_for(int numaNode)
+    {
+            // Fails if the node id exceeds the range supported by `numa_allocator<>`.
+        return default_init_allocator<T, numa_allocator<T>>(numa_policy::preferred, numaNode);
+    }
+
+    template <typename... Ts>
+    void
+    allocate_replicas(thread_squad& squad, Ts const&... args)
+    {
+        auto const& topology = cpu_topology::system();
+        auto numaNodes = topology.numa_nodes();
+        numaNodes_.assign(numaNodes.begin(), numaNodes.end());
+        replicaIndices_.assign(static_cast<std::size_t>(numaNodes_.back() + 1), -1);
+        replicas_.reserve(numaNodes_.size());
+        for (std::size_t i = 0; i != numaNodes_.size(); ++i)
+        {
+            replicaIndices_[static_cast<std::size_t>(numaNodes_[i])] = static_cast<int>(i);
+            replicas_.emplace_back(squad, size_, args..., allocator_for(numaNodes_[i]));
+        }
+    }
+
+public:
+        //
+        // Constructs a buffer with `_size` copies of `_value` on every NUMA node.
+        //
+    explicit replicated_buffer(thread_squad& _squad, std::size_t _size, T const& _value)
+        : size_(_size)
+    {
+        allocate_replicas(_squad, _value);
+    }
+
+        //
+        // Constructs a buffer with a copy of the given elements on every NUMA node.
+        //ᅟ
+        // The elements are copied by the threads of the squad. Every replica is filled by the squad threads running on its NUMA
+        // node, or by all threads if there are none.
+        //
+    explicit replicated_buffer(thread_squad& _squad, std::span<T const> _data)
+        : size_(_data.size())
+    {
+        allocate_replicas(_squad);
+
+            // Determine which threads fill which replica.
+        auto threadNumaNodes = std::vector<int>(static_cast<std::size_t>(_squad.num_threads()));
+        _squad.run([&threadNumaNodes](thread_squad::task_context& ctx)
+        {
+            threadNumaNodes[static_cast<std::size_t>(ctx.thread_index())] = ctx.numa_node();
+        });
+        auto numFillingThreads = std::vector<int>(replicas_.size(), 0);
+        for (int numaNode : threadNumaNodes)
+        {
+            int replicaIdx = numaNode >= 0 && numaNode < std::ssize(replicaIndices_) ? replicaIndices_[static_cast<std::size_t>(numaNode)] : -1;
+            if (replicaIdx >= 0) ++numFillingThreads[static_cast<std::size_t>(replicaIdx)];
+        }
+
+        _squad.run([this, _data, &threadNumaNodes, &numFillingThreads](thread_squad::task_context& ctx)
+        {
+            int numaNode = threadNumaNodes[static_cast<std::size_t>(ctx.thread_index())];
+            for (std::size_t r = 0; r != replicas_.size(); ++r)
+            {
+                    // Find the rank of the current thread among the threads which fill replica `r`.
+                int rank = ctx.thread_index();
+                int numThreads = ctx.num_threads();
+                if (numFillingThreads[r] != 0)
+                {
+                    if (numaNode != numaNodes_[r]) continue;
+                    rank = static_cast<int>(std::count(threadNumaNodes.begin(), threadNumaNodes.begin() + ctx.thread_index(), numaNode));
+                    numThreads = numFillingThreads[r];
+                }
+                auto [first, last] = detail::static_partition(size_, rank, numThreads);
+                std::copy(_data.begin() + static_cast<std::ptrdiff_t>(first), _data.begin() + static_cast<std::ptrdiff_t>(last),
+                    replicas_[r].begin() + static_cast<std::ptrdiff_t>(first));
+            }
+        });
+    }
+
+        //
+        // The number of elements.
+        //
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+        //
+        // The ids of the NUMA nodes which hold a replica, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    numa_nodes() const noexcept
+    {
+        return numaNodes_;
+    }
+
+        //
+        // The replica on the given NUMA node, or the first replica if there is no replica on that node.
+        //
+    [[nodiscard]] replica_type&
+    replica(int numaNode) noexcept
+    {
+        int replicaIdx = numaNode >= 0 && numaNode < std::ssize(replicaIndices_) ? replicaIndices_[static_cast<std::size_t>(numaNode)] : -1;
+        return replicas_[static_cast<std::size_t>(std::max(replicaIdx, 0))];
+    }
+    [[nodiscard]] replica_type const&
+    replica(int numaNode) const noexcept
+    {
+        return const_cast<replicated_buffer&>(*this).replica(numaNode);
+    }
+
+        //
+        // The replica on the NUMA node the calling thread currently runs on.
+        //
+    [[nodiscard]] std::span<T const>
+    local() const noexcept
+    {
+        return as_span(replica(current_numa_node()));
+    }
+
+        //
+        // The replica on the NUMA node the thread executing the given task runs on.
+        //
+    [[nodiscard]] std::span<T const>
+    local(thread_squad::task_context const& ctx) const noexcept
+    {
+        return as_span(replica(ctx.numa_node()));
+    }
+
+private:
+    static std::span<T const>
+    as_span(replica_type const& replica) noexcept
+    {
+            // Elements are contiguous because the replicas use the natural alignment of `T`.
+        return !replica.empty() ? std::span<T const>(&replica.front(), replica.size()) : std::span<T const>{ };
+    }
+};
+
+
 } // namespace patton
 
 
@@ -3,14 +3,19 @@
 #define INCLUDED_PATTON_DETAIL_BUFFER_HPP_
 
 
+#include <tuple>
 #include <memory>       // for allocator_traits<>
+#include <vector>
 #include <compare>
 #include <cstddef>      // for size_t, ptrdiff_t
 #include <iterator>     // for input_iterator_tag, output_iterator_tag, random_access_iterator_tag
+#include <exception>    // for exception_ptr, current_exception(), rethrow_exception()
 #include <type_traits>  // for integral_constant<>, enable_if<>, is_const<>, is_same<>, is_nothrow_default_constructible<>
 
 #include <gsl-lite/gsl-lite.hpp> // for gsl_Expects()
 
+#include <patton/thread_squad.hpp>
+
 
 namespace patton {
 
@@ -20,15 +25,33 @@ namespace gsl = ::gsl_lite;
 template <typename T, std::size_t Alignment, typename A>
 class aligned_buffer;
 
+template <typename T, std::size_t Alignment, typename A>
+class aligned_vector;
+
 template <typename T, std::size_t Alignment, typename A>
 class aligned_row_buffer;
 
+template <typename T, std::size_t Alignment, typename A>
+class aligned_soa_buffer;
+
+template <typename T, std::size_t Alignment>
+class mapped_buffer;
+
+template <typename T, std::size_t Alignment>
+class mapped_row_buffer;
+
 
 }  // namespace patton
 
 namespace patton::detail {
 
 
+    // Returns the smallest stride which is not less than `rowStride`, differs from it by a multiple of `alignment`, and spreads
+    // consecutive rows across the sets of the L1 and L2 data caches, or `rowStride` if no such stride is found.
+[[nodiscard]] std::size_t
+anti_aliased_row_stride(std::size_t rowStride, std::size_t alignment) noexcept;
+
+
 template <typename T, typename A, typename... Ts>
 void
 construct_aligned_buffer(char* data, A alloc, std::size_t& numElementsConstructed, std::size_t size, std::size_t bytesPerElement,
@@ -48,6 +71,7 @@ construct_aligned_buffer(char* data, A alloc, std::size_t& numElementsConstructe
     std::false_type /*isNothrowConstructible*/,
     Ts&&... args)
 {
+    numElementsConstructed = 0;
     for (std::ptrdiff_t i = 0, d = std::ptrdiff_t(bytesPerElement), e = std::ptrdiff_t(size * bytesPerElement); i != e; i += d)
     {
         std::allocator_traits<A>::construct(alloc, reinterpret_cast<T*>(&data[i]), args...);
@@ -134,10 +158,71 @@ noexcept
 }
 
 
+    // Calls `constructRange(first, last)` on every thread of the squad for the index range assigned to the thread by
+    // `task_context::partition(size)`, such that every page is first touched by the thread which will process it later.
+    // `constructRange()` must destroy the elements it constructed before letting an exception escape. If construction fails on
+    // any thread, the ranges constructed by all other threads are destroyed with `destroyRange(first, last)`, and the first
+    // exception is rethrown.
+template <typename ConstructRangeFuncT, typename DestroyRangeFuncT>
+void
+construct_with_squad(thread_squad& squad, std::size_t size, std::true_type /*isNothrowConstructible*/,
+    ConstructRangeFuncT const& constructRange, DestroyRangeFuncT const& /*destroyRange*/)
+{
+    squad.run([size, &constructRange](thread_squad::task_context& ctx)
+    {
+        auto [first, last] = ctx.partition(size);
+        constructRange(first, last);
+    });
+}
+template <typename ConstructRangeFuncT, typename DestroyRangeFuncT>
+void
+construct_with_squad(thread_squad& squad, std::size_t size, std::false_type /*isNothrowConstructible*/,
+    ConstructRangeFuncT const& constructRange, DestroyRangeFuncT const& destroyRange)
+{
+    auto errors = std::vector<std::exception_ptr>(static_cast<std::size_t>(squad.num_threads()));
+    squad.run([size, &constructRange, &errors](thread_squad::task_context& ctx)
+    {
+        auto [first, last] = ctx.partition(size);
+        try
+        {
+            constructRange(first, last);
+        }
+        catch (...)
+        {
+            errors[static_cast<std::size_t>(ctx.thread_index())] = std::current_exception();
+        }
+    });
+
+    std::exception_ptr error;
+    for (int i = 0, n = squad.num_threads(); i != n; ++i)
+    {
+        if (errors[static_cast<std::size_t>(i)] != nullptr)
+        {
+            error = errors[static_cast<std::size_t>(i)];
+            break;
+        }
+    }
+    if (error != nullptr)
+    {
+        for (int i = 0, n = squad.num_threads(); i != n; ++i)
+        {
+            if (errors[static_cast<std::size_t>(i)] == nullptr)
+            {
+                auto [first, last] = detail::static_partition(size, i, n);
+                destroyRange(first, last);
+            }
+        }
+        std::rethrow_exception(error);
+    }
+}
+
+
 template <typename T>
 class aligned_buffer_iterator
 {
     template <typename, std::size_t, typename> friend class patton::aligned_buffer;
+    template <typename, std::size_t, typename> friend class patton::aligned_vector;
+    template <typename, std::size_t> friend class patton::mapped_buffer;
 
 private:
     char* data_;
@@ -282,6 +367,7 @@ template <typename T>
 class aligned_row_buffer_iterator
 {
     template <typename, std::size_t, typename> friend class patton::aligned_row_buffer;
+    template <typename, std::size_t> friend class patton::mapped_row_buffer;
 
 private:
     char* data_;
@@ -416,6 +502,136 @@ public:
 };
 
 
+    // Iterates over the elements of `aligned_soa_buffer<std::tuple<Ts...>>`, or of `aligned_soa_buffer<std::tuple<Us...>> const`
+    // with `Ts` = `Us const`. Dereferencing yields a tuple of references to the fields of an element.
+template <typename... Ts>
+class aligned_soa_buffer_iterator
+{
+    template <typename, std::size_t, typename> friend class patton::aligned_soa_buffer;
+    template <typename...> friend class aligned_soa_buffer_iterator;
+
+private:
+    std::tuple<Ts*...> fields_;
+    std::size_t index_;
+
+    aligned_soa_buffer_iterator(std::tuple<Ts*...> const& _fields, std::size_t _index)
+        : fields_(_fields), index_(_index)
+    {
+    }
+
+public:
+    constexpr aligned_soa_buffer_iterator() noexcept
+        : fields_{ }, index_(0)
+    {
+    }
+
+    aligned_soa_buffer_iterator(aligned_soa_buffer_iterator const&) = default;
+    aligned_soa_buffer_iterator&
+    operator =(aligned_soa_buffer_iterator const&) = default;
+
+    template <typename... Us>
+        requires (sizeof...(Us) == sizeof...(Ts)) && (!std::is_same<std::tuple<Us...>, std::tuple<Ts...>>::value)
+            && std::is_same<std::tuple<Us const...>, std::tuple<Ts...>>::value
+    aligned_soa_buffer_iterator(aligned_soa_buffer_iterator<Us...> const& rhs) noexcept
+        : fields_(rhs.fields_), index_(rhs.index_)
+    {
+    }
+
+    using iterator_concept  = std::random_access_iterator_tag;
+    using iterator_category = input_output_iterator_tag;
+    using value_type        = std::tuple<std::remove_const_t<Ts>...>;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = std::tuple<Ts&...>;
+
+    bool
+    operator ==(aligned_soa_buffer_iterator const& rhs) const
+    {
+        gsl_Expects(fields_ == rhs.fields_);
+
+        return index_ == rhs.index_;
+    }
+    auto
+    operator <=>(aligned_soa_buffer_iterator const& rhs) const
+    {
+        gsl_Expects(fields_ == rhs.fields_);
+
+        return index_ <=> rhs.index_;
+    }
+
+    [[nodiscard]] reference
+    operator *() const
+    {
+        return std::apply([i = index_](Ts*... fields) { return reference(fields[i]...); }, fields_);
+    }
+    aligned_soa_buffer_iterator&
+    operator ++()
+    {
+        ++index_;
+        return *this;
+    }
+    aligned_soa_buffer_iterator&
+    operator --()
+    {
+        --index_;
+        return *this;
+    }
+    aligned_soa_buffer_iterator
+    operator ++(int)
+    {
+        aligned_soa_buffer_iterator result = *this;
+        ++index_;
+        return result;
+    }
+    aligned_soa_buffer_iterator
+    operator --(int)
+    {
+        aligned_soa_buffer_iterator result = *this;
+        --index_;
+        return result;
+    }
+    aligned_soa_buffer_iterator&
+    operator +=(difference_type d)
+    {
+        index_ += d;
+        return *this;
+    }
+    aligned_soa_buffer_iterator
+    operator +(difference_type d) const
+    {
+        aligned_soa_buffer_iterator result = *this;
+        return result += d;
+    }
+    friend aligned_soa_buffer_iterator
+    operator +(difference_type d, aligned_soa_buffer_iterator const& self)
+    {
+        aligned_soa_buffer_iterator result = self;
+        return result += d;
+    }
+    aligned_soa_buffer_iterator&
+    operator -=(difference_type d)
+    {
+        index_ -= d;
+        return *this;
+    }
+    aligned_soa_buffer_iterator
+    operator -(difference_type d) const
+    {
+        aligned_soa_buffer_iterator result = *this;
+        return result -= d;
+    }
+    difference_type
+    operator -(aligned_soa_buffer_iterator const& rhs) const
+    {
+        return difference_type(index_ - rhs.index_);
+    }
+    reference
+    operator [](difference_type d) const
+    {
+        return *(*this + d);
+    }
+};
+
+
 } // namespace patton::detail
 
 
@@ -5,13 +5,16 @@
 
 #include <limits>
 #include <memory>       // for allocator_traits<>
-#include <cstdint>      // for uint32_t
+#include <cstdint>      // for uint32_t, uint64_t
 #include <cstddef>      // for size_t, ptrdiff_t, max_align_t
+#include <cstring>      // for memcpy()
 #include <utility>      // for forward<>()
 #include <type_traits>  // for integral_constant<>, declval<>(), void_t<>, negation<>
 
 #include <gsl-lite/gsl-lite.hpp>
 
+#include <patton/new.hpp>  // for hardware_large_page_size(), hardware_page_size(), hardware_cache_line_size()
+
 #include <patton/detail/transaction.hpp>
 
 
@@ -19,6 +22,9 @@ namespace patton {
 
 namespace gsl = ::gsl_lite;
 
+enum class numa_policy : int;
+enum class page_flags : unsigned;
+
 namespace detail {
 
 
@@ -61,8 +67,48 @@ constexpr raw_alignment_in_bytes(std::size_t a) noexcept
     return std::max(std::size_t(1), floor_2p(a));
 }
 
+
+#if defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
+    // = large_page_alignment, page_alignment, cache_line_alignment
+constexpr std::size_t large_page_alignment_flag = std::size_t(-1) & ~(std::size_t(-1) >> 1);
+constexpr std::size_t page_alignment_flag = large_page_alignment_flag >> 1;
+constexpr std::size_t cache_line_alignment_flag = large_page_alignment_flag >> 2;
+
+std::size_t
+constexpr lookup_special_alignments(std::size_t a) noexcept
+{
+    if ((a & large_page_alignment_flag) != 0)
+    {
+            // This is without effect if `hardware_large_page_size()` is 0, i.e. if large pages are not supported.
+        a |= hardware_large_page_size();
+    }
+    if ((a & (large_page_alignment_flag | page_alignment_flag)) != 0)
+    {
+        a |= hardware_page_size();
+    }
+    if ((a & cache_line_alignment_flag) != 0)
+    {
+        a |= hardware_cache_line_size();
+    }
+
+        // Mask out flags with special meaning.
+    a &= ~special_alignments;
+
+    return a;
+}
+
+std::size_t
+constexpr alignment_in_bytes(std::size_t a) noexcept
+{
+    return std::max(std::size_t(1), floor_2p(detail::lookup_special_alignments(a)));
+}
+#else // ^^^ defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN) ^^^ / vvv !defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN) vvv
+std::size_t
+lookup_special_alignments(std::size_t a) noexcept;
+
 std::size_t
 alignment_in_bytes(std::size_t a) noexcept;
+#endif // defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
 
 template <typename T>
 bool
@@ -76,6 +122,10 @@ constexpr is_alignment_power_of_2(T value) noexcept
 bool
 constexpr provides_static_alignment(std::size_t alignmentProvided, std::size_t alignmentRequested) noexcept
 {
+#if defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
+        // All special alignments are known at compile time, so we can compare actual alignments.
+    return detail::alignment_in_bytes(alignmentProvided) >= detail::alignment_in_bytes(alignmentRequested);
+#else // ^^^ defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN) ^^^ / vvv !defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN) vvv
     std::size_t basicAlignmentProvided = alignmentProvided & ~special_alignments;
     std::size_t basicAlignmentRequested = alignmentRequested & ~special_alignments;
     if ((alignmentProvided & special_alignments) != 0)
@@ -86,11 +136,10 @@ constexpr provides_static_alignment(std::size_t alignmentProvided, std::size_t a
 
     return detail::raw_alignment_in_bytes(basicAlignmentProvided) >= detail::raw_alignment_in_bytes(basicAlignmentRequested)
         && (alignmentProvided & special_alignments) >= (alignmentRequested & special_alignments);
+#endif // defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
 }
 
 
-std::size_t
-lookup_special_alignments(std::size_t a) noexcept;
 
 bool
 inline provides_dynamic_alignment(std::size_t alignmentProvided, std::size_t alignmentRequested) noexcept
@@ -161,20 +210,53 @@ set_out_of_bounds_write_trap(void* data, std::size_t size, std::size_t allocSize
 [[nodiscard]] bool
 check_out_of_bounds_write_trap(void const* data, std::size_t size, std::size_t allocSize) noexcept;
 
+    // Must be freed with `aligned_free()` with the same size and alignment.
 void*
 aligned_alloc(std::size_t size, std::size_t alignment);
 void
 aligned_free(void* data, std::size_t size, std::size_t alignment) noexcept;
 
+    // Returns a range aligned to the large page size. Must be freed with `large_page_free()`.
+void*
+large_page_alloc(std::size_t size, page_flags flags = page_flags{ });
+    // Allocates from the hugetlb page pool for the given page size, or falls back to `large_page_alloc()` if the pool is
+    // exhausted. Must be freed with `large_page_free()`.
 void*
-large_page_alloc(std::size_t size);
+huge_page_alloc(std::size_t size, std::size_t pageSize, page_flags flags);
+    // The flags passed to `large_page_free()` and `page_free()` must match the flags the allocation was made with.
 void
-large_page_free(void* data, std::size_t size) noexcept;
+large_page_free(void* data, std::size_t size, page_flags flags = page_flags{ }) noexcept;
 
 void*
-page_alloc(std::size_t size);
+page_alloc(std::size_t size, page_flags flags = page_flags{ });
 void
-page_free(void* data, std::size_t size) noexcept;
+page_free(void* data, std::size_t size, page_flags flags = page_flags{ }) noexcept;
+
+    // Resize allocations made by `large_page_alloc()`, `huge_page_alloc()`, or `page_alloc()` and preserve their contents as if
+    // by `memcpy()`. On Linux, the pages are remapped with `mremap()` rather than copied (except for hugetlb allocations). The
+    // original allocation remains valid if an exception is thrown.
+void*
+large_page_realloc(void* data, std::size_t oldSize, std::size_t newSize, page_flags flags = page_flags{ });
+void*
+page_realloc(void* data, std::size_t oldSize, std::size_t newSize, page_flags flags = page_flags{ });
+
+    // Allocates pages like `page_alloc()` and sets the given NUMA memory policy for them. A node mask of 0 refers to all nodes
+    // for `bind` and `interleave` and to the local node for `preferred`. The page cache is bypassed because cached pages may
+    // reside on any node. Must be freed with `numa_free()`.
+void*
+numa_alloc(std::size_t size, numa_policy policy, std::uint64_t nodeMask);
+void
+numa_free(void* data, std::size_t size) noexcept;
+
+    // Allocates pages like `page_alloc()` which are preferably placed on the given NUMA node. Must be freed with `numa_free()`.
+void*
+numa_page_alloc(std::size_t size, int numaNode);
+
+
+    // Allocators may provide a member function `reallocate(ptr, oldN, newN)` which resizes an allocation and preserves its
+    // contents bytewise.
+template <typename A>
+using allocator_reallocate_r = decltype(std::declval<A&>().reallocate(std::declval<typename std::allocator_traits<A>::pointer>(), std::size_t{ }, std::size_t{ }));
 
 
 template <typename T, std::size_t Alignment, typename A, bool NeedAlignment>
@@ -185,6 +267,12 @@ class aligned_allocator_adaptor_base<T, Alignment, A, true> : public A
 public:
     using A::A;
 
+    aligned_allocator_adaptor_base() = default;
+    aligned_allocator_adaptor_base(A const& _alloc) noexcept
+        : A(_alloc)
+    {
+    }
+
     [[nodiscard]] bool
     static constexpr provides_static_alignment(std::size_t a) noexcept
     {
@@ -240,6 +328,12 @@ class aligned_allocator_adaptor_base<T, Alignment, A, false> : public A
 {
 public:
     using A::A;
+
+    aligned_allocator_adaptor_base() = default;
+    aligned_allocator_adaptor_base(A const& _alloc) noexcept
+        : A(_alloc)
+    {
+    }
 };
 
 
@@ -0,0 +1,28 @@
+
+#ifndef INCLUDED_PATTON_DETAIL_NEW_HPP_
+#define INCLUDED_PATTON_DETAIL_NEW_HPP_
+
+
+#include <cstddef>  // for size_t
+
+
+namespace patton::detail {
+
+
+    // Query the operating system for the respective values. The results are not cached.
+[[nodiscard]] std::size_t
+query_hardware_large_page_size();
+[[nodiscard]] std::size_t
+query_hardware_page_size();
+[[nodiscard]] std::size_t
+query_hardware_cache_line_size();
+
+    // Terminates the process if any of the hardware constants given at compile time disagrees with the runtime value.
+void
+check_hardware_constants() noexcept;
+
+
+} // namespace patton::detail
+
+
+#endif // INCLUDED_PATTON_DETAIL_NEW_HPP_
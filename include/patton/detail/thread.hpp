@@ -0,0 +1,23 @@
+
+#ifndef INCLUDED_PATTON_DETAIL_THREAD_HPP_
+#define INCLUDED_PATTON_DETAIL_THREAD_HPP_
+
+
+#include <vector>
+
+#include <patton/thread.hpp>  // for affinity_domain
+
+
+namespace patton::detail {
+
+
+    // Returns the ids of all hardware threads which share the given affinity domain with the hardware thread `hardwareThreadId`.
+    // Returns `{ hardwareThreadId }` if the members of the domain cannot be determined.
+[[nodiscard]] std::vector<int>
+affinity_domain_members(int hardwareThreadId, affinity_domain domain);
+
+
+} // namespace patton::detail
+
+
+#endif // INCLUDED_PATTON_DETAIL_THREAD_HPP_
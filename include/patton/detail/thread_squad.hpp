@@ -5,10 +5,18 @@
 
 #include <new>
 #include <memory>       // for unique_ptr<>
+#include <cstddef>      // for size_t, byte
+#include <utility>      // for pair<>
+#include <algorithm>    // for min()
 #include <optional>
 #include <concepts>
 #include <type_traits>  // for invoke_result<>
 
+#include <patton/new.hpp>     // for max_hardware_destructive_interference_size, hardware_page_size()
+#include <patton/memory.hpp>  // for numa_policy
+
+#include <patton/detail/memory.hpp>  // for numa_alloc(), numa_free()
+
 
 namespace patton::detail {
 
@@ -16,6 +24,18 @@ namespace patton::detail {
 template <typename F, typename T>
 concept reduction = std::invocable<F, T, T> && std::same_as<std::invoke_result_t<F, T, T>, T>;
 
+constexpr std::pair<std::size_t, std::size_t>
+static_partition(std::size_t size, int threadIdx, int numThreads) noexcept
+{
+    std::size_t n = static_cast<std::size_t>(numThreads);
+    std::size_t i = static_cast<std::size_t>(threadIdx);
+    std::size_t quot = size / n;
+    std::size_t rem = size % n;
+    std::size_t first = i*quot + std::min(i, rem);
+    return { first, first + quot + (i < rem ? 1 : 0) };
+}
+
+
 struct thread_squad_impl_base
 {
     int numThreads;
@@ -64,7 +84,7 @@ public:
 # pragma warning(disable: 4324)  // structure was padded due to alignment specifier
 #endif // _MSC_VER
 template <typename TaskContextT, typename ActionT>
-class alignas(std::hardware_destructive_interference_size) thread_squad_action : public thread_squad_task
+class alignas(max_hardware_destructive_interference_size) thread_squad_action : public thread_squad_task
 {
 private:
     ActionT action_;
@@ -86,21 +106,93 @@ public:
 };
 
 template <typename T>
-struct alignas(std::hardware_destructive_interference_size) thread_reduce_data
+struct alignas(max_hardware_destructive_interference_size) thread_reduce_data
 {
     std::optional<T> value;
 };
 
+    // Storage for the per-thread results of a reduction. Every slot is constructed by the thread which computes its value.
+    // Large slots are padded to whole pages, so every one of them is first-touched on the NUMA node of its thread. The pages
+    // are obtained with `numa_alloc()`, which bypasses the page cache because cached pages have been placed already.
+    // The slots are destroyed only if `mark_constructed()` was called after all of them have been constructed.
+template <typename T>
+class thread_reduce_buffer
+{
+private:
+    std::byte* data_;
+    std::size_t size_;
+    std::size_t stride_;
+    bool pageAllocated_;
+    bool constructed_ = false;
+
+public:
+    explicit thread_reduce_buffer(int _size)
+        : size_(std::size_t(_size))
+    {
+            // Fresh pages are only worth the system call overhead and the padding if a slot spans a significant part of a page.
+        std::size_t pageSize = hardware_page_size();
+        pageAllocated_ = sizeof(thread_reduce_data<T>) >= pageSize/4;
+        stride_ = pageAllocated_
+            ? (sizeof(thread_reduce_data<T>) + pageSize - 1)/pageSize*pageSize
+            : sizeof(thread_reduce_data<T>);
+        std::size_t nbData = size_*stride_;
+        data_ = static_cast<std::byte*>(pageAllocated_
+            ? detail::numa_alloc(nbData, numa_policy::preferred, 0)
+            : ::operator new(nbData, std::align_val_t(alignof(thread_reduce_data<T>))));
+    }
+    ~thread_reduce_buffer()
+    {
+        if (constructed_)
+        {
+            for (std::size_t i = 0; i != size_; ++i)
+            {
+                (*this)[i].~thread_reduce_data<T>();
+            }
+        }
+        std::size_t nbData = size_*stride_;
+        if (pageAllocated_)
+        {
+            detail::numa_free(data_, nbData);
+        }
+        else
+        {
+            ::operator delete(data_, nbData, std::align_val_t(alignof(thread_reduce_data<T>)));
+        }
+    }
+
+    thread_reduce_buffer(thread_reduce_buffer const&) = delete;
+    thread_reduce_buffer&
+    operator =(thread_reduce_buffer const&) = delete;
+
+        // Returns the raw memory of slot `i`.
+    void*
+    slot(std::size_t i) const noexcept
+    {
+        return data_ + i*stride_;
+    }
+    thread_reduce_data<T>&
+    operator [](std::size_t i) const noexcept
+    {
+        return *std::launder(static_cast<thread_reduce_data<T>*>(slot(i)));
+    }
+
+    void
+    mark_constructed() noexcept
+    {
+        constructed_ = true;
+    }
+};
+
 template <typename TaskContextT, typename TransformFuncT, typename T, typename ReduceOpT>
-class alignas(std::hardware_destructive_interference_size) thread_squad_transform_reduce_operation : public thread_squad_task
+class alignas(max_hardware_destructive_interference_size) thread_squad_transform_reduce_operation : public thread_squad_task
 {
 private:
     TransformFuncT transform_;
     ReduceOpT reduce_;
-    thread_reduce_data<T>* subthreadData_;
+    thread_reduce_buffer<T>& subthreadData_;
 
 public:
-    thread_squad_transform_reduce_operation(TransformFuncT&& _transform, ReduceOpT&& _reduce, thread_reduce_data<T>* _subthreadData)
+    thread_squad_transform_reduce_operation(TransformFuncT&& _transform, ReduceOpT&& _reduce, thread_reduce_buffer<T>& _subthreadData)
         : transform_(std::move(_transform)), reduce_(std::move(_reduce)), subthreadData_(_subthreadData)
     {
     }
@@ -117,15 +209,17 @@ public:
     {
         auto ltransform = transform_;
         auto ctx = task_context_factory::template make_task_context<TaskContextT>(impl, i, numRunningThreads);
-        gsl_Assert(!subthreadData_[i].value.has_value());
-        subthreadData_[i].value = ltransform(ctx);
+            // The slot is raw memory until here; constructing it on this thread places it on this thread's NUMA node.
+        ::new(subthreadData_.slot(std::size_t(i))) thread_reduce_data<T>{ .value = ltransform(ctx) };
     }
     void
     merge(int iDst, int iSrc) noexcept override
     {
         auto lreduce = reduce_;
-        subthreadData_[iDst].value = lreduce(std::move(subthreadData_[iDst].value.value()), std::move(subthreadData_[iSrc].value.value()));
-        subthreadData_[iSrc].value.reset();
+        auto& dst = subthreadData_[std::size_t(iDst)];
+        auto& src = subthreadData_[std::size_t(iSrc)];
+        dst.value = lreduce(std::move(dst.value.value()), std::move(src.value.value()));
+        src.value.reset();
     }
 };
 
@@ -141,20 +235,20 @@ public:
 };
 
 template <typename T>
-struct alignas(std::hardware_destructive_interference_size) thread_sync_reduce_data
+struct alignas(max_hardware_destructive_interference_size) thread_sync_reduce_data
 {
     T value;
 };
 
 template <typename T, typename R>
-struct alignas(std::hardware_destructive_interference_size) thread_sync_reduce_transform_data
+struct alignas(max_hardware_destructive_interference_size) thread_sync_reduce_transform_data
 {
     T value;
     R result;
 };
 
 template <typename T, typename ReduceOpT>
-struct alignas(std::hardware_destructive_interference_size) task_context_reduce_synchronizer : task_context_synchronizer
+struct alignas(max_hardware_destructive_interference_size) task_context_reduce_synchronizer : task_context_synchronizer
 {
     thread_sync_reduce_data<T> data;
     ReduceOpT& reduce;
@@ -184,7 +278,7 @@ struct alignas(std::hardware_destructive_interference_size) task_context_reduce_
     }
 };
 template <typename T, typename ReduceOpT, typename R>
-struct alignas(std::hardware_destructive_interference_size) task_context_reduce_transform_synchronizer : task_context_synchronizer
+struct alignas(max_hardware_destructive_interference_size) task_context_reduce_transform_synchronizer : task_context_synchronizer
 {
     thread_sync_reduce_transform_data<T, R> data;
     ReduceOpT& reduce;
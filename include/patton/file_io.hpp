@@ -0,0 +1,284 @@
+
+#ifndef INCLUDED_PATTON_FILE_IO_HPP_
+#define INCLUDED_PATTON_FILE_IO_HPP_
+
+
+#include <new>           // for bad_alloc
+#include <span>
+#include <limits>
+#include <cstdint>       // for uint64_t, intptr_t
+#include <cstddef>       // for size_t, byte
+#include <utility>       // for move(), exchange()
+#include <filesystem>    // for path
+#include <type_traits>   // for is_trivially_copyable<>
+#include <system_error>  // for errc
+
+#include <patton/buffer.hpp>         // for aligned_buffer<>, aligned_row_buffer<>
+#include <patton/memory.hpp>         // for default_init_allocator<>, page_allocator<>, aligned_allocator_traits<>, page_alignment
+#include <patton/thread_squad.hpp>
+#include <patton/mapped_buffer.hpp>  // for file_mapping, mapped_row_buffer<>, map_advice
+
+#include <patton/detail/memory.hpp>      // for alignment_in_bytes()
+
+
+namespace patton {
+
+
+    //
+    // A file opened for reading with direct I/O, which transfers data between the storage device and user memory without going
+    // through the file system cache.
+    //ᅟ
+    // Direct I/O is requested with `O_DIRECT` on Linux, `F_NOCACHE` on MacOS, and `FILE_FLAG_NO_BUFFERING` on Windows. If the
+    // file system does not support direct I/O, the file is read through the file system cache instead, cf. `is_direct()`.
+    //
+class direct_input_file
+{
+public:
+    struct params
+    {
+            //
+            // The size of the extents in which the file is read. A value of 0 indicates the default extent size of 8 MiB. Will be
+            // rounded up to a multiple of the page size.
+            //
+        std::size_t extent_size = 0;
+    };
+
+private:
+    std::intptr_t handle_;          // file descriptor on POSIX, `HANDLE` on Windows
+    std::intptr_t bufferedHandle_;  // for reading unaligned tails if `handle_` uses direct I/O
+    std::uint64_t size_;
+    std::size_t extentSize_;
+    bool direct_;
+
+    void
+    close() noexcept;
+
+public:
+        //
+        // Opens the given file for reading.
+        //
+    explicit direct_input_file(std::filesystem::path const& _path)
+        : direct_input_file(_path, params{ })
+    {
+    }
+    explicit direct_input_file(std::filesystem::path const& _path, params const& _params);
+
+    direct_input_file(direct_input_file&& rhs) noexcept
+        : handle_(std::exchange(rhs.handle_, -1)),
+          bufferedHandle_(std::exchange(rhs.bufferedHandle_, -1)),
+          size_(std::exchange(rhs.size_, 0)),
+          extentSize_(rhs.extentSize_),
+          direct_(rhs.direct_)
+    {
+    }
+    direct_input_file&
+    operator =(direct_input_file&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            close();
+            handle_ = std::exchange(rhs.handle_, -1);
+            bufferedHandle_ = std::exchange(rhs.bufferedHandle_, -1);
+            size_ = std::exchange(rhs.size_, 0);
+            extentSize_ = rhs.extentSize_;
+            direct_ = rhs.direct_;
+        }
+        return *this;
+    }
+
+    ~direct_input_file()
+    {
+        close();
+    }
+
+        //
+        // The size of the file in bytes.
+        //
+    [[nodiscard]] std::uint64_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+        //
+        // Whether the file is read with direct I/O.
+        //
+    [[nodiscard]] bool
+    is_direct() const noexcept
+    {
+        return direct_;
+    }
+
+    [[nodiscard]] std::size_t
+    extent_size() const noexcept
+    {
+        return extentSize_;
+    }
+
+        //
+        // Reads `dest.size()` bytes starting at byte offset `offset` into `dest`, using all threads of the squad.
+        //ᅟ
+        // The byte range is split into extents, and every thread reads a contiguous range of extents with positional reads. If
+        // the pages of `dest` have not been touched yet, every page is thus first touched by the thread which reads it, and with a
+        // first-touch placement policy it is placed on that thread's NUMA node. `dest` must be page-aligned, `offset` must be a
+        // multiple of the page size, and the byte range must not extend past the end of the file. Throws `std::system_error`
+        // if reading fails.
+        //
+    void
+    read(thread_squad& squad, std::span<std::byte> dest, std::uint64_t offset = 0) const;
+};
+
+
+    //
+    // Reads the contents of a file into a buffer of elements of type `T`, using direct I/O and all threads of the squad.
+    //ᅟ
+    //ᅟ    auto squad = thread_squad({ .pin_to_hardware_threads = true });
+    //ᅟ    auto samples = read_file<float>(squad, "samples.bin");
+    //ᅟ
+    // The file must hold a sequence of elements of the trivially copyable type `T`. The buffer is allocated with the given
+    // allocator, which must return page-aligned allocations, and is filled with `direct_input_file::read()`. The default
+    // allocator does not touch the memory when constructing the elements, so every page of the buffer is placed on the NUMA
+    // node of the thread which reads it. (Freed allocations retained by `page_allocator<>` for reuse may have been placed
+    // already, cf. `set_page_cache_capacity()`.)
+    //
+template <typename T, typename A = default_init_allocator<T, page_allocator<T>>>
+[[nodiscard]] aligned_buffer<T, alignof(T), A>
+read_file(thread_squad& squad, std::filesystem::path const& path, A alloc = A{ }, direct_input_file::params const& params = { })
+{
+    static_assert(std::is_trivially_copyable<T>::value, "element type must be trivially copyable");
+    static_assert(aligned_allocator_traits<A>::provides_static_alignment(page_alignment), "allocator must return page-aligned allocations");
+
+    auto file = direct_input_file(path, params);
+    if (file.size() % sizeof(T) != 0)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "file size is not a multiple of the element size");
+    }
+    if (file.size() / sizeof(T) > std::uint64_t(std::numeric_limits<std::size_t>::max()))
+    {
+        throw std::bad_alloc{ };
+    }
+    auto result = aligned_buffer<T, alignof(T), A>(std::size_t(file.size() / sizeof(T)), std::move(alloc));
+    if (!result.empty())
+    {
+            // The elements are contiguous because the buffer uses the natural alignment of `T`.
+        file.read(squad, std::as_writable_bytes(std::span<T>(&result.front(), result.size())));
+    }
+    return result;
+}
+
+
+    //
+    // Header of a row buffer snapshot file, cf. `write_snapshot()`.
+    //ᅟ
+    // A snapshot file consists of the header, followed by padding up to byte offset `data_offset`, followed by `rows` rows of
+    // `row_stride` bytes each, exactly as they are laid out in memory by `aligned_row_buffer<>`. Every row holds `columns`
+    // elements of `element_size` bytes, followed by unspecified padding bytes. All header fields are stored in the byte order
+    // of the writing machine; `byte_order_mark` holds the value `0x01020304` in that byte order.
+    //
+struct row_buffer_snapshot_header
+{
+    char magic[8];                    // "PATTONRB"
+    std::uint32_t byte_order_mark;
+    std::uint32_t version;            // 1
+    std::uint64_t element_size;       // `sizeof(T)`
+    std::uint64_t element_alignment;  // `alignof(T)`
+    std::uint64_t alignment;          // row alignment in bytes
+    std::uint64_t rows;
+    std::uint64_t columns;
+    std::uint64_t row_stride;         // in bytes
+    std::uint64_t data_offset;        // in bytes; a multiple of 64 KiB and of `alignment`
+};
+
+
+namespace detail {
+
+
+void
+write_row_snapshot(thread_squad& squad, std::filesystem::path const& path, row_buffer_snapshot_header const& header,
+    std::byte const* data);
+
+
+} // namespace detail
+
+
+    //
+    // Reads and validates the header of a row buffer snapshot file. Throws `std::system_error` if the file is not a snapshot
+    // which was written on a machine with the same byte order.
+    //
+[[nodiscard]] row_buffer_snapshot_header
+read_snapshot_header(std::filesystem::path const& path);
+
+
+    //
+    // Writes a snapshot of the given row buffer to a file, using all threads of the squad.
+    //ᅟ
+    //ᅟ    write_snapshot(squad, "matrix.snapshot", matrix);
+    //ᅟ    // ... after restart:
+    //ᅟ    auto matrix = map_snapshot<double, cache_line_alignment>("matrix.snapshot");
+    //ᅟ
+    // The element type must be trivially copyable. Every thread writes the rows it is assigned by
+    // `thread_squad::task_context::partition(rows)`. The file is flushed to the storage device before the function returns.
+    // Throws `std::system_error` if writing fails.
+    //
+template <typename T, std::size_t Alignment, typename A>
+void
+write_snapshot(thread_squad& squad, std::filesystem::path const& path, aligned_row_buffer<T, Alignment, A> const& buf)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "element type must be trivially copyable");
+
+    std::size_t alignment = detail::alignment_in_bytes(Alignment | alignof(T));
+    auto header = row_buffer_snapshot_header{
+        .magic = { 'P', 'A', 'T', 'T', 'O', 'N', 'R', 'B' },
+        .byte_order_mark = 0x01020304,
+        .version = 1,
+        .element_size = sizeof(T),
+        .element_alignment = alignof(T),
+        .alignment = alignment,
+        .rows = buf.rows(),
+        .columns = buf.columns(),
+        .row_stride = buf.row_stride(),
+        .data_offset = 0  // determined by `write_row_snapshot()`
+    };
+    auto data = !buf.empty() && buf.columns() != 0 ? reinterpret_cast<std::byte const*>(buf.front().data()) : nullptr;
+    detail::write_row_snapshot(squad, path, header, data);
+}
+
+
+    //
+    // Maps a row buffer snapshot file into memory as a read-only row buffer, without copying.
+    //ᅟ
+    // The element type and the alignment must match those of the snapshot, which is verified by comparing the element size
+    // and the element alignment, and by checking that the rows of the snapshot are at least as strictly aligned as required;
+    // the alignment of cache-line-aligned or page-aligned rows can differ between machines. The row stride is taken from the
+    // snapshot, so snapshots of row buffers with `row_stride_policy::anti_aliased` retain their layout. Throws
+    // `std::system_error` if the snapshot does not match.
+    //
+template <typename T, std::size_t Alignment>
+[[nodiscard]] mapped_row_buffer<T const, Alignment>
+map_snapshot(std::filesystem::path const& path, map_advice advice = map_advice::none)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "element type must be trivially copyable");
+
+    auto header = patton::read_snapshot_header(path);
+    if (header.element_size != sizeof(T) || header.element_alignment != alignof(T) || header.columns > std::numeric_limits<std::size_t>::max()
+        || header.row_stride > std::numeric_limits<std::size_t>::max() || header.alignment % detail::alignment_in_bytes(Alignment | alignof(T)) != 0)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "snapshot layout does not match the row buffer type");
+    }
+    if (header.data_offset > std::numeric_limits<std::size_t>::max() || header.data_offset % file_mapping::offset_granularity() != 0)
+    {
+        throw std::system_error(std::make_error_code(std::errc::not_supported), "snapshot data cannot be mapped on this machine");
+    }
+    auto result = mapped_row_buffer<T const, Alignment>(file_mapping(path, std::size_t(header.data_offset), file_access::read_only, advice), std::size_t(header.columns), std::size_t(header.row_stride));
+    if (header.row_stride != 0 && result.rows() != header.rows)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "snapshot file is truncated");
+    }
+    return result;
+}
+
+
+} // namespace patton
+
+
+#endif // INCLUDED_PATTON_FILE_IO_HPP_
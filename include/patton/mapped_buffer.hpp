@@ -0,0 +1,763 @@
+
+#ifndef INCLUDED_PATTON_MAPPED_BUFFER_HPP_
+#define INCLUDED_PATTON_MAPPED_BUFFER_HPP_
+
+
+#include <new>           // for bad_alloc
+#include <span>
+#include <cstddef>       // for size_t, ptrdiff_t, byte
+#include <utility>       // for move(), exchange()
+#include <filesystem>    // for path
+#include <type_traits>   // for is_const<>, is_volatile<>, is_reference<>, is_trivially_copyable<>, remove_const<>
+#include <system_error>  // for errc
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects()
+
+#include <patton/detail/buffer.hpp>
+#include <patton/detail/memory.hpp>      // for alignment_in_bytes()
+#include <patton/detail/arithmetic.hpp>  // for try_multiply_unsigned(), try_ceili()
+
+
+namespace patton {
+
+
+namespace gsl = ::gsl_lite;
+
+
+    //
+    // How a file is mapped into memory.
+    //
+enum class file_access
+{
+        //
+        // The mapping can only be read.
+        //
+    read_only,
+
+        //
+        // The mapping can be read and written, but modifications are private to the mapping and are not written back to the file
+        // (`MAP_PRIVATE` on POSIX, `FILE_MAP_COPY` on Windows). Pages are copied when they are first written to.
+        //
+    copy_on_write,
+
+        //
+        // The mapping can be read and written, and modifications are written back to the file. The file must be writable.
+        //
+    shared
+};
+
+
+    //
+    // Access pattern hints for mapped files. Hints can be combined with `|`. They do not affect the semantics of the mapping,
+    // and hints not supported by the operating system are ignored.
+    //
+enum class map_advice : unsigned
+{
+    none = 0,
+
+        //
+        // The mapping will be read sequentially, so the operating system may read ahead aggressively and drop pages soon after
+        // they were accessed (`MADV_SEQUENTIAL` on POSIX, `FILE_FLAG_SEQUENTIAL_SCAN` on Windows).
+        //
+    sequential = 1,
+
+        //
+        // The mapping will be accessed in random order, so read-ahead is not useful (`MADV_RANDOM` on POSIX,
+        // `FILE_FLAG_RANDOM_ACCESS` on Windows).
+        //
+    random = 2,
+
+        //
+        // The entire mapping will be accessed soon, so the operating system should start reading it in the background
+        // (`MADV_WILLNEED` on POSIX, `PrefetchVirtualMemory()` on Windows).
+        //
+    willneed = 4,
+
+        //
+        // On Linux, align the mapping to the large page size and ask the kernel to back it with transparent huge pages
+        // (`MADV_HUGEPAGE`). Whether file-backed memory can be mapped with huge pages depends on the file system and the kernel
+        // configuration; the offset into the file should be a multiple of the large page size.
+        //
+    hugepage = 8
+};
+
+[[nodiscard]] constexpr map_advice
+operator |(map_advice lhs, map_advice rhs) noexcept
+{
+    return map_advice(unsigned(lhs) | unsigned(rhs));
+}
+[[nodiscard]] constexpr map_advice
+operator &(map_advice lhs, map_advice rhs) noexcept
+{
+    return map_advice(unsigned(lhs) & unsigned(rhs));
+}
+
+
+    //
+    // A file, or the tail of a file, mapped into memory.
+    //ᅟ
+    // Pages are read from the file lazily when they are first accessed, and read-only mappings share the pages of the file
+    // system cache, so mapping a file does not copy its contents. The mapping is page-aligned, or large-page-aligned if the
+    // `hugepage` hint is given on Linux. The file may be closed or deleted while the mapping is alive.
+    //
+class file_mapping
+{
+    friend class shared_memory;
+
+private:
+    void* data_;
+    std::size_t size_;
+    std::size_t mapSize_;
+    file_access access_;
+
+    file_mapping(void* _data, std::size_t _size, std::size_t _mapSize, file_access _access) noexcept
+        : data_(_data), size_(_size), mapSize_(_mapSize), access_(_access)
+    {
+    }
+
+public:
+    constexpr file_mapping() noexcept
+        : data_(nullptr), size_(0), mapSize_(0), access_(file_access::read_only)
+    {
+    }
+
+        //
+        // Maps the given file.
+        //
+    explicit file_mapping(std::filesystem::path const& _path, file_access _access = file_access::read_only, map_advice _advice = map_advice::none)
+        : file_mapping(_path, 0, _access, _advice)
+    {
+    }
+
+        //
+        // Maps the given file starting at byte offset `_offset`, which must be a multiple of `file_mapping::offset_granularity()`.
+        //
+    explicit file_mapping(std::filesystem::path const& _path, std::size_t _offset, file_access _access = file_access::read_only, map_advice _advice = map_advice::none);
+
+    file_mapping(file_mapping&& rhs) noexcept
+        : data_(std::exchange(rhs.data_, nullptr)),
+          size_(std::exchange(rhs.size_, 0)),
+          mapSize_(std::exchange(rhs.mapSize_, 0)),
+          access_(rhs.access_)
+    {
+    }
+    file_mapping&
+    operator =(file_mapping&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            reset();
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            mapSize_ = std::exchange(rhs.mapSize_, 0);
+            access_ = rhs.access_;
+        }
+        return *this;
+    }
+
+    ~file_mapping()
+    {
+        reset();
+    }
+
+        //
+        // Unmaps the file. For `shared` mappings, modifications are written back to the file eventually.
+        //
+    void
+    reset() noexcept;
+
+        //
+        // The granularity of file offsets which can be mapped: the page size on POSIX systems, and the allocation granularity on
+        // Windows.
+        //
+    [[nodiscard]] static std::size_t
+    offset_granularity() noexcept;
+
+    [[nodiscard]] void*
+    data() const noexcept
+    {
+        return data_;
+    }
+
+        //
+        // The size of the mapped part of the file in bytes.
+        //
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] file_access
+    access() const noexcept
+    {
+        return access_;
+    }
+
+    [[nodiscard]] std::span<std::byte>
+    bytes() const noexcept
+    {
+        return { static_cast<std::byte*>(data_), size_ };
+    }
+
+        //
+        // Gives additional access pattern hints for the mapping.
+        //
+    void
+    advise(map_advice advice) const noexcept;
+
+        //
+        // Synchronously writes modifications of a `shared` mapping back to the file.
+        //
+    void
+    flush() const;
+};
+
+
+    //
+    // Anonymous shared memory which can be passed between processes by handle.
+    //ᅟ
+    //ᅟ    auto mem = shared_memory(mapped_row_buffer<float, cache_line_alignment>::required_size(rows, cols));
+    //ᅟ    auto matrix = mapped_row_buffer<float, cache_line_alignment>(mem.map(), cols);
+    //ᅟ    // ... pass `mem.native_handle()` to another process, e.g. with `SCM_RIGHTS` or by inheritance
+    //ᅟ    // in the other process:
+    //ᅟ    auto mem = shared_memory::from_native_handle(handle);
+    //ᅟ    auto matrix = mapped_row_buffer<float const, cache_line_alignment>(mem.map(file_access::read_only), cols);
+    //ᅟ
+    // The memory is created with `memfd_create()` on Linux, with `shm_open()` on other POSIX systems, and as a pagefile-backed
+    // file mapping object on Windows, and it is zero-initialized. It is released when the last handle to it is closed and the
+    // last mapping is unmapped. Because the layout of a mapped buffer depends only on its element type and alignment, and every
+    // mapping is aligned to at least the page size, buffers mapped from the same shared memory have identical layout in all
+    // processes. On Linux, shared memory can be mapped with transparent huge pages by passing `map_advice::hugepage` to `map()`,
+    // or be backed by explicit huge pages.
+    //
+class shared_memory
+{
+public:
+#if defined(_WIN32)
+    using native_handle_type = void*;  // `HANDLE` of a file mapping object
+    static constexpr native_handle_type invalid_handle = nullptr;
+#else // assume POSIX
+    using native_handle_type = int;    // file descriptor
+    static constexpr native_handle_type invalid_handle = -1;
+#endif
+
+private:
+    native_handle_type handle_;
+    std::size_t size_;
+
+    shared_memory(native_handle_type _handle, std::size_t _size) noexcept
+        : handle_(_handle), size_(_size)
+    {
+    }
+
+    void
+    close() noexcept;
+
+public:
+    constexpr shared_memory() noexcept
+        : handle_(invalid_handle), size_(0)
+    {
+    }
+
+        //
+        // Creates shared memory of the given non-zero size.
+        //
+    explicit shared_memory(std::size_t _size);
+
+        //
+        // Creates shared memory backed by explicit huge pages of the given size, cf. the corresponding constructor of
+        // `large_page_allocator<>`. The size is rounded up to a multiple of the page size. On Windows, only the large page size
+        // is supported. Throws `std::system_error` if explicit huge pages are not supported.
+        //
+    explicit shared_memory(std::size_t _size, std::size_t _pageSize);
+
+        //
+        // Takes ownership of the given handle to shared memory, e.g. one received from another process. On Windows, the size
+        // is determined from a view of the memory and hence is rounded up to a multiple of the page size.
+        //
+    [[nodiscard]] static shared_memory
+    from_native_handle(native_handle_type handle);
+
+    shared_memory(shared_memory&& rhs) noexcept
+        : handle_(std::exchange(rhs.handle_, invalid_handle)), size_(std::exchange(rhs.size_, 0))
+    {
+    }
+    shared_memory&
+    operator =(shared_memory&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            close();
+            handle_ = std::exchange(rhs.handle_, invalid_handle);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    ~shared_memory()
+    {
+        close();
+    }
+
+    [[nodiscard]] native_handle_type
+    native_handle() const noexcept
+    {
+        return handle_;
+    }
+
+        //
+        // Relinquishes ownership of the handle and returns it.
+        //
+    [[nodiscard]] native_handle_type
+    release() noexcept
+    {
+        size_ = 0;
+        return std::exchange(handle_, invalid_handle);
+    }
+
+        //
+        // The size of the shared memory in bytes.
+        //
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+
+        //
+        // Maps the shared memory. The mapping remains valid after the `shared_memory` object is destroyed.
+        //
+    [[nodiscard]] file_mapping
+    map(file_access access = file_access::shared, map_advice advice = map_advice::none) const;
+};
+
+
+    //
+    // Buffer with aligned elements which are mapped from a file.
+    //ᅟ
+    //ᅟ    auto samples = mapped_buffer<float const, cache_line_alignment>("samples.bin", map_advice::sequential);
+    //ᅟ    // file is paged in lazily when `samples` is accessed
+    //ᅟ
+    // The file holds the elements as they are laid out in memory by `aligned_buffer<T, Alignment>`, i.e. every element is padded
+    // to the given alignment. The element type must be trivially copyable. If `T` is const-qualified, the file is mapped
+    // read-only; otherwise it is mapped with `copy_on_write` access unless specified otherwise. The size of the mapped part of
+    // the file must be a multiple of the padded element size.
+    //
+template <typename T, std::size_t Alignment>
+class mapped_buffer
+{
+    static_assert(!std::is_volatile<T>::value, "buffer element type must not be volatile");
+    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
+    static_assert(std::is_trivially_copyable<T>::value, "mapped buffer element type must be trivially copyable");
+
+private:
+    file_mapping mapping_;
+    std::size_t size_; // # elements
+    std::size_t bytesPerElement_;
+
+    std::size_t
+    static computeBytesPerElement()
+    {
+        auto bytesPerElementR = detail::try_ceili(sizeof(T), detail::alignment_in_bytes(Alignment | alignof(T)));
+        if (bytesPerElementR.ec != std::errc{ }) throw std::bad_alloc{ };
+        return bytesPerElementR.value;
+    }
+
+    char*
+    data() const noexcept
+    {
+        return static_cast<char*>(mapping_.data());
+    }
+
+public:
+    using value_type = std::remove_const_t<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using reference = T&;
+    using const_reference = T const&;
+
+    using iterator = detail::aligned_buffer_iterator<T>;
+    using const_iterator = detail::aligned_buffer_iterator<T const>;
+
+    static constexpr file_access default_access = std::is_const<T>::value ? file_access::read_only : file_access::copy_on_write;
+
+    mapped_buffer() noexcept
+        : size_(0), bytesPerElement_(0)
+    {
+    }
+
+        //
+        // Maps the elements in the given file mapping. Mutable element types cannot be used with `read_only` mappings.
+        //
+    explicit mapped_buffer(file_mapping _mapping)
+        : mapping_(std::move(_mapping)), bytesPerElement_(computeBytesPerElement())
+    {
+        gsl_Expects(std::is_const<T>::value || mapping_.access() != file_access::read_only);
+        gsl_Expects(bytesPerElement_ <= file_mapping::offset_granularity());
+
+        if (mapping_.size() % bytesPerElement_ != 0)
+        {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "file size is not a multiple of the element size");
+        }
+        size_ = mapping_.size() / bytesPerElement_;
+    }
+    explicit mapped_buffer(std::filesystem::path const& _path, map_advice _advice = map_advice::none)
+        : mapped_buffer(file_mapping(_path, default_access, _advice))
+    {
+    }
+    explicit mapped_buffer(std::filesystem::path const& _path, file_access _access, map_advice _advice = map_advice::none)
+        : mapped_buffer(file_mapping(_path, _access, _advice))
+    {
+    }
+
+    mapped_buffer(mapped_buffer&& rhs) noexcept
+        : mapping_(std::move(rhs.mapping_)),
+          size_(std::exchange(rhs.size_, { })),
+          bytesPerElement_(rhs.bytesPerElement_)
+    {
+    }
+    mapped_buffer&
+    operator =(mapped_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            mapping_ = std::move(rhs.mapping_);
+            size_ = std::exchange(rhs.size_, { });
+            bytesPerElement_ = rhs.bytesPerElement_;
+        }
+        return *this;
+    }
+
+        //
+        // The number of bytes needed to hold `n` elements.
+        //
+    [[nodiscard]] static std::size_t
+    required_size(std::size_t n)
+    {
+        auto numBytesR = detail::try_multiply_unsigned(n, computeBytesPerElement());
+        if (numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
+        return numBytesR.value;
+    }
+
+        //
+        // The underlying file mapping, e.g. for giving additional hints with `advise()` or for flushing modifications.
+        //
+    [[nodiscard]] file_mapping const&
+    mapping() const noexcept
+    {
+        return mapping_;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return size_;
+    }
+    [[nodiscard]] reference
+    operator [](std::size_t i)
+    {
+        gsl_Expects(i < size_);
+
+        return *reinterpret_cast<pointer>(&data()[i * bytesPerElement_]);
+    }
+    [[nodiscard]] const_reference
+    operator [](std::size_t i) const
+    {
+        gsl_Expects(i < size_);
+
+        return *reinterpret_cast<const_pointer>(&data()[i * bytesPerElement_]);
+    }
+
+    [[nodiscard]] iterator
+    begin() noexcept
+    {
+        return { data(), 0, bytesPerElement_ };
+    }
+    [[nodiscard]] const_iterator
+    begin() const noexcept
+    {
+        return { data(), 0, bytesPerElement_ };
+    }
+    [[nodiscard]] iterator
+    end() noexcept
+    {
+        return { data(), size_, bytesPerElement_ };
+    }
+    [[nodiscard]] const_iterator
+    end() const noexcept
+    {
+        return { data(), size_, bytesPerElement_ };
+    }
+
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] reference
+    front()
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] const_reference
+    front() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] reference
+    back()
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+    [[nodiscard]] const_reference
+    back() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+};
+
+
+    //
+    // Two-dimensional buffer with aligned rows which are mapped from a file.
+    //ᅟ
+    //ᅟ    auto matrix = mapped_row_buffer<double const, cache_line_alignment>("matrix.bin", cols);
+    //ᅟ    // every `matrix[i][0]` has cache-line alignment
+    //ᅟ
+    // The file holds the rows as they are laid out in memory by `aligned_row_buffer<T, Alignment>`, i.e. every row is padded to
+    // the given alignment unless a different row stride is specified, and the number of rows is inferred from the size of the
+    // file. The element type must be trivially copyable. If `T` is const-qualified, the file is mapped read-only; otherwise it
+    // is mapped with `copy_on_write` access unless specified otherwise. The size of the mapped part of the file must be a
+    // multiple of the row stride.
+    //
+template <typename T, std::size_t Alignment>
+class mapped_row_buffer
+{
+    static_assert(!std::is_volatile<T>::value, "buffer element type must not be volatile");
+    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
+    static_assert(std::is_trivially_copyable<T>::value, "mapped buffer element type must be trivially copyable");
+
+private:
+    file_mapping mapping_;
+    std::size_t rows_;
+    std::size_t cols_;
+    std::size_t bytesPerRow_;
+
+    char*
+    data() const noexcept
+    {
+        return static_cast<char*>(mapping_.data());
+    }
+
+    static std::size_t
+    aligned_row_stride(std::size_t cols)
+    {
+        auto rawBytesPerRowR = detail::try_multiply_unsigned(sizeof(T), cols);
+        auto bytesPerRowR = detail::try_ceili(rawBytesPerRowR.value, detail::alignment_in_bytes(Alignment | alignof(T)));
+        if (rawBytesPerRowR.ec != std::errc{ } || bytesPerRowR.ec != std::errc{ }) throw std::bad_alloc{ };
+        return bytesPerRowR.value;
+    }
+
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::span<T>;
+    using const_reference = std::span<T const>;
+
+    using iterator = detail::aligned_row_buffer_iterator<T>;
+    using const_iterator = detail::aligned_row_buffer_iterator<T const>;
+
+    static constexpr file_access default_access = std::is_const<T>::value ? file_access::read_only : file_access::copy_on_write;
+
+    mapped_row_buffer() noexcept
+        : rows_(0), cols_(0), bytesPerRow_(0)
+    {
+    }
+
+        //
+        // Maps the rows of `_cols` elements in the given file mapping. Mutable element types cannot be used with `read_only`
+        // mappings.
+        //
+    explicit mapped_row_buffer(file_mapping _mapping, std::size_t _cols)
+        : mapped_row_buffer(std::move(_mapping), _cols, aligned_row_stride(_cols))
+    {
+    }
+
+        //
+        // Maps the rows of `_cols` elements which are `_rowStride` bytes apart in the given file mapping, e.g. the rows of an
+        // `aligned_row_buffer<>` with `row_stride_policy::anti_aliased`, cf. `aligned_row_buffer<>::row_stride()`. Throws
+        // `std::system_error` if the row stride is not a multiple of the alignment or is too small to hold `_cols` elements.
+        //
+    explicit mapped_row_buffer(file_mapping _mapping, std::size_t _cols, std::size_t _rowStride)
+        : mapping_(std::move(_mapping)), rows_(0), cols_(_cols), bytesPerRow_(_rowStride)
+    {
+        gsl_Expects(std::is_const<T>::value || mapping_.access() != file_access::read_only);
+        gsl_Expects(detail::alignment_in_bytes(Alignment | alignof(T)) <= file_mapping::offset_granularity());
+
+        if (_rowStride % detail::alignment_in_bytes(Alignment | alignof(T)) != 0 || _rowStride < aligned_row_stride(_cols))
+        {
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "row stride does not match the row buffer type");
+        }
+        if (bytesPerRow_ != 0)
+        {
+            if (mapping_.size() % bytesPerRow_ != 0)
+            {
+                throw std::system_error(std::make_error_code(std::errc::invalid_argument), "file size is not a multiple of the row size");
+            }
+            rows_ = mapping_.size() / bytesPerRow_;
+        }
+    }
+    explicit mapped_row_buffer(std::filesystem::path const& _path, std::size_t _cols, map_advice _advice = map_advice::none)
+        : mapped_row_buffer(file_mapping(_path, default_access, _advice), _cols)
+    {
+    }
+    explicit mapped_row_buffer(std::filesystem::path const& _path, std::size_t _cols, file_access _access, map_advice _advice = map_advice::none)
+        : mapped_row_buffer(file_mapping(_path, _access, _advice), _cols)
+    {
+    }
+
+    mapped_row_buffer(mapped_row_buffer&& rhs) noexcept
+        : mapping_(std::move(rhs.mapping_)),
+          rows_(std::exchange(rhs.rows_, { })),
+          cols_(std::exchange(rhs.cols_, { })),
+          bytesPerRow_(std::exchange(rhs.bytesPerRow_, { }))
+    {
+    }
+    mapped_row_buffer&
+    operator =(mapped_row_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            mapping_ = std::move(rhs.mapping_);
+            rows_ = std::exchange(rhs.rows_, { });
+            cols_ = std::exchange(rhs.cols_, { });
+            bytesPerRow_ = std::exchange(rhs.bytesPerRow_, { });
+        }
+        return *this;
+    }
+
+        //
+        // The number of bytes needed to hold `_rows` rows of `_cols` elements.
+        //
+    [[nodiscard]] static std::size_t
+    required_size(std::size_t _rows, std::size_t _cols)
+    {
+        auto numBytesR = detail::try_multiply_unsigned(_rows, aligned_row_stride(_cols));
+        if (numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
+        return numBytesR.value;
+    }
+
+        //
+        // The underlying file mapping, e.g. for giving additional hints with `advise()` or for flushing modifications.
+        //
+    [[nodiscard]] file_mapping const&
+    mapping() const noexcept
+    {
+        return mapping_;
+    }
+
+    [[nodiscard]] std::size_t
+    rows() const noexcept
+    {
+        return rows_;
+    }
+    [[nodiscard]] std::size_t
+    columns() const noexcept
+    {
+        return cols_;
+    }
+
+        //
+        // The distance in bytes between the beginnings of consecutive rows.
+        //
+    [[nodiscard]] std::size_t
+    row_stride() const noexcept
+    {
+        return bytesPerRow_;
+    }
+
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return rows();
+    }
+    [[nodiscard]] std::span<T>
+    operator [](std::size_t i)
+    {
+        gsl_Expects(i < rows_);
+
+        return { reinterpret_cast<T*>(&data()[i * bytesPerRow_]), cols_ };
+    }
+    [[nodiscard]] std::span<T const>
+    operator [](std::size_t i) const
+    {
+        gsl_Expects(i < rows_);
+
+        return { reinterpret_cast<T const*>(&data()[i * bytesPerRow_]), cols_ };
+    }
+
+    [[nodiscard]] iterator
+    begin() noexcept
+    {
+        return { data(), 0, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] const_iterator
+    begin() const noexcept
+    {
+        return { data(), 0, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] iterator
+    end() noexcept
+    {
+        return { data(), rows_, cols_, bytesPerRow_ };
+    }
+    [[nodiscard]] const_iterator
+    end() const noexcept
+    {
+        return { data(), rows_, cols_, bytesPerRow_ };
+    }
+
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return rows_ == 0;
+    }
+
+    [[nodiscard]] reference
+    front()
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] const_reference
+    front() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[0];
+    }
+    [[nodiscard]] reference
+    back()
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+    [[nodiscard]] const_reference
+    back() const
+    {
+        gsl_Expects(!empty());
+        return (*this)[size() - 1];
+    }
+};
+
+
+} // namespace patton
+
+
+#endif // INCLUDED_PATTON_MAPPED_BUFFER_HPP_
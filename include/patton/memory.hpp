@@ -4,7 +4,10 @@
 
 
 #include <new>          // for align_val_t, bad_alloc
+#include <span>
 #include <limits>
+#include <vector>
+#include <cstdint>      // for uint64_t
 #include <cstddef>      // for size_t, ptrdiff_t, max_align_t
 #include <cstdlib>      // for calloc(), free()
 #include <cstring>      // for memcpy()
@@ -126,6 +129,7 @@ constexpr std::size_t cache_line_alignment = (std::size_t(-1) & ~(std::size_t(-1
     // The alignments corresponding to the special alignment values `large_page_alignment`, `page_alignment`, and
     // `cache_line_alignment` are not known until runtime,
     // hence to satisfy a requested special alignment it must be provided explicitly by the provided alignment.
+    // If the hardware constants are fixed at compile time (cf. patton/new.hpp), the actual alignments are compared instead.
     //
 [[nodiscard]] bool
 constexpr provides_static_alignment(std::size_t alignmentProvided, std::size_t alignmentRequested) noexcept
@@ -174,8 +178,12 @@ public:
 
 
     //
-    // Allocator that aligns memory allocations for the given alignment using the default allocator, i.e. global `operator new()`
-    // with `std::align_val_t`.
+    // Allocator that aligns memory allocations for the given alignment.
+    //ᅟ
+    // Allocations of up to 32 KiB are served from thread-local caches of power-of-two-sized blocks, which avoids contention
+    // between threads. Blocks freed by a thread are cached by that thread and are returned to a central pool in batches; the
+    // memory is not returned to the operating system. Larger allocations are forwarded to global `operator new()` with
+    // `std::align_val_t`.
     //ᅟ
     // Supports special alignment values such as `cache_line_alignment`.
     // Multiple alignment requirements can be combined using bitmask operations, e.g. `cache_line_alignment | alignof(T)`.
@@ -231,14 +239,61 @@ operator ==(aligned_allocator<T, Alignment>, aligned_allocator<U, Alignment>) no
 }
 
 
+    //
+    // Options for page-backed allocations. Flags can be combined with `|`.
+    //
+enum class page_flags : unsigned
+{
+    none = 0,
+
+        //
+        // Fault in all pages when the memory is allocated rather than when it is first accessed. Page faults then occur during
+        // setup rather than in the first loop which writes to the memory. The pages are faulted in by the allocating thread;
+        // to have every thread of a `thread_squad` touch its share of the memory instead, use the squad constructors of
+        // `aligned_buffer<>`.
+        //
+    populate = 1,
+
+        //
+        // On Linux, synchronously ask the kernel to back the allocation with transparent huge pages (`MADV_COLLAPSE`) rather
+        // than waiting for khugepaged to do so. Best-effort; only supported by `large_page_allocator<>`.
+        //
+    collapse = 2,
+
+        //
+        // Lock the pages in physical memory (`mlock()` on POSIX, `VirtualLock()` on Windows) so they cannot be paged out under
+        // memory pressure. Implies `populate`. Allocation throws `std::system_error` if the pages cannot be locked, e.g. because
+        // `RLIMIT_MEMLOCK` is exceeded on Linux or the working set is too small on Windows. Large pages are never paged out on
+        // Windows, so the flag has no effect there for `large_page_allocator<>`.
+        //
+    lock = 4
+};
+
+[[nodiscard]] constexpr page_flags
+operator |(page_flags lhs, page_flags rhs) noexcept
+{
+    return page_flags(unsigned(lhs) | unsigned(rhs));
+}
+[[nodiscard]] constexpr page_flags
+operator &(page_flags lhs, page_flags rhs) noexcept
+{
+    return page_flags(unsigned(lhs) & unsigned(rhs));
+}
+
+
     //
     // Obtains page-granular allocations directly from the operating system.
     //ᅟ
-    // On Linux, transparent huge pages are suppressed for allocations made by this allocator.
+    // On Linux, transparent huge pages are suppressed for allocations made by this allocator. Freed allocations may be retained
+    // for reuse, cf. `set_page_cache_capacity()`. The `populate` and `lock` flags can be passed to pre-fault or lock
+    // allocations.
     //
 template <typename T>
 class page_allocator
 {
+private:
+    page_flags flags_;
+
 public:
     using value_type = T;
 
@@ -249,13 +304,25 @@ public:
     };
 
     constexpr page_allocator() noexcept
+        : flags_(page_flags::none)
+    {
+    }
+    explicit constexpr page_allocator(page_flags _flags) noexcept
+        : flags_(_flags)
     {
     }
     template <typename U>
-    constexpr page_allocator(page_allocator<U> const&) noexcept
+    constexpr page_allocator(page_allocator<U> const& rhs) noexcept
+        : flags_(rhs.flags())
     {
     }
 
+    [[nodiscard]] constexpr page_flags
+    flags() const noexcept
+    {
+        return flags_;
+    }
+
     [[nodiscard]] bool
     static constexpr provides_static_alignment(std::size_t a) noexcept
     {
@@ -267,34 +334,80 @@ public:
     {
         if (n >= std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc{ }; // overflow
         std::size_t nbData = n * sizeof(T);
-        return static_cast<T*>(detail::page_alloc(nbData));
+        return static_cast<T*>(detail::page_alloc(nbData, flags_));
+    }
+
+        //
+        // Resizes an allocation and preserves its contents bytewise. On Linux, the pages are remapped rather than copied.
+        //
+    [[nodiscard]] T*
+    reallocate(T* ptr, std::size_t oldN, std::size_t newN)
+    {
+        if (newN >= std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc{ }; // overflow
+        return static_cast<T*>(detail::page_realloc(ptr, oldN * sizeof(T), newN * sizeof(T), flags_));
     }
     void
     deallocate(T* ptr, std::size_t n) noexcept
     {
         std::size_t nbData = n * sizeof(T); // cannot overflow due to preceding check in allocate()
-        detail::page_free(ptr, nbData);
+        detail::page_free(ptr, nbData, flags_);
     }
 };
 
 template <typename T, typename U>
-[[nodiscard]] bool
-operator ==(page_allocator<T>, page_allocator<U>) noexcept
+[[nodiscard]] constexpr bool
+operator ==(page_allocator<T> const& lhs, page_allocator<U> const& rhs) noexcept
 {
-    return true;
+    return lhs.flags() == rhs.flags();
 }
 
 
+    //
+    // Sets the maximal number of bytes held by the page cache, which retains page runs freed by `page_allocator<>` and (except
+    // for hugetlb pages) by `large_page_allocator<>` such that later allocations of similar size can reuse them without a
+    // round trip to the operating system. The default capacity is 0, which disables the cache. Reducing the capacity releases
+    // cached page runs as necessary.
+    //ᅟ
+    // An allocation is served from the smallest cached page run that is at least as large and at most twice as large; the
+    // excess pages of the run are released. On Windows, where part of an allocation cannot be released, only page runs of
+    // exactly the required size are reused.
+    //ᅟ
+    // Cached page runs are marked as reclaimable (with `MADV_FREE` on Linux and `MEM_RESET` on Windows), so the operating
+    // system may discard their contents under memory pressure. Allocations served from the cache are therefore not
+    // zero-initialized and do not have well-defined contents.
+    //
+void
+set_page_cache_capacity(std::size_t bytes);
+
+    //
+    // Returns the maximal number of bytes held by the page cache.
+    //
+[[nodiscard]] std::size_t
+page_cache_capacity() noexcept;
+
+    //
+    // Returns all page runs held by the page cache to the operating system.
+    //
+void
+trim_page_cache();
+
+
     //
     // Large page allocator.
     //ᅟ
-    // Uses transparent huge pages on Linux and explicit large page allocation on Windows.
+    // Uses transparent huge pages on Linux and explicit large page allocation on Windows. Allocations are aligned to the large
+    // page size so that the entire range can be backed by large pages. Use `large_page_backed_size()` to find out how much
+    // of an allocation actually is backed by large pages.
     // Note that processes on Windows need to obtain SeLockMemoryPrivilege in order to use large pages,
     // cf. https://docs.microsoft.com/en-us/windows/win32/memory/large-page-support.
     //
 template <typename T>
 class large_page_allocator
 {
+private:
+    std::size_t pageSize_;  // 0 for transparent huge pages
+    page_flags flags_;
+
 public:
     using value_type = T;
 
@@ -305,18 +418,219 @@ public:
     };
 
     constexpr large_page_allocator() noexcept
+        : pageSize_(0), flags_(page_flags::none)
+    {
+    }
+    explicit constexpr large_page_allocator(page_flags _flags) noexcept
+        : pageSize_(0), flags_(_flags)
+    {
+    }
+
+        //
+        // Allocates explicit huge pages of the given size from the corresponding hugetlb page pool on Linux. `_pageSize` must
+        // be one of the sizes reported by `hardware_large_page_sizes()`. If the pool does not have enough pages left, the
+        // allocator falls back to transparent huge pages; `large_page_allocation_page_size()` reports which kind of pages
+        // an allocation obtained.
+        //
+    explicit large_page_allocator(std::size_t _pageSize, page_flags _flags = page_flags::none)
+        : pageSize_(_pageSize), flags_(_flags)
     {
+        gsl_Expects(_pageSize != 0);
     }
+
     template <typename U>
-    constexpr large_page_allocator(large_page_allocator<U> const&) noexcept
+    constexpr large_page_allocator(large_page_allocator<U> const& rhs) noexcept
+        : pageSize_(rhs.page_size()), flags_(rhs.flags())
     {
     }
 
+        //
+        // The requested size of explicit huge pages, or 0 if transparent huge pages are used.
+        //
+    [[nodiscard]] constexpr std::size_t
+    page_size() const noexcept
+    {
+        return pageSize_;
+    }
+
+    [[nodiscard]] constexpr page_flags
+    flags() const noexcept
+    {
+        return flags_;
+    }
+
+    [[nodiscard]] bool
+    static constexpr provides_static_alignment(std::size_t a) noexcept
+    {
+        return patton::provides_static_alignment(large_page_alignment, a);
+    }
+
+    [[nodiscard]] T*
+    allocate(std::size_t n)
+    {
+        if (n >= std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc{ }; // overflow
+        std::size_t nbData = n * sizeof(T);
+        return static_cast<T*>(pageSize_ != 0
+            ? detail::huge_page_alloc(nbData, pageSize_, flags_)
+            : detail::large_page_alloc(nbData, flags_));
+    }
+
+        //
+        // Resizes an allocation and preserves its contents bytewise. On Linux, transparent huge pages are remapped rather than
+        // copied, and the result remains aligned to the large page size.
+        //
+    [[nodiscard]] T*
+    reallocate(T* ptr, std::size_t oldN, std::size_t newN)
+    {
+        if (newN >= std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc{ }; // overflow
+        return static_cast<T*>(detail::large_page_realloc(ptr, oldN * sizeof(T), newN * sizeof(T), flags_));
+    }
+    void
+    deallocate(T* ptr, std::size_t n) noexcept
+    {
+        std::size_t nbData = n * sizeof(T); // cannot overflow due to preceding check in allocate()
+        detail::large_page_free(ptr, nbData, flags_);
+    }
+};
+
+template <typename T, typename U>
+[[nodiscard]] constexpr bool
+operator ==(large_page_allocator<T> const& lhs, large_page_allocator<U> const& rhs) noexcept
+{
+    return lhs.page_size() == rhs.page_size() && lhs.flags() == rhs.flags();
+}
+
+
+    //
+    // Reports the size of the pages backing an allocation made by `large_page_allocator<>`.
+    //ᅟ
+    // On Linux, this is the page size of the hugetlb page pool if the allocation was served from a pool, or 0 if the allocation
+    // fell back to transparent huge pages; use `large_page_backed_size()` to find out how much of such an allocation is actually
+    // backed by large pages. On Windows, large page allocations are always backed by pages of size `hardware_large_page_size()`.
+    //
+[[nodiscard]] std::size_t
+large_page_allocation_page_size(void const* data) noexcept;
+
+
+    //
+    // Returns how many bytes of the given memory range are backed by large pages.
+    //ᅟ
+    // On Linux, the page frames backing the range are looked up in `/proc/self/pagemap`, and their flags in `/proc/kpageflags`.
+    // This requires the `CAP_SYS_ADMIN` capability. Otherwise, the information is read from `/proc/self/smaps`, which reports
+    // large page usage per memory mapping; if a mapping extends beyond the given range, its large page usage is attributed to
+    // the range up to the size of the overlap, which may overestimate the result because adjacent mappings can be merged.
+    // Returns 0 on platforms without large page support.
+    //
+[[nodiscard]] std::size_t
+large_page_backed_size(void const* data, std::size_t size);
+
+
+    //
+    // NUMA memory policy for allocations made by `numa_allocator<>`.
+    //
+enum class numa_policy : int
+{
+        //
+        // Pages are placed on the given node if possible, and on other nodes otherwise.
+        //
+    preferred,
+
+        //
+        // Pages are placed only on the given nodes. Allocation fails if the policy cannot be set.
+        //
+    bind,
+
+        //
+        // Pages are distributed round-robin across the given nodes.
+        //
+    interleave
+};
+
+
+    //
+    // Obtains page-granular allocations directly from the operating system and places them on NUMA nodes according to the given
+    // memory policy.
+    //ᅟ
+    //ᅟ    auto v = std::vector<float, numa_allocator<float>>(n, numa_allocator<float>(numa_policy::preferred, numaNode));
+    //ᅟ
+    // Only NUMA nodes with ids below 64 can be specified. On Linux, the policy is set with `mbind()`, and it determines where the
+    // pages are placed when they are first touched. Windows supports only the `preferred` policy, to which `bind` is mapped;
+    // `interleave` falls back to a regular page allocation. On other platforms, the policy is ignored.
+    //
+template <typename T>
+class numa_allocator
+{
+private:
+    numa_policy policy_;
+    std::uint64_t nodeMask_;
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = numa_allocator<U>;
+    };
+
+        //
+        // Interleaves allocations across all NUMA nodes.
+        //
+    constexpr numa_allocator() noexcept
+        : policy_(numa_policy::interleave), nodeMask_(0)
+    {
+    }
+
+        //
+        // Applies the given policy for the given NUMA node.
+        //
+    constexpr numa_allocator(numa_policy _policy, int numaNode)
+        : policy_(_policy), nodeMask_(0)
+    {
+        gsl_Expects(numaNode >= 0 && numaNode < 64);
+
+        nodeMask_ = std::uint64_t(1) << numaNode;
+    }
+
+        //
+        // Applies the given policy for the given NUMA nodes. An empty list of nodes refers to all nodes for `bind` and
+        // `interleave`, and to the node of the allocating thread for `preferred`.
+        //
+    constexpr numa_allocator(numa_policy _policy, std::span<int const> numaNodes)
+        : policy_(_policy), nodeMask_(0)
+    {
+        for (int numaNode : numaNodes)
+        {
+            gsl_Expects(numaNode >= 0 && numaNode < 64);
+
+            nodeMask_ |= std::uint64_t(1) << numaNode;
+        }
+    }
+
+    template <typename U>
+    constexpr numa_allocator(numa_allocator<U> const& rhs) noexcept
+        : policy_(rhs.policy()), nodeMask_(rhs.node_mask())
+    {
+    }
+
+    [[nodiscard]] constexpr numa_policy
+    policy() const noexcept
+    {
+        return policy_;
+    }
+
+        //
+        // Bit mask of the NUMA nodes the policy applies to; bit `i` corresponds to node `i`.
+        //
+    [[nodiscard]] constexpr std::uint64_t
+    node_mask() const noexcept
+    {
+        return nodeMask_;
+    }
+
     [[nodiscard]] bool
     static constexpr provides_static_alignment(std::size_t a) noexcept
     {
-            // We cannot guarantee large-page alignment particularly on Linux because `large_page_alloc()` uses `mmap()` and
-            // `madvise()`, so we only promise page alignment here.
         return patton::provides_static_alignment(page_alignment, a);
     }
 
@@ -325,24 +639,34 @@ public:
     {
         if (n >= std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_alloc{ }; // overflow
         std::size_t nbData = n * sizeof(T);
-        return static_cast<T*>(detail::large_page_alloc(nbData));
+        return static_cast<T*>(detail::numa_alloc(nbData, policy_, nodeMask_));
     }
     void
     deallocate(T* ptr, std::size_t n) noexcept
     {
         std::size_t nbData = n * sizeof(T); // cannot overflow due to preceding check in allocate()
-        detail::large_page_free(ptr, nbData);
+        detail::numa_free(ptr, nbData);
     }
 };
 
 template <typename T, typename U>
-[[nodiscard]] bool
-operator ==(large_page_allocator<T>, large_page_allocator<U>) noexcept
+[[nodiscard]] constexpr bool
+operator ==(numa_allocator<T> const& lhs, numa_allocator<U> const& rhs) noexcept
 {
-    return true;
+    return lhs.policy() == rhs.policy() && lhs.node_mask() == rhs.node_mask();
 }
 
 
+    //
+    // Returns the id of the NUMA node on which each page in the given memory range currently resides, or -1 for pages which
+    // have not been touched yet or whose location cannot be determined.
+    //ᅟ
+    // The range need not be page-aligned; the result has one entry for every page the range overlaps. On platforms without
+    // NUMA support, all entries are -1.
+    //
+[[nodiscard]] std::vector<int>
+page_numa_nodes(void const* data, std::size_t size);
+
     //
     // Allocator adaptor that aligns memory allocations for the given alignment.
     //ᅟ
@@ -0,0 +1,263 @@
+
+#ifndef INCLUDED_PATTON_MEMORY_RESOURCE_HPP_
+#define INCLUDED_PATTON_MEMORY_RESOURCE_HPP_
+
+
+#include <vector>
+#include <cstddef>          // for size_t, max_align_t
+#include <algorithm>        // for max()
+#include <memory_resource>  // for memory_resource
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects()
+
+#include <patton/new.hpp>     // for hardware_page_size(), hardware_large_page_size()
+#include <patton/memory.hpp>  // for page_flags
+
+
+namespace patton {
+
+
+namespace gsl = ::gsl_lite;
+
+
+    //
+    // Memory resource which obtains aligned allocations from the same allocator as `aligned_allocator<>`.
+    //ᅟ
+    // Allocations of up to 32 KiB are served from thread-local caches of power-of-two-sized blocks, which are not returned to
+    // the operating system. Larger allocations are forwarded to global `operator new()` with `std::align_val_t`.
+    //ᅟ
+    // Every allocation is aligned to at least the given minimal alignment, which may be used to avoid false sharing between
+    // allocations, e.g. by passing `hardware_cache_line_size()`.
+    //
+class aligned_memory_resource : public std::pmr::memory_resource
+{
+private:
+    std::size_t alignment_;
+
+protected:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return detail::aligned_alloc(bytes, std::max(alignment, alignment_));
+    }
+    void
+    do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        detail::aligned_free(p, bytes, std::max(alignment, alignment_));
+    }
+    bool
+    do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override
+    {
+        auto rhsAligned = dynamic_cast<aligned_memory_resource const*>(&rhs);
+        return rhsAligned != nullptr && rhsAligned->alignment_ == alignment_;
+    }
+
+public:
+    explicit aligned_memory_resource(std::size_t _alignment = alignof(std::max_align_t))
+        : alignment_(_alignment)
+    {
+        gsl_Expects(_alignment != 0 && (_alignment & (_alignment - 1)) == 0);
+    }
+
+    [[nodiscard]] std::size_t
+    alignment() const noexcept
+    {
+        return alignment_;
+    }
+};
+
+
+    //
+    // Memory resource which obtains page-granular allocations directly from the operating system, cf. `page_allocator<>`.
+    //ᅟ
+    // Every allocation occupies at least one page, so the resource is best used as the upstream resource of a pool or monotonic
+    // resource.
+    //
+class page_memory_resource : public std::pmr::memory_resource
+{
+private:
+    page_flags flags_;
+
+protected:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        gsl_Expects(alignment <= hardware_page_size());
+        return detail::page_alloc(bytes, flags_);
+    }
+    void
+    do_deallocate(void* p, std::size_t bytes, std::size_t /*alignment*/) override
+    {
+        detail::page_free(p, bytes, flags_);
+    }
+    bool
+    do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override
+    {
+        auto rhsPage = dynamic_cast<page_memory_resource const*>(&rhs);
+        return rhsPage != nullptr && rhsPage->flags_ == flags_;
+    }
+
+public:
+    explicit page_memory_resource(page_flags _flags = page_flags::none) noexcept
+        : flags_(_flags)
+    {
+    }
+
+    [[nodiscard]] page_flags
+    flags() const noexcept
+    {
+        return flags_;
+    }
+};
+
+
+    //
+    // Memory resource which obtains allocations backed by large pages from the operating system, cf. `large_page_allocator<>`.
+    //ᅟ
+    // Every allocation occupies at least one large page. To serve many small allocations from large pages, use
+    // `large_page_arena_resource` instead.
+    //
+class large_page_memory_resource : public std::pmr::memory_resource
+{
+private:
+    std::size_t pageSize_;  // 0 for transparent huge pages
+    page_flags flags_;
+
+protected:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        gsl_Expects(alignment <= hardware_large_page_size());
+        return pageSize_ != 0
+            ? detail::huge_page_alloc(bytes, pageSize_, flags_)
+            : detail::large_page_alloc(bytes, flags_);
+    }
+    void
+    do_deallocate(void* p, std::size_t bytes, std::size_t /*alignment*/) override
+    {
+        detail::large_page_free(p, bytes, flags_);
+    }
+    bool
+    do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override
+    {
+        auto rhsLargePage = dynamic_cast<large_page_memory_resource const*>(&rhs);
+        return rhsLargePage != nullptr && rhsLargePage->pageSize_ == pageSize_ && rhsLargePage->flags_ == flags_;
+    }
+
+public:
+    explicit large_page_memory_resource(page_flags _flags = page_flags::none) noexcept
+        : pageSize_(0), flags_(_flags)
+    {
+    }
+
+        //
+        // Allocates explicit huge pages of the given size, cf. the corresponding constructor of `large_page_allocator<>`.
+        //
+    explicit large_page_memory_resource(std::size_t _pageSize, page_flags _flags = page_flags::none)
+        : pageSize_(_pageSize), flags_(_flags)
+    {
+        gsl_Expects(_pageSize != 0);
+    }
+
+        //
+        // The requested size of explicit huge pages, or 0 if transparent huge pages are used.
+        //
+    [[nodiscard]] std::size_t
+    page_size() const noexcept
+    {
+        return pageSize_;
+    }
+
+    [[nodiscard]] page_flags
+    flags() const noexcept
+    {
+        return flags_;
+    }
+};
+
+
+    //
+    // Monotonic memory resource which carves allocations out of chunks backed by large pages.
+    //ᅟ
+    //ᅟ    auto arena = large_page_arena_resource{ };
+    //ᅟ    auto v = std::pmr::vector<float>(n, &arena);
+    //ᅟ    auto m = std::pmr::map<int, std::pmr::string>(&arena);
+    //ᅟ    // ...
+    //ᅟ    arena.release();  // must not be called while `v` and `m` are alive
+    //ᅟ
+    // Like `std::pmr::monotonic_buffer_resource`, deallocation is a no-op, and all memory is returned to the operating system
+    // at once by `release()` or by the destructor. Small allocations thus share a few large pages, which keeps the number of
+    // TLB entries needed to access them low. Allocations larger than the chunk size obtain a chunk of their own. The resource
+    // is not thread-safe; to reuse deallocated memory, use it as the upstream resource of a
+    // `std::pmr::unsynchronized_pool_resource`.
+    //
+class large_page_arena_resource : public std::pmr::memory_resource
+{
+private:
+    struct chunk
+    {
+        void* data;
+        std::size_t size;
+    };
+
+    std::size_t chunkSize_;
+    page_flags flags_;
+    std::vector<chunk> chunks_;
+    void* current_;
+    std::size_t remaining_;
+
+protected:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void
+    do_deallocate(void* /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override
+    {
+    }
+    bool
+    do_is_equal(std::pmr::memory_resource const& rhs) const noexcept override
+    {
+        return this == &rhs;
+    }
+
+public:
+        //
+        // Constructs an arena which allocates chunks of at least the given size, rounded up to a multiple of the large page size.
+        // A chunk size of 0 means one large page per chunk.
+        //
+    explicit large_page_arena_resource(std::size_t _chunkSize = 0, page_flags _flags = page_flags::none);
+
+    large_page_arena_resource(large_page_arena_resource const&) = delete;
+    large_page_arena_resource& operator =(large_page_arena_resource const&) = delete;
+
+    ~large_page_arena_resource();
+
+        //
+        // Returns all chunks to the operating system. Memory allocated from the arena must no longer be accessed.
+        //
+    void
+    release() noexcept;
+
+    [[nodiscard]] std::size_t
+    chunk_size() const noexcept
+    {
+        return chunkSize_;
+    }
+
+    [[nodiscard]] page_flags
+    flags() const noexcept
+    {
+        return flags_;
+    }
+
+        //
+        // The total size of all chunks currently held by the arena.
+        //
+    [[nodiscard]] std::size_t
+    reserved_size() const noexcept;
+};
+
+
+} // namespace patton
+
+
+#endif // INCLUDED_PATTON_MEMORY_RESOURCE_HPP_
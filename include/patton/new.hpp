@@ -3,8 +3,11 @@
 #define INCLUDED_PATTON_NEW_HPP_
 
 
+#include <span>
 #include <cstddef> // for size_t
 
+#include <patton/detail/new.hpp>
+
 
 namespace patton {
 
@@ -17,23 +20,127 @@ namespace patton {
     // impact of false sharing. To determine an accurate value at runtime, call `hardware_cache_line_size()`.
 
 
+    // The hardware constants can be fixed at compile time by defining the macros `PATTON_HARDWARE_LARGE_PAGE_SIZE`,
+    // `PATTON_HARDWARE_PAGE_SIZE`, and `PATTON_HARDWARE_CACHE_LINE_SIZE`, which are usually set through the CMake cache variables
+    // of the same name. The corresponding functions then become `constexpr`, and the values are checked against the running
+    // hardware at startup.
+
+
     //
     // Reports the operating system's large page size in bytes, or 0 if large pages are not available or not supported.
     //
+#if defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
+[[nodiscard]] constexpr std::size_t
+hardware_large_page_size() noexcept
+{
+    return PATTON_HARDWARE_LARGE_PAGE_SIZE;
+}
+#else // ^^^ defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) ^^^ / vvv !defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) vvv
 [[nodiscard]] std::size_t
 hardware_large_page_size() noexcept;
+#endif // defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
+
+    //
+    // Reports all large page sizes supported by the operating system in bytes, in ascending order.
+    //ᅟ
+    // On Linux, these are the sizes for which the kernel maintains hugetlb page pools, cf. `/sys/kernel/mm/hugepages`. Whether
+    // pages of a given size are actually available depends on how many pages were reserved for the pool.
+    //
+[[nodiscard]] std::span<std::size_t const>
+hardware_large_page_sizes() noexcept;
 
     //
     // Reports the operating system's page size in bytes.
     //
+#if defined(PATTON_HARDWARE_PAGE_SIZE)
+[[nodiscard]] constexpr std::size_t
+hardware_page_size() noexcept
+{
+    return PATTON_HARDWARE_PAGE_SIZE;
+}
+#else // ^^^ defined(PATTON_HARDWARE_PAGE_SIZE) ^^^ / vvv !defined(PATTON_HARDWARE_PAGE_SIZE) vvv
 [[nodiscard]] std::size_t
 hardware_page_size() noexcept;
+#endif // defined(PATTON_HARDWARE_PAGE_SIZE)
 
     //
     // Reports the CPU architecture's cache line size in bytes.
     //
+#if defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+[[nodiscard]] constexpr std::size_t
+hardware_cache_line_size() noexcept
+{
+    return PATTON_HARDWARE_CACHE_LINE_SIZE;
+}
+#else // ^^^ defined(PATTON_HARDWARE_CACHE_LINE_SIZE) ^^^ / vvv !defined(PATTON_HARDWARE_CACHE_LINE_SIZE) vvv
 [[nodiscard]] std::size_t
 hardware_cache_line_size() noexcept;
+#endif // defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+
+    //
+    // Reports the minimum offset in bytes between two objects to avoid false sharing.
+    //ᅟ
+    // Unlike the cache line size, this accounts for adjacent-line prefetching: the spatial prefetcher of Intel CPUs fetches cache
+    // lines in 128-byte-aligned pairs, so objects on adjacent cache lines can still interfere.
+    //
+[[nodiscard]] std::size_t
+hardware_destructive_interference_size() noexcept;
+
+    //
+    // Conservative compile-time upper bound for `hardware_destructive_interference_size()`. Unlike
+    // `std::hardware_destructive_interference_size`, this is meant to be used for padding, and it does not change across
+    // compiler versions or target tuning flags.
+    //
+#if defined(_M_IX86) || defined(_M_AMD64) || defined(__i386__) || defined(__x86_64__)
+constexpr std::size_t max_hardware_destructive_interference_size = 128;  // pairs of 64-byte cache lines
+#elif defined(_M_ARM64) || defined(__aarch64__)
+constexpr std::size_t max_hardware_destructive_interference_size = 256;  // some ARM cores have 128-byte cache lines which may also be prefetched in pairs
+#else
+constexpr std::size_t max_hardware_destructive_interference_size = 128;
+#endif
+
+    //
+    // Reports the capacity in bytes of the data or unified CPU cache of the given level, or 0 if the cache level does not exist or
+    // if its size is unknown.
+    //ᅟ
+    // If caches of the same level differ in size, as on CPUs with heterogeneous cores, the smallest size is reported.
+    //
+[[nodiscard]] std::size_t
+hardware_cache_size(int level) noexcept;
+
+    //
+    // Reports the capacity in bytes of the data or unified CPU cache of the given level divided by the number of hardware threads
+    // which share it, or 0 if the cache level does not exist or if its size is unknown.
+    //ᅟ
+    // For a shared last-level cache, this is the amount of cache a thread can expect to have to itself when all hardware threads
+    // are busy. If the share differs between caches of the same level, the smallest share is reported.
+    //
+[[nodiscard]] std::size_t
+hardware_cache_size_per_thread(int level) noexcept;
+
+    //
+    // Reports the number of ways of associativity of the data or unified CPU cache of the given level, or 0 if the cache level
+    // does not exist, if its associativity is unknown, or if it is fully associative.
+    //
+[[nodiscard]] int
+hardware_cache_associativity(int level) noexcept;
+
+
+#if defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) || defined(PATTON_HARDWARE_PAGE_SIZE) || defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+namespace detail {
+
+inline bool const hardware_constants_checked = (detail::check_hardware_constants(), true);
+
+} // namespace detail
+#endif // defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) || defined(PATTON_HARDWARE_PAGE_SIZE) || defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+
+#if defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) && defined(PATTON_HARDWARE_PAGE_SIZE) && defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+    // All special alignments are known at compile time.
+# define PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN
+static_assert((hardware_cache_line_size() & (hardware_cache_line_size() - 1)) == 0, "cache line size must be a power of 2");
+static_assert(hardware_page_size() % hardware_cache_line_size() == 0, "page size must be a multiple of cache line size");
+static_assert(hardware_large_page_size() % hardware_page_size() == 0, "large page size must be a multiple of page size");
+#endif // defined(PATTON_HARDWARE_LARGE_PAGE_SIZE) && defined(PATTON_HARDWARE_PAGE_SIZE) && defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
 
 
 } // namespace patton
@@ -0,0 +1,594 @@
+
+#ifndef INCLUDED_PATTON_TENSOR_BUFFER_HPP_
+#define INCLUDED_PATTON_TENSOR_BUFFER_HPP_
+
+
+#include <new>           // for bad_alloc
+#include <array>
+#include <memory>        // for allocator_traits<>
+#include <cstddef>       // for size_t, ptrdiff_t
+#include <numeric>       // for lcm()
+#include <utility>       // for move(), exchange(), pair<>
+#include <version>       // for __cpp_lib_mdspan
+#include <concepts>      // for convertible_to<>
+#include <algorithm>     // for max()
+#include <type_traits>   // for is_const<>, is_volatile<>, is_reference<>, is_convertible<>, is_nothrow_constructible<>, negation<>
+#include <system_error>  // for errc
+
+#if defined(__cpp_lib_mdspan)
+# include <mdspan>
+#endif // defined(__cpp_lib_mdspan)
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects(), owner<>
+
+#include <patton/memory.hpp>        // for aligned_allocator<>, aligned_allocator_adaptor<>
+#include <patton/thread_squad.hpp>
+
+#include <patton/detail/buffer.hpp>       // for construct_aligned_buffer(), destroy_aligned_buffer(), construct_with_squad()
+#include <patton/detail/memory.hpp>       // for alignment_in_bytes()
+#include <patton/detail/arithmetic.hpp>   // for try_multiply_unsigned(), try_ceili()
+#include <patton/detail/transaction.hpp>
+
+
+namespace patton {
+
+
+namespace gsl = ::gsl_lite;
+
+
+    //
+    // Non-owning view of a `Rank`-dimensional array with strided layout and contiguous innermost dimension.
+    //ᅟ
+    //ᅟ    tensor_view<float, 3> grid = buf.view();
+    //ᅟ    grid(i, j, k) = 0.f;       // element access
+    //ᅟ    auto plane = grid[i];      // `tensor_view<float, 2>`
+    //ᅟ    auto line = grid[i][j];    // `tensor_view<float, 1>` with contiguous elements
+    //ᅟ
+    // Strides are given in elements, as for `std::layout_stride`. The stride of the innermost dimension is always 1, so the
+    // innermost loop of a nest over the view runs over consecutive elements and can be vectorized. If the standard library
+    // provides `std::mdspan<>`, the view can be converted with `to_mdspan()`.
+    //
+template <typename T, std::size_t Rank>
+class tensor_view
+{
+    static_assert(Rank >= 1, "rank must be positive");
+
+private:
+    T* data_;
+    std::array<std::size_t, Rank> extents_;
+    std::array<std::size_t, Rank> strides_;
+
+public:
+    using element_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+
+    constexpr tensor_view() noexcept
+        : data_(nullptr), extents_{ }, strides_{ }
+    {
+        strides_[Rank - 1] = 1;
+    }
+    constexpr tensor_view(T* _data, std::array<std::size_t, Rank> const& _extents, std::array<std::size_t, Rank> const& _strides) noexcept
+        : data_(_data), extents_(_extents), strides_(_strides)
+    {
+        gsl_Expects(_strides[Rank - 1] == 1);
+    }
+    template <typename U>
+        requires std::is_convertible<U(*)[], T(*)[]>::value
+    constexpr tensor_view(tensor_view<U, Rank> const& rhs) noexcept
+        : data_(rhs.data_handle()), extents_(rhs.extents()), strides_(rhs.strides())
+    {
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    rank() noexcept
+    {
+        return Rank;
+    }
+
+    [[nodiscard]] constexpr std::size_t
+    extent(std::size_t r) const
+    {
+        gsl_Expects(r < Rank);
+
+        return extents_[r];
+    }
+    [[nodiscard]] constexpr std::array<std::size_t, Rank> const&
+    extents() const noexcept
+    {
+        return extents_;
+    }
+
+        //
+        // The distance in elements between consecutive indices of dimension `r`. `stride(rank() - 1)` is always 1.
+        //
+    [[nodiscard]] constexpr std::size_t
+    stride(std::size_t r) const
+    {
+        gsl_Expects(r < Rank);
+
+        return strides_[r];
+    }
+    [[nodiscard]] constexpr std::array<std::size_t, Rank> const&
+    strides() const noexcept
+    {
+        return strides_;
+    }
+
+    [[nodiscard]] constexpr T*
+    data_handle() const noexcept
+    {
+        return data_;
+    }
+
+        //
+        // The number of elements in the view, not counting padding.
+        //
+    [[nodiscard]] constexpr std::size_t
+    size() const noexcept
+    {
+        std::size_t result = 1;
+        for (std::size_t r = 0; r != Rank; ++r)
+        {
+            result *= extents_[r];
+        }
+        return result;
+    }
+    [[nodiscard]] constexpr bool
+    empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    template <typename... Is>
+        requires (sizeof...(Is) == Rank) && (std::convertible_to<Is, std::size_t> && ...)
+    [[nodiscard]] constexpr T&
+    operator ()(Is... is) const
+    {
+        return (*this)[std::array<std::size_t, Rank>{ static_cast<std::size_t>(is)... }];
+    }
+    [[nodiscard]] constexpr T&
+    operator [](std::array<std::size_t, Rank> const& idx) const
+    {
+        std::size_t offset = idx[Rank - 1];
+        gsl_Expects(idx[Rank - 1] < extents_[Rank - 1]);
+        for (std::size_t r = 0; r != Rank - 1; ++r)
+        {
+            gsl_Expects(idx[r] < extents_[r]);
+            offset += idx[r]*strides_[r];
+        }
+        return data_[offset];
+    }
+
+        //
+        // The sub-view for index `i` of the outermost dimension.
+        //
+    [[nodiscard]] constexpr tensor_view<T, Rank - 1>
+    operator [](std::size_t i) const
+        requires (Rank > 1)
+    {
+        gsl_Expects(i < extents_[0]);
+
+        auto subExtents = std::array<std::size_t, Rank - 1>{ };
+        auto subStrides = std::array<std::size_t, Rank - 1>{ };
+        for (std::size_t r = 1; r != Rank; ++r)
+        {
+            subExtents[r - 1] = extents_[r];
+            subStrides[r - 1] = strides_[r];
+        }
+        return { data_ + i*strides_[0], subExtents, subStrides };
+    }
+    [[nodiscard]] constexpr T&
+    operator [](std::size_t i) const
+        requires (Rank == 1)
+    {
+        gsl_Expects(i < extents_[0]);
+
+        return data_[i];
+    }
+
+        //
+        // The sub-view of indices `[first, last)` along dimension `axis`.
+        //
+    [[nodiscard]] constexpr tensor_view
+    slice(std::size_t axis, std::size_t first, std::size_t last) const
+    {
+        gsl_Expects(axis < Rank && first <= last && last <= extents_[axis]);
+
+        auto subExtents = extents_;
+        subExtents[axis] = last - first;
+        return { data_ + first*strides_[axis], subExtents, strides_ };
+    }
+
+        //
+        // The sub-view along dimension `axis` which is assigned to the current thread by `task_context::partition()`.
+        //ᅟ
+        //ᅟ    squad.run([&](thread_squad::task_context& ctx)
+        //ᅟ    {
+        //ᅟ        auto myPlanes = grid.partition(ctx, 0);
+        //ᅟ        ...
+        //ᅟ    });
+        //ᅟ
+        // Partitioning along dimension 0 assigns every thread the same elements it constructed if the tensor buffer was
+        // constructed with the same thread squad.
+        //
+    [[nodiscard]] tensor_view
+    partition(thread_squad::task_context const& ctx, std::size_t axis = 0) const
+    {
+        gsl_Expects(axis < Rank);
+
+        auto [first, last] = ctx.partition(extents_[axis]);
+        return slice(axis, first, last);
+    }
+
+#if defined(__cpp_lib_mdspan)
+    [[nodiscard]] std::mdspan<T, std::dextents<std::size_t, Rank>, std::layout_stride>
+    to_mdspan() const
+    {
+        using extents_type = std::dextents<std::size_t, Rank>;
+        return { data_, typename std::layout_stride::template mapping<extents_type>(extents_type(extents_), strides_) };
+    }
+#endif // defined(__cpp_lib_mdspan)
+};
+
+
+namespace detail {
+
+
+    // Computes the strides in elements of a tensor with padded extents whose innermost dimension is aligned, and the number of
+    // elements to allocate.
+template <std::size_t Rank>
+std::array<std::size_t, Rank>
+tensor_strides(std::array<std::size_t, Rank> const& extents, std::array<std::size_t, Rank> const& paddedExtents,
+    std::size_t elementSize, std::size_t alignment, std::size_t& numElements)
+{
+    auto strides = std::array<std::size_t, Rank>{ };
+    strides[Rank - 1] = 1;
+    std::size_t stride = 1;
+    for (std::size_t r = Rank - 1; r != 0; --r)
+    {
+        std::size_t paddedExtent = std::max(extents[r], paddedExtents[r]);
+        if (r == Rank - 1)
+        {
+                // Round the innermost dimension up to a whole number of alignment units, which must also hold whole elements.
+            auto paddedExtentR = detail::try_ceili(paddedExtent, std::lcm(alignment, elementSize)/elementSize);
+            if (paddedExtentR.ec != std::errc{ }) throw std::bad_alloc{ };
+            paddedExtent = paddedExtentR.value;
+        }
+        auto strideR = detail::try_multiply_unsigned(stride, paddedExtent);
+        if (strideR.ec != std::errc{ }) throw std::bad_alloc{ };
+        stride = strideR.value;
+        strides[r - 1] = stride;
+    }
+    auto numElementsR = detail::try_multiply_unsigned(extents[0], stride);
+    auto numBytesR = detail::try_multiply_unsigned(numElementsR.value, elementSize);
+    if (numElementsR.ec != std::errc{ } || numBytesR.ec != std::errc{ }) throw std::bad_alloc{ };
+    numElements = numElementsR.value;
+    return strides;
+}
+
+
+} // namespace detail
+
+
+    //
+    // `Rank`-dimensional buffer with aligned innermost dimension.
+    //ᅟ
+    //ᅟ    auto grid = aligned_tensor_buffer<float, 3, cache_line_alignment>({ nz, ny, nx });
+    //ᅟ    // every `grid(k, j, 0)` has cache-line alignment
+    //ᅟ
+    // Elements are laid out in row-major order. Every line of the innermost dimension starts at an address aligned to the
+    // given alignment, and the strides of the other dimensions can be padded further by passing padded extents to the
+    // constructor, e.g. to keep successive planes from mapping to the same cache sets. Supports special alignment values such
+    // as `cache_line_alignment`. Multiple alignment requirements can be combined using bitmask operations, e.g.
+    // `cache_line_alignment | alignof(T)`.
+    // Padding slots are storage for elements like all others, so they are constructed and destroyed along with the elements.
+    // If a thread squad is passed to the constructor, the elements are constructed in parallel by the threads of the squad,
+    // each thread constructing the slices along dimension 0 it is assigned by `thread_squad::task_context::partition(extent(0))`,
+    // cf. `tensor_view<>::partition()`.
+    //
+template <typename T, std::size_t Rank, std::size_t Alignment, typename A = aligned_allocator<T, Alignment>>
+class aligned_tensor_buffer : private aligned_allocator_adaptor<T, Alignment | alignof(T), A>
+{
+    static_assert(!std::is_const<T>::value && !std::is_volatile<T>::value, "buffer element type must not have cv qualifiers");
+    static_assert(!std::is_reference<T>::value, "buffer element type must not be a reference");
+    static_assert(Rank >= 1, "rank must be positive");
+
+    struct internal_constructor { };
+
+public:
+    using allocator_type = aligned_allocator_adaptor<T, Alignment | alignof(T), A>;
+    using extents_type = std::array<std::size_t, Rank>;
+
+private:
+    using byte_allocator_ = typename std::allocator_traits<allocator_type>::template rebind_alloc<char>;
+    static constexpr bool allocator_is_default_constructible_ = std::is_default_constructible<allocator_type>::value;
+
+    gsl::owner<char*> data_;
+    extents_type extents_;
+    extents_type strides_;     // in elements
+    std::size_t numElements_;  // including padding
+
+    static constexpr extents_type
+    empty_strides() noexcept
+    {
+        auto result = extents_type{ };
+        result[Rank - 1] = 1;
+        return result;
+    }
+
+    aligned_tensor_buffer(internal_constructor, thread_squad* squad, extents_type const& _extents, extents_type const& _paddedExtents, allocator_type _allocator)
+        : allocator_type(std::move(_allocator)), extents_(_extents)
+    {
+        strides_ = detail::tensor_strides(_extents, _paddedExtents, sizeof(T), detail::alignment_in_bytes(Alignment | alignof(T)), numElements_);
+
+        if (numElements_ == 0)
+        {
+            data_ = nullptr;
+        }
+        else
+        {
+            auto alloc = byte_allocator_(get_allocator());
+            data_ = std::allocator_traits<byte_allocator_>::allocate(alloc, numElements_ * sizeof(T));
+
+            if (squad != nullptr)
+            {
+                    // Slices along dimension 0 are distributed across threads, cf. `tensor_view<>::partition()`.
+                std::size_t bytesPerSlice = strides_[0] * sizeof(T);
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_default_constructible<T>>{ },
+                    [this]
+                    {
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, numElements_ * sizeof(T));
+                    });
+                detail::construct_with_squad(*squad, _extents[0], std::is_nothrow_default_constructible<T>{ },
+                    [&](std::size_t first, std::size_t last)
+                    {
+                        std::size_t numElementsConstructed = 0;
+                        auto rangeTransaction = detail::make_transaction(
+                            std::negation<std::is_nothrow_default_constructible<T>>{ },
+                            [this, first, bytesPerSlice, &numElementsConstructed]
+                            {
+                                detail::destroy_aligned_buffer<T>(data_ + first * bytesPerSlice, get_allocator(), numElementsConstructed, sizeof(T));
+                            });
+                        detail::construct_aligned_buffer<T>(data_ + first * bytesPerSlice, get_allocator(), numElementsConstructed, (last - first) * strides_[0], sizeof(T),
+                            std::is_nothrow_default_constructible<T>{ });
+                        rangeTransaction.commit();
+                    },
+                    [this, bytesPerSlice](std::size_t first, std::size_t last)
+                    {
+                        detail::destroy_aligned_buffer<T>(data_ + first * bytesPerSlice, get_allocator(), (last - first) * strides_[0], sizeof(T));
+                    });
+                transaction.commit();
+            }
+            else
+            {
+                std::size_t numElementsConstructed = 0;
+                auto transaction = detail::make_transaction(
+                    std::negation<std::is_nothrow_default_constructible<T>>{ },
+                    [this, &numElementsConstructed]
+                    {
+                        detail::destroy_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, sizeof(T));
+                        auto alloc = byte_allocator_(get_allocator());
+                        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, numElements_ * sizeof(T));
+                    });
+                detail::construct_aligned_buffer<T>(data_, get_allocator(), numElementsConstructed, numElements_, sizeof(T),
+                    std::is_nothrow_default_constructible<T>{ });
+                transaction.commit();
+            }
+        }
+    }
+    void
+    destroy_and_free() noexcept
+    {
+        detail::destroy_aligned_buffer<T>(data_, get_allocator(), numElements_, sizeof(T));
+        auto alloc = byte_allocator_(get_allocator());
+        std::allocator_traits<byte_allocator_>::deallocate(alloc, data_, numElements_ * sizeof(T));
+    }
+
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    aligned_tensor_buffer() noexcept
+        : allocator_type{ }, data_(nullptr), extents_{ }, strides_(empty_strides()), numElements_(0)
+    {
+    }
+    aligned_tensor_buffer(allocator_type _alloc) noexcept
+        : allocator_type(std::move(_alloc)), data_(nullptr), extents_{ }, strides_(empty_strides()), numElements_(0)
+    {
+    }
+
+        //
+        // Constructs a buffer with the given extents. If padded extents are given, the stride of dimension `r - 1` is at
+        // least the stride of dimension `r` times `_paddedExtents[r]`; the padded extent of dimension 0 is not used.
+        //
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_tensor_buffer(extents_type const& _extents)
+        : aligned_tensor_buffer(internal_constructor{ }, nullptr, _extents, { }, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_tensor_buffer(extents_type const& _extents, extents_type const& _paddedExtents)
+        : aligned_tensor_buffer(internal_constructor{ }, nullptr, _extents, _paddedExtents, { })
+    {
+    }
+    explicit aligned_tensor_buffer(extents_type const& _extents, extents_type const& _paddedExtents, A _alloc)
+        : aligned_tensor_buffer(internal_constructor{ }, nullptr, _extents, _paddedExtents, std::move(_alloc))
+    {
+    }
+
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_tensor_buffer(thread_squad& _squad, extents_type const& _extents)
+        : aligned_tensor_buffer(internal_constructor{ }, &_squad, _extents, { }, { })
+    {
+    }
+    template <typename U = int, std::enable_if_t<allocator_is_default_constructible_, U> = 0>
+    explicit aligned_tensor_buffer(thread_squad& _squad, extents_type const& _extents, extents_type const& _paddedExtents)
+        : aligned_tensor_buffer(internal_constructor{ }, &_squad, _extents, _paddedExtents, { })
+    {
+    }
+    explicit aligned_tensor_buffer(thread_squad& _squad, extents_type const& _extents, extents_type const& _paddedExtents, A _alloc)
+        : aligned_tensor_buffer(internal_constructor{ }, &_squad, _extents, _paddedExtents, std::move(_alloc))
+    {
+    }
+
+    constexpr aligned_tensor_buffer(aligned_tensor_buffer&& rhs) noexcept
+        : allocator_type(std::move(rhs)),
+          data_(std::exchange(rhs.data_, { })),
+          extents_(std::exchange(rhs.extents_, { })),
+          strides_(std::exchange(rhs.strides_, empty_strides())),
+          numElements_(std::exchange(rhs.numElements_, { }))
+    {
+    }
+    constexpr aligned_tensor_buffer&
+    operator =(aligned_tensor_buffer&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (data_ != nullptr)
+            {
+                destroy_and_free();
+            }
+            static_cast<allocator_type&>(*this) = std::move(rhs);
+            data_ = std::exchange(rhs.data_, { });
+            extents_ = std::exchange(rhs.extents_, { });
+            strides_ = std::exchange(rhs.strides_, empty_strides());
+            numElements_ = std::exchange(rhs.numElements_, { });
+        }
+        return *this;
+    }
+
+    ~aligned_tensor_buffer()
+    {
+        if (data_ != nullptr)
+        {
+            destroy_and_free();
+        }
+    }
+
+    [[nodiscard]] allocator_type
+    get_allocator() const noexcept
+    {
+        return *this;
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    rank() noexcept
+    {
+        return Rank;
+    }
+    [[nodiscard]] std::size_t
+    extent(std::size_t r) const
+    {
+        gsl_Expects(r < Rank);
+
+        return extents_[r];
+    }
+    [[nodiscard]] extents_type const&
+    extents() const noexcept
+    {
+        return extents_;
+    }
+
+        //
+        // The distance in elements between consecutive indices of dimension `r`. `stride(rank() - 1)` is always 1.
+        //
+    [[nodiscard]] std::size_t
+    stride(std::size_t r) const
+    {
+        gsl_Expects(r < Rank);
+
+        return strides_[r];
+    }
+    [[nodiscard]] extents_type const&
+    strides() const noexcept
+    {
+        return strides_;
+    }
+
+        //
+        // The number of elements in the buffer, not counting padding.
+        //
+    [[nodiscard]] std::size_t
+    size() const noexcept
+    {
+        return view().size();
+    }
+    [[nodiscard]] bool
+    empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    [[nodiscard]] tensor_view<T, Rank>
+    view() noexcept
+    {
+        return { reinterpret_cast<T*>(data_), extents_, strides_ };
+    }
+    [[nodiscard]] tensor_view<T const, Rank>
+    view() const noexcept
+    {
+        return { reinterpret_cast<T const*>(data_), extents_, strides_ };
+    }
+
+    template <typename... Is>
+        requires (sizeof...(Is) == Rank) && (std::convertible_to<Is, std::size_t> && ...)
+    [[nodiscard]] reference
+    operator ()(Is... is)
+    {
+        return view()(is...);
+    }
+    template <typename... Is>
+        requires (sizeof...(Is) == Rank) && (std::convertible_to<Is, std::size_t> && ...)
+    [[nodiscard]] const_reference
+    operator ()(Is... is) const
+    {
+        return view()(is...);
+    }
+    [[nodiscard]] reference
+    operator [](extents_type const& idx)
+    {
+        return view()[idx];
+    }
+    [[nodiscard]] const_reference
+    operator [](extents_type const& idx) const
+    {
+        return view()[idx];
+    }
+    [[nodiscard]] decltype(auto)
+    operator [](std::size_t i)
+    {
+        return view()[i];
+    }
+    [[nodiscard]] decltype(auto)
+    operator [](std::size_t i) const
+    {
+        return view()[i];
+    }
+
+        //
+        // The sub-view along dimension `axis` which is assigned to the current thread by `task_context::partition()`, cf.
+        // `tensor_view<>::partition()`.
+        //
+    [[nodiscard]] tensor_view<T, Rank>
+    partition(thread_squad::task_context const& ctx, std::size_t axis = 0)
+    {
+        return view().partition(ctx, axis);
+    }
+    [[nodiscard]] tensor_view<T const, Rank>
+    partition(thread_squad::task_context const& ctx, std::size_t axis = 0) const
+    {
+        return view().partition(ctx, axis);
+    }
+};
+
+
+} // namespace patton
+
+
+#endif // INCLUDED_PATTON_TENSOR_BUFFER_HPP_
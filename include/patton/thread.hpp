@@ -30,6 +30,42 @@ physical_concurrency() noexcept;
 physical_core_ids() noexcept;
 
 
+    //
+    // Returns the id of the NUMA node of the hardware thread the calling thread is currently running on.
+    //ᅟ
+    // Unless the calling thread is pinned to hardware threads on a single NUMA node, the result may be outdated by the time it is
+    // returned. Returns 0 if the NUMA node cannot be determined.
+    //
+[[nodiscard]] int
+current_numa_node() noexcept;
+
+    //
+    // Groups of hardware threads which share a hardware resource.
+    //
+enum class affinity_domain
+{
+        //
+        // A single hardware thread.
+        //
+    hardware_thread,
+
+        //
+        // All hardware threads of a physical core, i.e. a hardware thread and its SMT siblings.
+        //
+    core,
+
+        //
+        // All hardware threads which share the last-level cache (typically the L3 cache) with the hardware thread.
+        //
+    last_level_cache,
+
+        //
+        // All hardware threads which belong to the same NUMA node as the hardware thread.
+        //
+    numa_node
+};
+
+
 } // namespace patton
 
 
@@ -4,12 +4,15 @@
 
 
 #include <span>
-#include <utility>     // for move()
+#include <cstddef>     // for size_t
+#include <utility>     // for move(), pair<>
 #include <concepts>
 #include <functional>  // for function<>, identity
 
 #include <gsl-lite/gsl-lite.hpp>  // for not_null<>
 
+#include <patton/thread.hpp>  // for affinity_domain, current_numa_node()
+
 #include <patton/detail/thread_squad.hpp>
 
 
@@ -41,6 +44,16 @@ public:
             //
         bool pin_to_hardware_threads = false;
 
+            //
+            // Controls the granularity of thread pinning if `pin_to_hardware_threads` is `true`.
+            //ᅟ
+            // By default, every thread is pinned to a single hardware thread. If a coarser affinity domain is chosen, every
+            // thread is pinned to the set of hardware threads which share the given domain with its designated hardware thread,
+            // e.g. to all hardware threads sharing its L3 cache. The operating system can then migrate the thread away from
+            // a busy hardware thread while maintaining data locality.
+            //
+        affinity_domain pinning_domain = affinity_domain::hardware_thread;
+
             //
             // Controls whether thread synchronization uses spin waiting with exponential backoff.
             //
@@ -108,6 +121,31 @@ public:
             return numRunningThreads_;
         }
 
+            //
+            // The id of the NUMA node the current thread runs on.
+            //ᅟ
+            // If the thread squad pins threads to hardware threads, this is the NUMA node of the hardware thread the current
+            // thread is pinned to. Otherwise, the NUMA node is determined with `current_numa_node()`.
+            //
+        [[nodiscard]] int
+        numa_node() const noexcept;
+
+            //
+            // The contiguous range `[first, last)` of indices in `[0, size)` assigned to the current thread by the static
+            // schedule.
+            //ᅟ
+            //ᅟ    auto [first, last] = ctx.partition(n);
+            //ᅟ    for (std::size_t i = first; i != last; ++i) { ... }
+            //ᅟ
+            // The index range is split into `num_threads()` blocks in thread order whose sizes differ by at most 1. Buffers
+            // constructed with a thread squad are first-touched according to this schedule, cf. `aligned_buffer<>`.
+            //
+        [[nodiscard]] std::pair<std::size_t, std::size_t>
+        partition(std::size_t size) const noexcept
+        {
+            return detail::static_partition(size, threadIdx_, numRunningThreads_);
+        }
+
             //
             // Synchronizes all threads which execute the current task.
             //ᅟ
@@ -289,11 +327,12 @@ public:
 
         if (concurrency != 0)
         {
-            auto data = std::make_unique<detail::thread_reduce_data<T>[]>(concurrency);
-            auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data.get());
+            auto data = detail::thread_reduce_buffer<T>(concurrency);
+            auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data);
             op.params.concurrency = concurrency;
             op.params.join_requested = true;
             do_run(op);
+            data.mark_constructed();
             return op.reduce_op()(std::move(init), std::move(data[0].value).value());
         }
         else
@@ -328,10 +367,11 @@ public:
 
         if (concurrency != 0)
         {
-            auto data = std::make_unique<detail::thread_reduce_data<T>[]>(concurrency);
-            auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data.get());
+            auto data = detail::thread_reduce_buffer<T>(concurrency);
+            auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data);
             op.params.concurrency = concurrency;
             do_run(op);
+            data.mark_constructed();
             return op.reduce_op()(std::move(init), std::move(data[0].value).value());
         }
         else
@@ -364,11 +404,12 @@ public:
             concurrency = handle_->numThreads;
         }
 
-        auto data = std::make_unique<detail::thread_reduce_data<T>[]>(concurrency);
-        auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data.get());
+        auto data = detail::thread_reduce_buffer<T>(concurrency);
+        auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data);
         op.params.concurrency = concurrency;
         op.params.join_requested = true;
         do_run(op);
+        data.mark_constructed();
         return std::move(data[0].value).value();
     }
 
@@ -396,10 +437,11 @@ public:
             concurrency = handle_->numThreads;
         }
 
-        auto data = std::make_unique<detail::thread_reduce_data<T>[]>(concurrency);
-        auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data.get());
+        auto data = detail::thread_reduce_buffer<T>(concurrency);
+        auto op = detail::thread_squad_transform_reduce_operation<task_context, TransformFuncT, T, ReduceOpT>(std::move(transformFunc), std::move(reduceOp), data);
         op.params.concurrency = concurrency;
         do_run(op);
+        data.mark_constructed();
         return std::move(data[0].value).value();
     }
 };
@@ -0,0 +1,234 @@
+
+#ifndef INCLUDED_PATTON_TOPOLOGY_HPP_
+#define INCLUDED_PATTON_TOPOLOGY_HPP_
+
+
+#include <span>
+#include <vector>
+#include <cstddef>      // for size_t
+#include <string_view>
+
+
+namespace patton {
+
+
+    //
+    // Kind of data held by a CPU cache.
+    //
+enum class cache_type
+{
+    data,
+    instruction,
+    unified
+};
+
+
+    //
+    // Describes a hardware thread, i.e. a logical CPU.
+    //
+struct hardware_thread_info
+{
+        //
+        // The id of the hardware thread as used by the operating system, e.g. for thread affinity.
+        //
+    int id;
+
+        //
+        // The index of the physical core the hardware thread belongs to. Cores are numbered consecutively in the order of their
+        // lowest hardware thread id.
+        //
+    int core;
+
+        //
+        // The id of the physical package (socket) the hardware thread belongs to.
+        //
+    int package;
+
+        //
+        // The id of the NUMA node the hardware thread belongs to.
+        //
+    int numa_node;
+};
+
+
+    //
+    // Describes a CPU cache.
+    //
+struct cache_info
+{
+        //
+        // The cache level, e.g. 1 for the L1 cache.
+        //
+    int level;
+
+        //
+        // The kind of data held by the cache.
+        //
+    cache_type type;
+
+        //
+        // The cache capacity in bytes, or 0 if unknown.
+        //
+    std::size_t size;
+
+        //
+        // The cache line size in bytes, or 0 if unknown.
+        //
+    std::size_t line_size;
+
+        //
+        // The number of ways of associativity, or 0 if unknown or if the cache is fully associative.
+        //
+    int associativity;
+
+        //
+        // The ids of the hardware threads which share the cache, in ascending order.
+        //
+    std::vector<int> hardware_threads;
+};
+
+
+    //
+    // Describes how the hardware threads of a machine are organized into cores, packages, NUMA nodes, and cache domains.
+    //ᅟ
+    //ᅟ    auto const& topology = cpu_topology::system();
+    //ᅟ    auto llc = topology.last_level_cache(hardwareThreadId);
+    //ᅟ    // `llc->hardware_threads` lists all hardware threads which share the L3 cache with `hardwareThreadId`
+    //ᅟ
+    // On Linux, the topology is read from sysfs. The sysfs root can be specified explicitly, which allows loading a captured copy
+    // of the sysfs tree of another machine.
+    //
+class cpu_topology
+{
+private:
+    std::vector<hardware_thread_info> hardwareThreads_;  // ordered by id
+    std::vector<int> hardwareThreadIndices_;             // maps hardware thread ids to indices in `hardwareThreads_`, or -1
+    std::vector<std::vector<int>> coreHardwareThreads_;
+    std::vector<int> packages_;
+    std::vector<std::vector<int>> packageHardwareThreads_;
+    std::vector<int> numaNodes_;
+    std::vector<std::vector<int>> numaNodeHardwareThreads_;
+    std::vector<cache_info> caches_;
+    std::vector<std::vector<int>> hardwareThreadCaches_;  // indices in `caches_` for every hardware thread
+
+    int
+    hardware_thread_index(int hardwareThreadId) const;
+
+public:
+        //
+        // Constructs a topology from the given hardware threads and caches.
+        //ᅟ
+        // `hardware_thread_info::core` may be an arbitrary key which identifies the physical core within its package; cores are
+        // renumbered consecutively.
+        //
+    cpu_topology(std::vector<hardware_thread_info> hardwareThreads, std::vector<cache_info> caches);
+
+        //
+        // The topology of the current machine. The topology is determined when the function is first called.
+        //
+    [[nodiscard]] static cpu_topology const&
+    system();
+
+        //
+        // Reads the topology from the sysfs tree at the given root directory, e.g. "/sys".
+        //ᅟ
+        // Throws `std::runtime_error` if the list of online CPUs cannot be read or parsed.
+        //
+    [[nodiscard]] static cpu_topology
+    from_sysfs(std::string_view sysfsRoot = "/sys");
+
+        //
+        // The hardware threads of the machine, ordered by id.
+        //
+    [[nodiscard]] std::span<hardware_thread_info const>
+    hardware_threads() const noexcept
+    {
+        return hardwareThreads_;
+    }
+
+        //
+        // Returns whether the machine has an online hardware thread with the given id.
+        //
+    [[nodiscard]] bool
+    contains(int hardwareThreadId) const noexcept;
+
+        //
+        // Describes the hardware thread with the given id.
+        //
+    [[nodiscard]] hardware_thread_info const&
+    hardware_thread(int hardwareThreadId) const;
+
+        //
+        // The number of physical cores.
+        //
+    [[nodiscard]] int
+    num_cores() const noexcept
+    {
+        return static_cast<int>(coreHardwareThreads_.size());
+    }
+
+        //
+        // The ids of the hardware threads of the core with the given index, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    core_hardware_threads(int core) const;
+
+        //
+        // The ids of the physical packages, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    packages() const noexcept
+    {
+        return packages_;
+    }
+
+        //
+        // The ids of the hardware threads of the package with the given id, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    package_hardware_threads(int package) const;
+
+        //
+        // The ids of the NUMA nodes which have hardware threads, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    numa_nodes() const noexcept
+    {
+        return numaNodes_;
+    }
+
+        //
+        // The ids of the hardware threads of the NUMA node with the given id, in ascending order.
+        //
+    [[nodiscard]] std::span<int const>
+    numa_node_hardware_threads(int numaNode) const;
+
+        //
+        // All caches of the machine. Caches shared by several hardware threads are listed only once.
+        //
+    [[nodiscard]] std::span<cache_info const>
+    caches() const noexcept
+    {
+        return caches_;
+    }
+
+        //
+        // The cache of the given level and type used by the hardware thread with the given id, or `nullptr` if there is no such
+        // cache. When looking up data or instruction caches, a unified cache of the given level also matches.
+        //
+    [[nodiscard]] cache_info const*
+    cache(int hardwareThreadId, int level, cache_type type = cache_type::data) const;
+
+        //
+        // The data or unified cache with the highest level used by the hardware thread with the given id, or `nullptr` if no
+        // cache information is available.
+        //
+    [[nodiscard]] cache_info const*
+    last_level_cache(int hardwareThreadId) const;
+};
+
+
+} // namespace patton
+
+
+#endif // INCLUDED_PATTON_TOPOLOGY_HPP_
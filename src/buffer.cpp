@@ -0,0 +1,73 @@
+
+#include <numeric>    // for gcd()
+#include <cstddef>    // for size_t
+#include <algorithm>  // for min(), all_of()
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects()
+
+#include <patton/new.hpp>  // for hardware_cache_line_size(), hardware_cache_size(), hardware_cache_associativity()
+
+#include <patton/detail/buffer.hpp>
+
+
+namespace patton::detail {
+
+
+    // The number of candidate strides examined before giving up.
+static constexpr std::size_t maxAntiAliasingSteps = 64;
+
+struct cache_set_geometry
+{
+    std::size_t waySize;  // the number of bytes spanned by one way of all sets
+    std::size_t numSets;
+    std::size_t associativity;
+};
+
+static bool
+spreads_across_sets(std::size_t rowStride, cache_set_geometry const& cache) noexcept
+{
+        // The beginnings of consecutive rows map to sets which are `gcd(rowStride, waySize)` bytes apart.
+    std::size_t numSetsVisited = std::min(cache.numSets, cache.waySize / std::gcd(rowStride, cache.waySize));
+    return numSetsVisited >= std::min(cache.numSets, cache.associativity);
+}
+
+std::size_t
+anti_aliased_row_stride(std::size_t rowStride, std::size_t alignment) noexcept
+{
+    gsl_Expects(alignment != 0 && rowStride % alignment == 0);
+
+    if (rowStride == 0)
+    {
+        return 0;
+    }
+
+    std::size_t lineSize = hardware_cache_line_size();
+    cache_set_geometry caches[2];
+    std::size_t numCaches = 0;
+    for (int level = 1; level <= 2; ++level)
+    {
+        std::size_t size = hardware_cache_size(level);
+        int associativity = hardware_cache_associativity(level);
+        if (size == 0 || associativity <= 0)
+        {
+            continue;  // unknown, or fully associative
+        }
+        std::size_t waySize = size / std::size_t(associativity);
+        if (waySize >= lineSize)
+        {
+            caches[numCaches++] = { waySize, waySize / lineSize, std::size_t(associativity) };
+        }
+    }
+
+    for (std::size_t i = 0, stride = rowStride; i != maxAntiAliasingSteps && stride >= rowStride; ++i, stride += alignment)
+    {
+        if (std::all_of(caches, caches + numCaches, [stride](cache_set_geometry const& cache) { return spreads_across_sets(stride, cache); }))
+        {
+            return stride;
+        }
+    }
+    return rowStride;
+}
+
+
+} // namespace patton::detail
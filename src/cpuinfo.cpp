@@ -4,12 +4,15 @@
 #include <atomic>
 #include <memory>     // for unique_ptr<>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstddef>    // for ptrdiff_t
+#include <cstdlib>    // for strtol(), strtoull(), atoi()
 #include <fstream>
 #include <iostream>
 #include <stdexcept>  // for runtime_error
-#include <algorithm>  // for sort(), unique()
+#include <utility>    // for pair<>, move()
+#include <algorithm>  // for sort(), unique(), lower_bound(), find(), any_of()
 
 #if defined(_WIN32)
 # ifndef NOMINMAX
@@ -18,8 +21,9 @@
 # include <Windows.h>
 # include <Memoryapi.h>
 #elif defined(__linux__)
-# include <unistd.h>
+# include <unistd.h>       // for syscall()
 # include <stdio.h>
+# include <sys/syscall.h>  // for SYS_getcpu
 #elif defined(__APPLE__)
 # include <unistd.h>
 # include <sys/types.h>
@@ -30,7 +34,12 @@
 
 #include <gsl-lite/gsl-lite.hpp>  // for dim, gsl_ExpectsAudit(), narrow_failfast<>()
 
+#include <patton/thread.hpp>
+#include <patton/topology.hpp>
+
+#include <patton/detail/new.hpp>
 #include <patton/detail/errors.hpp>
+#include <patton/detail/thread.hpp>
 
 
 namespace patton::detail {
@@ -50,30 +59,117 @@ struct cpu_info
 };
 
 
-#if defined(__linux__)
-struct physical_core_id
+static cpu_info cpu_info_value{ };
+
+#if defined(_WIN32)
+static std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION>
+get_logical_processor_information()
 {
-    int core_id;
-    int physical_id;
-    int processor;
+    auto result = std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION>{ };
+    DWORD nbSlpi = 0;
+    BOOL success = GetLogicalProcessorInformation(nullptr, &nbSlpi);
+    if (!success && GetLastError() == ERROR_INSUFFICIENT_BUFFER)
+    {
+        result.resize((nbSlpi + sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION) - 1) / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        success = GetLogicalProcessorInformation(result.data(), &nbSlpi);
+    }
+    detail::win32_assert(success);
+    result.resize(nbSlpi / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    return result;
+}
 
-    friend bool operator ==(physical_core_id const& lhs, physical_core_id const& rhs)
+static std::vector<int>
+processor_mask_to_ids(ULONG_PTR mask)
+{
+    auto result = std::vector<int>{ };
+    for (int i = 0; mask != 0; ++i, mask >>= 1)
     {
-        return lhs.core_id == rhs.core_id && lhs.physical_id == rhs.physical_id;
+        if ((mask & 1) != 0)
+        {
+            result.push_back(i);
+        }
     }
-    friend bool operator <(physical_core_id const& lhs, physical_core_id const& rhs)
+    return result;
+}
+#endif // defined(_WIN32)
+
+    // Parses a list of CPU ids in the format used by sysfs, e.g. "0-3,8-11".
+static std::vector<int>
+parse_cpu_list(std::string const& str)
+{
+    auto result = std::vector<int>{ };
+    char const* p = str.c_str();
+    while (*p != '\0' && *p != '\n')
     {
-        if (lhs.core_id < rhs.core_id) return true;
-        if (lhs.core_id > rhs.core_id) return false;
-        if (lhs.physical_id < rhs.physical_id) return true;
-        if (lhs.physical_id > rhs.physical_id) return false;
-        return lhs.processor < rhs.processor;
+        char* end;
+        long first = std::strtol(p, &end, 10);
+        if (end == p) throw std::runtime_error("error parsing CPU list \"" + str + "\"");
+        long last = first;
+        p = end;
+        if (*p == '-')
+        {
+            ++p;
+            last = std::strtol(p, &end, 10);
+            if (end == p || last < first) throw std::runtime_error("error parsing CPU list \"" + str + "\"");
+            p = end;
+        }
+        for (long i = first; i <= last; ++i)
+        {
+            result.push_back(gsl::narrow_failfast<int>(i));
+        }
+        if (*p == ',')
+        {
+            ++p;
+        }
     }
-};
-#endif // defined(__linux__)
+    return result;
+}
 
+    // Reads the first line of the given file. Returns `false` if the file cannot be opened.
+static bool
+try_read_line(std::string const& path, std::string& line)
+{
+    auto f = std::ifstream(path);
+    if (!f) return false;
+    std::getline(f, line);
+    return true;
+}
 
-static cpu_info cpu_info_value{ };
+    // Parses a cache size in the format used by sysfs, e.g. "32K".
+static std::size_t
+parse_cache_size(std::string const& str)
+{
+    char* end;
+    unsigned long long result = std::strtoull(str.c_str(), &end, 10);
+    switch (*end)
+    {
+    case 'K': result <<= 10; break;
+    case 'M': result <<= 20; break;
+    case 'G': result <<= 30; break;
+    }
+    return gsl::narrow_failfast<std::size_t>(result);
+}
+
+    // Collects the distinct values of the given member in ascending order, along with the ids of the hardware threads for
+    // every value.
+static void
+group_hardware_threads(
+    std::span<hardware_thread_info const> hardwareThreads, int hardware_thread_info::* member,
+    std::vector<int>& groups, std::vector<std::vector<int>>& groupHardwareThreads)
+{
+    for (auto const& hardwareThread : hardwareThreads)
+    {
+        groups.push_back(hardwareThread.*member);
+    }
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end()), groups.end());
+    groupHardwareThreads.resize(groups.size());
+    for (auto const& hardwareThread : hardwareThreads)
+    {
+        auto pos = std::lower_bound(groups.begin(), groups.end(), hardwareThread.*member) - groups.begin();
+        groupHardwareThreads[pos].push_back(hardwareThread.id);
+    }
+}
 
     // Returns the number of the lowest bit set. Expects that at least one bit is set.
 template <typename T>
@@ -104,32 +200,21 @@ init_cpu_info() noexcept
         auto lresult = cpu_info{ };
 
 #if defined(_WIN32)
-        std::unique_ptr<SYSTEM_LOGICAL_PROCESSOR_INFORMATION[]> dynSlpi;
-        SYSTEM_LOGICAL_PROCESSOR_INFORMATION* pSlpi = nullptr;
-        DWORD nbSlpi = 0;
-        BOOL success = GetLogicalProcessorInformation(pSlpi, &nbSlpi);
-        if (!success && GetLastError() == ERROR_INSUFFICIENT_BUFFER)
-        {
-            dynSlpi = std::make_unique<SYSTEM_LOGICAL_PROCESSOR_INFORMATION[]>((nbSlpi + sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION) - 1) / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
-            pSlpi = dynSlpi.get();
-            success = GetLogicalProcessorInformation(pSlpi, &nbSlpi);
-        }
-        detail::win32_assert(success);
-        for (std::ptrdiff_t i = 0, n = nbSlpi / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); i != n; ++i)
+        for (auto const& slpi : detail::get_logical_processor_information())
         {
-            if (pSlpi[i].Relationship == RelationProcessorCore)
+            if (slpi.Relationship == RelationProcessorCore)
             {
                 ++newPhysicalConcurrency;
-                int id = detail::lowest_bit_set(pSlpi[i].ProcessorMask);
+                int id = detail::lowest_bit_set(slpi.ProcessorMask);
                 coreThreadIds.push_back(id);
             }
-            if (pSlpi[i].Relationship == RelationCache && pSlpi[i].Cache.Level == 1 && (pSlpi[i].Cache.Type == CacheData || pSlpi[i].Cache.Type == CacheUnified))
+            if (slpi.Relationship == RelationCache && slpi.Cache.Level == 1 && (slpi.Cache.Type == CacheData || slpi.Cache.Type == CacheUnified))
             {
                 if (newCacheLineSize == 0)
                 {
-                    newCacheLineSize = pSlpi[i].Cache.LineSize;
+                    newCacheLineSize = slpi.Cache.LineSize;
                 }
-                else if (newCacheLineSize != pSlpi[i].Cache.LineSize)
+                else if (newCacheLineSize != slpi.Cache.LineSize)
                 {
                     throw std::runtime_error("GetLogicalProcessorInformation() reports different L1 cache line sizes for different cores");  // ...and we cannot handle that
                 }
@@ -152,65 +237,14 @@ init_cpu_info() noexcept
         cpu_info_value.cache_line_size.store(newCacheLineSize, std::memory_order_relaxed);
 
 #elif defined(__linux__)
-            // I can't believe that parsing /proc/cpuinfo is the accepted way to query the number of physical cores.
-        auto f = std::ifstream("/proc/cpuinfo");
-        if (!f) throw std::runtime_error("cannot open /proc/cpuinfo");  // something is really wrong if we cannot open that file
-        auto ids = std::vector<physical_core_id>{ };
-        auto line = std::string{ };
-        int lastProcessor = -1;
-        int lastCoreId = -1;
-        int lastPhysicalId = -1;
-        while (std::getline(f, line))
+        auto const& topology = cpu_topology::system();
+        newPhysicalConcurrency = gsl::narrow_failfast<unsigned>(topology.num_cores());
+        coreThreadIds.reserve(topology.num_cores());
+        for (int core = 0; core < topology.num_cores(); ++core)
         {
-            int nFields;
-            int id;
-            nFields = std::sscanf(line.c_str(), "processor : %d", &id);
-            if (nFields == 1)
-            {
-                if (lastProcessor != -1) throw std::runtime_error("error parsing /proc/cpuinfo: missing \"processor\" value");
-                lastProcessor = id;
-            }
-            else
-            {
-                nFields = std::sscanf(line.c_str(), "physical id : %d", &id);
-                if (nFields == 1)
-                {
-                    if (lastPhysicalId != -1) throw std::runtime_error("error parsing /proc/cpuinfo: missing \"core id\" value");
-                    lastPhysicalId = id;
-                }
-                else
-                {
-                    nFields = std::sscanf(line.c_str(), "core id : %d", &id);
-                    if (nFields == 1)
-                    {
-                        if (lastCoreId != -1) throw std::runtime_error("error parsing /proc/cpuinfo: missing \"physical id\" value");
-                        lastCoreId = id;
-                    }
-                }
-            }
-            if (lastProcessor != -1 && lastCoreId != -1 && lastPhysicalId != -1)
-            {
-                ids.push_back(detail::physical_core_id{ lastCoreId, lastPhysicalId, lastProcessor });
-                lastProcessor = -1;
-                lastCoreId = -1;
-                lastPhysicalId = -1;
-            }
+                // Cores are numbered in the order of their lowest hardware thread id, so `coreThreadIds` ends up sorted.
+            coreThreadIds.push_back(topology.core_hardware_threads(core).front());
         }
-        f.close();
-
-        std::sort(ids.begin(), ids.end());
-        auto numUnique = std::unique(ids.begin(), ids.end()) - ids.begin();
-        newPhysicalConcurrency = gsl::narrow_failfast<unsigned>(numUnique);
-
-        coreThreadIds.resize(numUnique);
-        std::transform(
-            ids.begin(), ids.begin() + numUnique,
-            coreThreadIds.begin(),
-            [](physical_core_id const& id)
-            {
-                return id.processor;
-            });
-        std::sort(coreThreadIds.begin(), coreThreadIds.end());
 #elif defined(__APPLE__)
         int result = 0;
         std::size_t nbResult = sizeof result;
@@ -245,12 +279,367 @@ init_cpu_info() noexcept
 }
 
 
+std::vector<int>
+affinity_domain_members(int hardwareThreadId, affinity_domain domain)
+{
+    gsl_Expects(hardwareThreadId >= 0);
+
+    auto const& topology = cpu_topology::system();
+    if (topology.contains(hardwareThreadId))
+    {
+        auto members = std::span<int const>{ };
+        switch (domain)
+        {
+        case affinity_domain::hardware_thread:
+            break;
+        case affinity_domain::core:
+            members = topology.core_hardware_threads(topology.hardware_thread(hardwareThreadId).core);
+            break;
+        case affinity_domain::last_level_cache:
+            if (auto cache = topology.last_level_cache(hardwareThreadId))
+            {
+                members = cache->hardware_threads;
+            }
+            break;
+        case affinity_domain::numa_node:
+            members = topology.numa_node_hardware_threads(topology.hardware_thread(hardwareThreadId).numa_node);
+            break;
+        }
+        if (!members.empty())
+        {
+            return { members.begin(), members.end() };
+        }
+    }
+    return { hardwareThreadId };
+}
+
+
+#if defined(_WIN32)
+std::size_t
+query_hardware_cache_line_size()
+{
+    detail::init_cpu_info();
+    return cpu_info_value.cache_line_size.load(std::memory_order_relaxed);
+}
+#endif // defined(_WIN32)
+
+
 } // namespace patton::detail
 
 namespace patton {
 
 
+cpu_topology::cpu_topology(std::vector<hardware_thread_info> hardwareThreads, std::vector<cache_info> caches)
+    : hardwareThreads_(std::move(hardwareThreads)), caches_(std::move(caches))
+{
+    std::sort(
+        hardwareThreads_.begin(), hardwareThreads_.end(),
+        [](hardware_thread_info const& lhs, hardware_thread_info const& rhs)
+        {
+            return lhs.id < rhs.id;
+        });
+    int numHardwareThreads = gsl::narrow_failfast<int>(hardwareThreads_.size());
+    int maxId = numHardwareThreads != 0 ? hardwareThreads_.back().id : -1;
+    gsl_Expects(numHardwareThreads == 0 || hardwareThreads_.front().id >= 0);
+    hardwareThreadIndices_.assign(gsl::narrow_failfast<std::size_t>(maxId + 1), -1);
+    for (int i = 0; i < numHardwareThreads; ++i)
+    {
+        int& index = hardwareThreadIndices_[hardwareThreads_[i].id];
+        gsl_Expects(index == -1);  // hardware thread ids must be unique
+        index = i;
+    }
+
+        // Cores are identified by their package and their core key; renumber them in the order of their lowest hardware thread id.
+    auto coreKeys = std::vector<std::pair<int, int>>{ };
+    for (auto& hardwareThread : hardwareThreads_)
+    {
+        auto key = std::pair(hardwareThread.package, hardwareThread.core);
+        auto it = std::find(coreKeys.begin(), coreKeys.end(), key);
+        if (it == coreKeys.end())
+        {
+            coreKeys.push_back(key);
+            coreHardwareThreads_.emplace_back();
+            it = coreKeys.end() - 1;
+        }
+        hardwareThread.core = gsl::narrow_failfast<int>(it - coreKeys.begin());
+        coreHardwareThreads_[hardwareThread.core].push_back(hardwareThread.id);
+    }
+
+    detail::group_hardware_threads(hardwareThreads_, &hardware_thread_info::package, packages_, packageHardwareThreads_);
+    detail::group_hardware_threads(hardwareThreads_, &hardware_thread_info::numa_node, numaNodes_, numaNodeHardwareThreads_);
+
+        // Only retain hardware threads we know about, and drop caches which are not used by any of them.
+    for (auto& cache : caches_)
+    {
+        std::erase_if(
+            cache.hardware_threads,
+            [this](int id)
+            {
+                return !contains(id);
+            });
+        std::sort(cache.hardware_threads.begin(), cache.hardware_threads.end());
+    }
+    std::erase_if(
+        caches_,
+        [](cache_info const& cache)
+        {
+            return cache.hardware_threads.empty();
+        });
+    hardwareThreadCaches_.resize(hardwareThreads_.size());
+    for (int i = 0, n = gsl::narrow_failfast<int>(caches_.size()); i < n; ++i)
+    {
+        for (int id : caches_[i].hardware_threads)
+        {
+            hardwareThreadCaches_[hardwareThreadIndices_[id]].push_back(i);
+        }
+    }
+}
+
+cpu_topology const&
+cpu_topology::system()
+{
+    static cpu_topology const topology = []
+    {
 #if defined(_WIN32)
+        auto hardwareThreads = std::vector<hardware_thread_info>{ };
+        auto caches = std::vector<cache_info>{ };
+        auto slpis = detail::get_logical_processor_information();
+        int core = 0;
+        for (auto const& slpi : slpis)
+        {
+            if (slpi.Relationship == RelationProcessorCore)
+            {
+                for (int id : detail::processor_mask_to_ids(slpi.ProcessorMask))
+                {
+                    hardwareThreads.push_back({ .id = id, .core = core, .package = 0, .numa_node = 0 });
+                }
+                ++core;
+            }
+        }
+        auto forEachHardwareThread = [&hardwareThreads](ULONG_PTR mask, auto&& func)
+        {
+            for (auto& hardwareThread : hardwareThreads)
+            {
+                if (hardwareThread.id < int(sizeof(ULONG_PTR) * 8) && (mask & (ULONG_PTR(1) << hardwareThread.id)) != 0)  // bits per byte
+                {
+                    func(hardwareThread);
+                }
+            }
+        };
+        int package = 0;
+        for (auto const& slpi : slpis)
+        {
+            switch (slpi.Relationship)
+            {
+            case RelationProcessorPackage:
+                forEachHardwareThread(slpi.ProcessorMask, [package](hardware_thread_info& hardwareThread) { hardwareThread.package = package; });
+                ++package;
+                break;
+            case RelationNumaNode:
+                forEachHardwareThread(slpi.ProcessorMask, [&slpi](hardware_thread_info& hardwareThread) { hardwareThread.numa_node = int(slpi.NumaNode.NodeNumber); });
+                break;
+            case RelationCache:
+                if (slpi.Cache.Type != CacheTrace)
+                {
+                    caches.push_back({
+                        .level = slpi.Cache.Level,
+                        .type = slpi.Cache.Type == CacheData ? cache_type::data
+                              : slpi.Cache.Type == CacheInstruction ? cache_type::instruction
+                              : cache_type::unified,
+                        .size = slpi.Cache.Size,
+                        .line_size = slpi.Cache.LineSize,
+                        .associativity = slpi.Cache.Associativity != CACHE_FULLY_ASSOCIATIVE ? int(slpi.Cache.Associativity) : 0,
+                        .hardware_threads = detail::processor_mask_to_ids(slpi.ProcessorMask)
+                    });
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return cpu_topology(std::move(hardwareThreads), std::move(caches));
+#elif defined(__linux__)
+        return cpu_topology::from_sysfs();
+#elif defined(__APPLE__)
+        int logicalCpus = 0;
+        int physicalCpus = 0;
+        std::size_t nbResult = sizeof(int);
+        int ec = sysctlbyname("hw.logicalcpu", &logicalCpus, &nbResult, 0, 0);
+        if (ec != 0) throw std::runtime_error("cannot query hw.logicalcpu");
+        ec = sysctlbyname("hw.physicalcpu", &physicalCpus, &nbResult, 0, 0);
+        if (ec != 0) throw std::runtime_error("cannot query hw.physicalcpu");
+
+            // macOS does not expose the assignment of hardware threads to cores; SMT siblings are numbered consecutively.
+        int threadsPerCore = std::max(1, logicalCpus / std::max(1, physicalCpus));
+        auto hardwareThreads = std::vector<hardware_thread_info>{ };
+        for (int id = 0; id < logicalCpus; ++id)
+        {
+            hardwareThreads.push_back({ .id = id, .core = id / threadsPerCore, .package = 0, .numa_node = 0 });
+        }
+        return cpu_topology(std::move(hardwareThreads), { });
+#else
+# error Unsupported operating system.
+#endif
+    }();
+    return topology;
+}
+
+cpu_topology
+cpu_topology::from_sysfs(std::string_view sysfsRoot)
+{
+    auto cpuRoot = std::string(sysfsRoot) + "/devices/system/cpu";
+    auto line = std::string{ };
+    if (!detail::try_read_line(cpuRoot + "/online", line))
+    {
+        throw std::runtime_error("cannot read " + cpuRoot + "/online");
+    }
+    auto ids = detail::parse_cpu_list(line);
+    std::sort(ids.begin(), ids.end());
+
+    auto hardwareThreads = std::vector<hardware_thread_info>{ };
+    auto caches = std::vector<cache_info>{ };
+    hardwareThreads.reserve(ids.size());
+    for (int id : ids)
+    {
+        auto cpuPath = cpuRoot + "/cpu" + std::to_string(id);
+
+            // Core ids are unique only within a package. If the topology is not known, every hardware thread is its own core.
+        int package = detail::try_read_line(cpuPath + "/topology/physical_package_id", line) ? std::atoi(line.c_str()) : 0;
+        int core = detail::try_read_line(cpuPath + "/topology/core_id", line) ? std::atoi(line.c_str()) : id;
+        hardwareThreads.push_back({ .id = id, .core = core, .package = package, .numa_node = 0 });
+
+        for (int i = 0; ; ++i)
+        {
+            auto cachePath = cpuPath + "/cache/index" + std::to_string(i);
+            if (!detail::try_read_line(cachePath + "/level", line)) break;
+            int level = std::atoi(line.c_str());
+            auto type = cache_type::unified;
+            if (detail::try_read_line(cachePath + "/type", line))
+            {
+                if (line == "Data") type = cache_type::data;
+                else if (line == "Instruction") type = cache_type::instruction;
+            }
+            auto sharingIds = detail::try_read_line(cachePath + "/shared_cpu_list", line)
+                ? detail::parse_cpu_list(line)
+                : std::vector<int>{ id };
+
+                // Shared caches are listed for every hardware thread which uses them, but we want to record them only once.
+            bool known = std::any_of(
+                caches.begin(), caches.end(),
+                [&](cache_info const& cache)
+                {
+                    return cache.level == level && cache.type == type && cache.hardware_threads == sharingIds;
+                });
+            if (known) continue;
+
+            auto cache = cache_info{ .level = level, .type = type, .size = 0, .line_size = 0, .associativity = 0, .hardware_threads = std::move(sharingIds) };
+            if (detail::try_read_line(cachePath + "/size", line)) cache.size = detail::parse_cache_size(line);
+            if (detail::try_read_line(cachePath + "/coherency_line_size", line)) cache.line_size = detail::parse_cache_size(line);
+            if (detail::try_read_line(cachePath + "/ways_of_associativity", line)) cache.associativity = std::atoi(line.c_str());
+            caches.push_back(std::move(cache));
+        }
+    }
+
+        // Without NUMA support, all hardware threads are on node 0.
+    auto nodeRoot = std::string(sysfsRoot) + "/devices/system/node";
+    if (detail::try_read_line(nodeRoot + "/online", line))
+    {
+        for (int node : detail::parse_cpu_list(line))
+        {
+            if (!detail::try_read_line(nodeRoot + "/node" + std::to_string(node) + "/cpulist", line)) continue;
+            for (int id : detail::parse_cpu_list(line))
+            {
+                auto it = std::lower_bound(ids.begin(), ids.end(), id);
+                if (it != ids.end() && *it == id)
+                {
+                    hardwareThreads[it - ids.begin()].numa_node = node;
+                }
+            }
+        }
+    }
+
+    return cpu_topology(std::move(hardwareThreads), std::move(caches));
+}
+
+int
+cpu_topology::hardware_thread_index(int hardwareThreadId) const
+{
+    gsl_Expects(contains(hardwareThreadId));
+
+    return hardwareThreadIndices_[hardwareThreadId];
+}
+
+bool
+cpu_topology::contains(int hardwareThreadId) const noexcept
+{
+    return hardwareThreadId >= 0
+        && hardwareThreadId < gsl::narrow_failfast<int>(hardwareThreadIndices_.size())
+        && hardwareThreadIndices_[hardwareThreadId] >= 0;
+}
+
+hardware_thread_info const&
+cpu_topology::hardware_thread(int hardwareThreadId) const
+{
+    return hardwareThreads_[hardware_thread_index(hardwareThreadId)];
+}
+
+std::span<int const>
+cpu_topology::core_hardware_threads(int core) const
+{
+    gsl_Expects(core >= 0 && core < num_cores());
+
+    return coreHardwareThreads_[core];
+}
+
+std::span<int const>
+cpu_topology::package_hardware_threads(int package) const
+{
+    auto it = std::lower_bound(packages_.begin(), packages_.end(), package);
+    gsl_Expects(it != packages_.end() && *it == package);
+
+    return packageHardwareThreads_[it - packages_.begin()];
+}
+
+std::span<int const>
+cpu_topology::numa_node_hardware_threads(int numaNode) const
+{
+    auto it = std::lower_bound(numaNodes_.begin(), numaNodes_.end(), numaNode);
+    gsl_Expects(it != numaNodes_.end() && *it == numaNode);
+
+    return numaNodeHardwareThreads_[it - numaNodes_.begin()];
+}
+
+cache_info const*
+cpu_topology::cache(int hardwareThreadId, int level, cache_type type) const
+{
+    for (int i : hardwareThreadCaches_[hardware_thread_index(hardwareThreadId)])
+    {
+        auto const& cache = caches_[i];
+        if (cache.level == level && (cache.type == type || cache.type == cache_type::unified))
+        {
+            return &cache;
+        }
+    }
+    return nullptr;
+}
+
+cache_info const*
+cpu_topology::last_level_cache(int hardwareThreadId) const
+{
+    cache_info const* result = nullptr;
+    for (int i : hardwareThreadCaches_[hardware_thread_index(hardwareThreadId)])
+    {
+        auto const& cache = caches_[i];
+        if (cache.type != cache_type::instruction && (result == nullptr || cache.level > result->level))
+        {
+            result = &cache;
+        }
+    }
+    return result;
+}
+
+
+#if defined(_WIN32) && !defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
 std::size_t
 hardware_cache_line_size() noexcept
 {
@@ -262,7 +651,7 @@ hardware_cache_line_size() noexcept
     }
     return cacheLineSize;
 }
-#endif // defined(_WIN32)
+#endif // defined(_WIN32) && !defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
 
 unsigned
 physical_concurrency() noexcept
@@ -294,5 +683,33 @@ physical_core_ids() noexcept
 #endif // defined(_WIN32) || defined(__linux__)
 }
 
+int
+current_numa_node() noexcept
+{
+#if defined(_WIN32)
+    PROCESSOR_NUMBER processorNumber;
+    ::GetCurrentProcessorNumberEx(&processorNumber);
+    USHORT numaNode;
+    if (!::GetNumaProcessorNodeEx(&processorNumber, &numaNode))
+    {
+        return 0;
+    }
+    return numaNode;
+#elif defined(__linux__)
+        // Calls `getcpu()` through `syscall()` because the glibc wrapper was only added in glibc 2.29.
+    unsigned cpu;
+    unsigned numaNode;
+    if (::syscall(SYS_getcpu, &cpu, &numaNode, nullptr) != 0)
+    {
+        return 0;
+    }
+    return static_cast<int>(numaNode);
+#elif defined(__APPLE__)
+    return 0;
+#else
+# error Unsupported operating system.
+#endif
+}
+
 
 } // namespace patton
@@ -0,0 +1,370 @@
+
+#include <new>           // for bad_alloc
+#include <span>
+#include <cerrno>
+#include <vector>
+#include <cstdint>       // for uint32_t, uint64_t, uintmax_t, intptr_t
+#include <cstddef>       // for size_t, byte
+#include <cstring>       // for memcmp()
+#include <fstream>
+#include <algorithm>     // for min(), max()
+#include <filesystem>    // for path
+#include <system_error>
+
+#ifdef _WIN32
+# include <Windows.h>
+#else
+// assume POSIX
+# include <fcntl.h>     // for open(), fcntl()
+# include <unistd.h>    // for pread(), pwrite(), ftruncate(), fsync(), close()
+# include <sys/stat.h>  // for fstat()
+#endif
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects()
+
+#include <patton/new.hpp>  // for hardware_page_size()
+#include <patton/file_io.hpp>
+#include <patton/thread_squad.hpp>
+
+#include <patton/detail/errors.hpp>
+#include <patton/detail/arithmetic.hpp>  // for try_ceili()
+#include <patton/detail/transaction.hpp>
+
+
+namespace patton {
+
+namespace detail {
+
+
+constexpr std::size_t defaultExtentSize = 8*1024*1024;
+
+    // Reads `size` bytes at the given file offset, returning an error code on failure.
+#if defined(_WIN32)
+static DWORD
+read_at(std::intptr_t handle, std::byte* data, std::size_t size, std::uint64_t offset) noexcept
+{
+    while (size != 0)
+    {
+        DWORD numBytesToRead = DWORD(std::min(size, std::size_t(1) << 30));
+        OVERLAPPED overlapped = { };
+        overlapped.Offset = DWORD(offset & 0xFFFFFFFFu);
+        overlapped.OffsetHigh = DWORD(offset >> 32);
+        DWORD numBytesRead;
+        if (!::ReadFile(reinterpret_cast<HANDLE>(handle), data, numBytesToRead, &numBytesRead, &overlapped))
+        {
+            return ::GetLastError();
+        }
+        if (numBytesRead == 0)
+        {
+            return ERROR_HANDLE_EOF;  // the file was truncated
+        }
+        data += numBytesRead;
+        size -= numBytesRead;
+        offset += numBytesRead;
+    }
+    return 0;
+}
+#else // assume POSIX
+static int
+read_at(std::intptr_t handle, std::byte* data, std::size_t size, std::uint64_t offset) noexcept
+{
+    while (size != 0)
+    {
+        ssize_t numBytesRead = ::pread(int(handle), data, size, off_t(offset));
+        if (numBytesRead < 0)
+        {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        if (numBytesRead == 0)
+        {
+            return EIO;  // the file was truncated
+        }
+        data += numBytesRead;
+        size -= std::size_t(numBytesRead);
+        offset += std::uint64_t(numBytesRead);
+    }
+    return 0;
+}
+#endif
+
+    // Writes `size` bytes at the given file offset, returning an error code on failure.
+#if defined(_WIN32)
+static DWORD
+write_at(std::intptr_t handle, std::byte const* data, std::size_t size, std::uint64_t offset) noexcept
+{
+    while (size != 0)
+    {
+        DWORD numBytesToWrite = DWORD(std::min(size, std::size_t(1) << 30));
+        OVERLAPPED overlapped = { };
+        overlapped.Offset = DWORD(offset & 0xFFFFFFFFu);
+        overlapped.OffsetHigh = DWORD(offset >> 32);
+        DWORD numBytesWritten;
+        if (!::WriteFile(reinterpret_cast<HANDLE>(handle), data, numBytesToWrite, &numBytesWritten, &overlapped))
+        {
+            return ::GetLastError();
+        }
+        data += numBytesWritten;
+        size -= numBytesWritten;
+        offset += numBytesWritten;
+    }
+    return 0;
+}
+#else // assume POSIX
+static int
+write_at(std::intptr_t handle, std::byte const* data, std::size_t size, std::uint64_t offset) noexcept
+{
+    while (size != 0)
+    {
+        ssize_t numBytesWritten = ::pwrite(int(handle), data, size, off_t(offset));
+        if (numBytesWritten < 0)
+        {
+            if (errno == EINTR) continue;
+            return errno;
+        }
+        data += numBytesWritten;
+        size -= std::size_t(numBytesWritten);
+        offset += std::uint64_t(numBytesWritten);
+    }
+    return 0;
+}
+#endif
+
+    // Snapshot data is aligned to 64 KiB in the file so it can be mapped on systems with pages of up to 64 KiB, and on Windows,
+    // where the allocation granularity is 64 KiB.
+constexpr std::uint64_t minSnapshotDataOffset = 64*1024;
+
+void
+write_row_snapshot(thread_squad& squad, std::filesystem::path const& path, row_buffer_snapshot_header const& header,
+    std::byte const* data)
+{
+    auto fullHeader = header;
+    fullHeader.data_offset = std::max(detail::minSnapshotDataOffset, header.alignment);  // both are powers of 2
+    std::size_t dataSize = header.rows * header.row_stride;  // cannot overflow because the row buffer exists in memory
+    std::uint64_t fileSize = fullHeader.data_offset + dataSize;
+
+#if defined(_WIN32)
+    HANDLE hFile = ::CreateFileW(path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    detail::win32_assert(hFile != INVALID_HANDLE_VALUE);
+    auto closeFile = detail::make_transaction([hFile] { ::CloseHandle(hFile); });  // not committed: always closes the file
+    LARGE_INTEGER fileSizeL;
+    fileSizeL.QuadPart = LONGLONG(fileSize);
+    detail::win32_assert(::SetFilePointerEx(hFile, fileSizeL, NULL, FILE_BEGIN));
+    detail::win32_assert(::SetEndOfFile(hFile));
+    auto handle = reinterpret_cast<std::intptr_t>(hFile);
+    using error_code_type = DWORD;
+#else // assume POSIX
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    detail::posix_assert(fd >= 0);
+    auto closeFile = detail::make_transaction([fd] { ::close(fd); });  // not committed: always closes the file
+    detail::posix_assert(::ftruncate(fd, off_t(fileSize)) == 0);
+    std::intptr_t handle = fd;
+    using error_code_type = int;
+#endif
+
+    error_code_type headerEc = detail::write_at(handle, reinterpret_cast<std::byte const*>(&fullHeader), sizeof fullHeader, 0);
+#if defined(_WIN32)
+    detail::win32_check(headerEc);
+#else // assume POSIX
+    detail::posix_check(headerEc);
+#endif
+
+    if (dataSize != 0)
+    {
+        auto errors = std::vector<error_code_type>(static_cast<std::size_t>(squad.num_threads()));
+        squad.run([&](thread_squad::task_context& ctx)
+        {
+                // Rows are contiguous in memory, so every thread writes its rows with a single positional write.
+            auto [first, last] = ctx.partition(std::size_t(header.rows));
+            std::size_t begin = first*std::size_t(header.row_stride);
+            std::size_t end = last*std::size_t(header.row_stride);
+            errors[static_cast<std::size_t>(ctx.thread_index())] = detail::write_at(handle, data + begin, end - begin, fullHeader.data_offset + begin);
+        });
+        for (error_code_type ec : errors)
+        {
+#if defined(_WIN32)
+            detail::win32_check(ec);
+#else // assume POSIX
+            detail::posix_check(ec);
+#endif
+        }
+    }
+
+#if defined(_WIN32)
+    detail::win32_assert(::FlushFileBuffers(hFile));
+#else // assume POSIX
+    detail::posix_assert(::fsync(fd) == 0);
+#endif
+}
+
+
+} // namespace detail
+
+
+direct_input_file::direct_input_file(std::filesystem::path const& _path, params const& _params)
+    : handle_(-1), bufferedHandle_(-1), size_(0), extentSize_(0), direct_(false)
+{
+    auto extentSizeR = detail::try_ceili(_params.extent_size != 0 ? _params.extent_size : detail::defaultExtentSize, hardware_page_size());
+    if (extentSizeR.ec != std::errc{ })
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "extent size too large");
+    }
+    extentSize_ = extentSizeR.value;
+
+    auto transaction = detail::make_transaction(
+        [this]
+        {
+            close();
+        });
+#if defined(_WIN32)
+    HANDLE hFile = ::CreateFileW(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING, NULL);
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        direct_ = true;
+    }
+    else
+    {
+        hFile = ::CreateFileW(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        detail::win32_assert(hFile != INVALID_HANDLE_VALUE);
+    }
+    handle_ = reinterpret_cast<std::intptr_t>(hFile);
+    LARGE_INTEGER fileSize;
+    detail::win32_assert(::GetFileSizeEx(hFile, &fileSize));
+    size_ = std::uint64_t(fileSize.QuadPart);
+    if (direct_)
+    {
+        HANDLE hBufferedFile = ::CreateFileW(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        detail::win32_assert(hBufferedFile != INVALID_HANDLE_VALUE);
+        bufferedHandle_ = reinterpret_cast<std::intptr_t>(hBufferedFile);
+    }
+#else // assume POSIX
+# if defined(__linux__)
+    int fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+    if (fd >= 0)
+    {
+        direct_ = true;
+    }
+    else if (errno == EINVAL)  // the file system does not support `O_DIRECT`
+    {
+        fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    detail::posix_assert(fd >= 0);
+    handle_ = fd;
+# else // ^^^ defined(__linux__) ^^^ / vvv !defined(__linux__) vvv
+    int fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+    detail::posix_assert(fd >= 0);
+    handle_ = fd;
+#  if defined(F_NOCACHE)
+    direct_ = ::fcntl(fd, F_NOCACHE, 1) != -1;
+#  endif // defined(F_NOCACHE)
+# endif // defined(__linux__)
+    struct stat fileStat;
+    detail::posix_assert(::fstat(fd, &fileStat) == 0);
+    size_ = std::uint64_t(fileStat.st_size);
+    if (direct_)
+    {
+        int bufferedFd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+        detail::posix_assert(bufferedFd >= 0);
+        bufferedHandle_ = bufferedFd;
+    }
+#endif
+    transaction.commit();
+}
+
+void
+direct_input_file::close() noexcept
+{
+    for (std::intptr_t* handle : { &handle_, &bufferedHandle_ })
+    {
+        if (*handle != -1)
+        {
+#if defined(_WIN32)
+            ::CloseHandle(reinterpret_cast<HANDLE>(*handle));
+#else // assume POSIX
+            ::close(int(*handle));
+#endif
+            *handle = -1;
+        }
+    }
+}
+
+void
+direct_input_file::read(thread_squad& squad, std::span<std::byte> dest, std::uint64_t offset) const
+{
+    std::size_t pageSize = hardware_page_size();
+    gsl_Expects(reinterpret_cast<std::uintptr_t>(dest.data()) % pageSize == 0);
+    gsl_Expects(offset % pageSize == 0);
+    gsl_Expects(offset <= size_ && dest.size() <= size_ - offset);
+
+        // Direct I/O requires the file offset, the destination address, and the size of every read to be aligned to the logical
+        // block size of the device, which does not exceed the page size. Extents are page-aligned, and the unaligned tail of the
+        // byte range, if any, is read without direct I/O.
+    std::size_t size = dest.size();
+    std::size_t directSize = direct_ ? size / pageSize * pageSize : size;
+    std::size_t numExtents = size / extentSize_ + (size % extentSize_ != 0);
+
+#if defined(_WIN32)
+    using error_code_type = DWORD;
+#else // assume POSIX
+    using error_code_type = int;
+#endif
+    auto errors = std::vector<error_code_type>(static_cast<std::size_t>(squad.num_threads()));
+    squad.run([&](thread_squad::task_context& ctx)
+    {
+        auto [first, last] = ctx.partition(numExtents);
+        error_code_type ec = 0;
+        for (std::size_t i = first; i != last && ec == 0; ++i)
+        {
+            std::size_t extentBegin = i*extentSize_;
+            std::size_t extentEnd = std::min(extentBegin + extentSize_, size);
+            std::size_t directEnd = std::max(extentBegin, std::min(extentEnd, directSize));
+            ec = detail::read_at(handle_, dest.data() + extentBegin, directEnd - extentBegin, offset + extentBegin);
+            if (ec == 0 && directEnd != extentEnd)
+            {
+                ec = detail::read_at(bufferedHandle_, dest.data() + directEnd, extentEnd - directEnd, offset + directEnd);
+            }
+        }
+        errors[static_cast<std::size_t>(ctx.thread_index())] = ec;
+    });
+
+    for (error_code_type ec : errors)
+    {
+#if defined(_WIN32)
+        detail::win32_check(ec);
+#else // assume POSIX
+        detail::posix_check(ec);
+#endif
+    }
+}
+
+
+row_buffer_snapshot_header
+read_snapshot_header(std::filesystem::path const& path)
+{
+    std::uintmax_t fileSize = std::filesystem::file_size(path);  // throws `std::filesystem::filesystem_error` if the file does not exist
+    auto header = row_buffer_snapshot_header{ };
+    bool valid = fileSize >= sizeof header;
+    if (valid)
+    {
+        auto file = std::ifstream(path, std::ios::binary);
+        valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof header));
+    }
+    valid = valid
+        && std::memcmp(header.magic, "PATTONRB", sizeof header.magic) == 0
+        && header.version == 1
+        && header.data_offset >= sizeof header
+        && header.data_offset <= fileSize;
+    if (!valid)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "file is not a row buffer snapshot");
+    }
+    if (header.byte_order_mark != 0x01020304)
+    {
+        throw std::system_error(std::make_error_code(std::errc::not_supported), "snapshot was written on a machine with a different byte order");
+    }
+    return header;
+}
+
+
+} // namespace patton
@@ -0,0 +1,394 @@
+
+#include <new>           // for bad_alloc
+#include <cerrno>
+#include <limits>
+#include <atomic>
+#include <string>        // for to_string()
+#include <algorithm>     // for find()
+#include <cstdint>       // for uint64_t, uintptr_t
+#include <cstddef>       // for size_t
+#include <filesystem>    // for path
+#include <system_error>
+
+#ifdef _WIN32
+# include <Windows.h>
+#else
+// assume POSIX
+# include <fcntl.h>     // for open()
+# include <unistd.h>    // for close(), ftruncate(), getpid()
+# include <sys/mman.h>  // for mmap(), munmap(), madvise(), msync(), memfd_create(), shm_open(), shm_unlink()
+# include <sys/stat.h>  // for fstat()
+# if defined(__linux__) && !defined(MFD_HUGE_SHIFT)
+#  define MFD_HUGE_SHIFT 26
+# endif
+#endif
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects(), gsl_Assert()
+
+#include <patton/new.hpp>  // for hardware_page_size(), hardware_large_page_size(), hardware_large_page_sizes()
+#include <patton/mapped_buffer.hpp>
+
+#include <patton/detail/errors.hpp>
+#include <patton/detail/arithmetic.hpp>  // for try_ceili()
+#include <patton/detail/transaction.hpp>
+
+
+namespace patton {
+
+namespace detail {
+
+
+#if defined(_WIN32)
+static std::size_t
+query_allocation_granularity() noexcept
+{
+    SYSTEM_INFO sysInfo;
+    ::GetSystemInfo(&sysInfo);
+    return sysInfo.dwAllocationGranularity;
+}
+#elif defined(__linux__)
+    // Maps `mapSize` bytes of the given file at an address aligned to the large page size.
+static void*
+map_file_large_page_aligned(std::size_t mapSize, int prot, int flags, int fd, off_t offset)
+{
+    std::size_t largePageSize = hardware_large_page_size();
+    std::size_t reserveSize = mapSize + (largePageSize - hardware_page_size());
+    if (reserveSize < mapSize)
+    {
+        throw std::bad_alloc{ };
+    }
+
+        // Reserve an oversized range of address space, then map the file over its large-page-aligned part.
+    void* mem = ::mmap(NULL, reserveSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    detail::posix_assert(mem != MAP_FAILED);
+    auto memBegin = reinterpret_cast<std::uintptr_t>(mem);
+    auto dataBegin = (memBegin + (largePageSize - 1)) / largePageSize * largePageSize;
+    void* data = ::mmap(reinterpret_cast<void*>(dataBegin), mapSize, prot, flags | MAP_FIXED, fd, offset);
+    if (data == MAP_FAILED)
+    {
+        int ec = errno;
+        ::munmap(mem, reserveSize);
+        detail::posix_raise(ec);
+    }
+    if (dataBegin != memBegin)
+    {
+        detail::posix_assert(::munmap(mem, dataBegin - memBegin) == 0);
+    }
+    if (std::size_t tailSize = memBegin + reserveSize - (dataBegin + mapSize); tailSize != 0)
+    {
+        detail::posix_assert(::munmap(reinterpret_cast<void*>(dataBegin + mapSize), tailSize) == 0);
+    }
+    return data;
+}
+#endif
+
+    // Returns the number of bytes which can be mapped starting at the given offset into a file of the given size.
+static std::size_t
+mapped_size(std::uint64_t fileSize, std::size_t offset)
+{
+    if (offset > fileSize)
+    {
+        throw std::system_error(std::make_error_code(std::errc::invalid_argument), "offset exceeds file size");
+    }
+    if (fileSize - offset > std::uint64_t(std::numeric_limits<std::size_t>::max()))
+    {
+        throw std::bad_alloc{ };
+    }
+    return std::size_t(fileSize - offset);
+}
+
+#if defined(_WIN32)
+static void*
+map_section(HANDLE hSection, std::size_t offset, std::size_t size, file_access access)
+{
+    DWORD desiredAccess = access == file_access::shared ? FILE_MAP_WRITE
+        : access == file_access::copy_on_write ? FILE_MAP_COPY
+        : FILE_MAP_READ;
+    auto offset64 = std::uint64_t(offset);
+    void* data = ::MapViewOfFile(hSection, desiredAccess, DWORD(offset64 >> 32), DWORD(offset64 & 0xFFFFFFFFu), size);
+    detail::win32_assert(data != nullptr);
+    return data;
+}
+#else // assume POSIX
+static void*
+map_file_descriptor(int fd, std::size_t offset, std::size_t size, file_access access, [[maybe_unused]] map_advice advice,
+    std::size_t& mapSize)
+{
+    std::size_t pageSize = hardware_page_size();
+    mapSize = (size + (pageSize - 1)) / pageSize * pageSize;  // cannot overflow because `size` is at most `SIZE_MAX - offset`
+    int prot = access == file_access::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = access == file_access::copy_on_write ? MAP_PRIVATE
+        : MAP_SHARED;  // read-only mappings share the pages of the file system cache either way
+# if defined(__linux__)
+    if ((advice & map_advice::hugepage) != map_advice{ } && hardware_large_page_size() != 0)
+    {
+        return detail::map_file_large_page_aligned(mapSize, prot, flags, fd, off_t(offset));
+    }
+# endif // defined(__linux__)
+    void* data = ::mmap(NULL, mapSize, prot, flags, fd, off_t(offset));
+    detail::posix_assert(data != MAP_FAILED);
+    return data;
+}
+#endif
+
+
+} // namespace detail
+
+
+file_mapping::file_mapping(std::filesystem::path const& _path, std::size_t _offset, file_access _access, map_advice _advice)
+    : data_(nullptr), size_(0), mapSize_(0), access_(_access)
+{
+    gsl_Expects(_offset % offset_granularity() == 0);
+
+#if defined(_WIN32)
+    DWORD flagsAndAttributes = FILE_ATTRIBUTE_NORMAL;
+    if ((_advice & map_advice::sequential) != map_advice{ }) flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+    if ((_advice & map_advice::random) != map_advice{ }) flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS;
+    HANDLE hFile = ::CreateFileW(_path.c_str(),
+        _access == file_access::shared ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, flagsAndAttributes, NULL);
+    detail::win32_assert(hFile != INVALID_HANDLE_VALUE);
+    auto closeFile = detail::make_transaction([hFile] { ::CloseHandle(hFile); });  // not committed: the view keeps the file open
+
+    LARGE_INTEGER fileSize;
+    detail::win32_assert(::GetFileSizeEx(hFile, &fileSize));
+    std::size_t size = detail::mapped_size(std::uint64_t(fileSize.QuadPart), _offset);
+    if (size == 0)
+    {
+        return;  // empty files cannot be mapped
+    }
+
+    DWORD protect = _access == file_access::shared ? PAGE_READWRITE
+        : _access == file_access::copy_on_write ? PAGE_WRITECOPY
+        : PAGE_READONLY;
+    HANDLE hMapping = ::CreateFileMappingW(hFile, NULL, protect, 0, 0, NULL);
+    detail::win32_assert(hMapping != NULL);
+    auto closeMapping = detail::make_transaction([hMapping] { ::CloseHandle(hMapping); });  // not committed: the view keeps the mapping open
+
+    data_ = detail::map_section(hMapping, _offset, size, _access);
+    size_ = size;
+    mapSize_ = size;
+#else // assume POSIX
+    int fd = ::open(_path.c_str(), (_access == file_access::shared ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    detail::posix_assert(fd >= 0);
+    auto closeFile = detail::make_transaction([fd] { ::close(fd); });  // not committed: the mapping keeps the file open
+
+    struct stat fileStat;
+    detail::posix_assert(::fstat(fd, &fileStat) == 0);
+    std::size_t size = detail::mapped_size(std::uint64_t(fileStat.st_size), _offset);
+    if (size == 0)
+    {
+        return;  // empty files cannot be mapped
+    }
+
+    data_ = detail::map_file_descriptor(fd, _offset, size, _access, _advice, mapSize_);
+    size_ = size;
+#endif
+    advise(_advice);
+}
+
+void
+file_mapping::reset() noexcept
+{
+    if (data_ != nullptr)
+    {
+#if defined(_WIN32)
+        detail::win32_assert(::UnmapViewOfFile(data_));
+#else // assume POSIX
+        detail::posix_assert(::munmap(data_, mapSize_) == 0);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+        mapSize_ = 0;
+    }
+}
+
+std::size_t
+file_mapping::offset_granularity() noexcept
+{
+#if defined(_WIN32)
+    static std::size_t const allocationGranularity = detail::query_allocation_granularity();
+    return allocationGranularity;
+#else // assume POSIX
+    return hardware_page_size();
+#endif
+}
+
+void
+file_mapping::advise([[maybe_unused]] map_advice advice) const noexcept
+{
+    if (data_ == nullptr)
+    {
+        return;
+    }
+
+        // Advice is merely a hint, so we ignore failure.
+#if defined(_WIN32)
+    if ((advice & map_advice::willneed) != map_advice{ })
+    {
+        WIN32_MEMORY_RANGE_ENTRY range = { data_, size_ };
+        (void) ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+    }
+#else // assume POSIX
+    if ((advice & map_advice::sequential) != map_advice{ })
+    {
+        (void) ::madvise(data_, mapSize_, MADV_SEQUENTIAL);
+    }
+    if ((advice & map_advice::random) != map_advice{ })
+    {
+        (void) ::madvise(data_, mapSize_, MADV_RANDOM);
+    }
+    if ((advice & map_advice::willneed) != map_advice{ })
+    {
+        (void) ::madvise(data_, mapSize_, MADV_WILLNEED);
+    }
+# if defined(__linux__)
+    if ((advice & map_advice::hugepage) != map_advice{ })
+    {
+        (void) ::madvise(data_, mapSize_, MADV_HUGEPAGE);
+    }
+# endif // defined(__linux__)
+#endif
+}
+
+void
+file_mapping::flush() const
+{
+    if (data_ == nullptr || access_ != file_access::shared)
+    {
+        return;
+    }
+#if defined(_WIN32)
+    detail::win32_assert(::FlushViewOfFile(data_, size_));
+#else // assume POSIX
+    detail::posix_assert(::msync(data_, mapSize_, MS_SYNC) == 0);
+#endif
+}
+
+
+void
+shared_memory::close() noexcept
+{
+    if (handle_ != invalid_handle)
+    {
+#if defined(_WIN32)
+        detail::win32_assert(::CloseHandle(handle_));
+#else // assume POSIX
+        detail::posix_assert(::close(handle_) == 0);
+#endif
+        handle_ = invalid_handle;
+        size_ = 0;
+    }
+}
+
+shared_memory::shared_memory(std::size_t _size)
+    : handle_(invalid_handle), size_(0)
+{
+    gsl_Expects(_size > 0);
+
+#if defined(_WIN32)
+    auto size64 = std::uint64_t(_size);
+    handle_ = ::CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, DWORD(size64 >> 32), DWORD(size64 & 0xFFFFFFFFu), NULL);
+    detail::win32_assert(handle_ != NULL);
+#else // assume POSIX
+# if defined(__linux__)
+    int fd = ::memfd_create("patton", MFD_CLOEXEC);
+    detail::posix_assert(fd >= 0);
+# else
+        // Without `memfd_create()`, we create a uniquely named shared memory object and unlink it right away.
+    static std::atomic<unsigned> counter{ 0 };
+    std::string name = "/patton-" + std::to_string(::getpid()) + "-" + std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    detail::posix_assert(fd >= 0);
+    ::shm_unlink(name.c_str());
+# endif
+    auto closeFd = detail::make_transaction([fd] { ::close(fd); });
+    detail::posix_assert(::ftruncate(fd, off_t(_size)) == 0);
+    closeFd.commit();
+    handle_ = fd;
+#endif
+    size_ = _size;
+}
+
+shared_memory::shared_memory(std::size_t _size, [[maybe_unused]] std::size_t _pageSize)
+    : handle_(invalid_handle), size_(0)
+{
+    gsl_Expects(_size > 0);
+    auto pageSizes = hardware_large_page_sizes();
+    gsl_Expects(std::find(pageSizes.begin(), pageSizes.end(), _pageSize) != pageSizes.end());
+
+    auto fullSizeR = detail::try_ceili(_size, _pageSize);
+    if (fullSizeR.ec != std::errc{ })
+    {
+        throw std::bad_alloc{ };
+    }
+#if defined(__linux__)
+    int log2PageSize = 0;
+    while ((std::size_t(1) << log2PageSize) < _pageSize)
+    {
+        ++log2PageSize;
+    }
+    int fd = ::memfd_create("patton", MFD_CLOEXEC | MFD_HUGETLB | (unsigned(log2PageSize) << MFD_HUGE_SHIFT));
+    detail::posix_assert(fd >= 0);
+    auto closeFd = detail::make_transaction([fd] { ::close(fd); });
+    detail::posix_assert(::ftruncate(fd, off_t(fullSizeR.value)) == 0);
+    closeFd.commit();
+    handle_ = fd;
+#elif defined(_WIN32)
+    // TODO: should we do anything about the privileges here? (cf. `large_page_allocator<>`)
+    auto size64 = std::uint64_t(fullSizeR.value);
+    handle_ = ::CreateFileMappingW(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE | SEC_COMMIT | SEC_LARGE_PAGES, DWORD(size64 >> 32), DWORD(size64 & 0xFFFFFFFFu), NULL);
+    detail::win32_assert(handle_ != NULL);
+#else
+    throw std::system_error(std::make_error_code(std::errc::not_supported));
+#endif
+    size_ = fullSizeR.value;
+}
+
+shared_memory
+shared_memory::from_native_handle(native_handle_type handle)
+{
+    gsl_Expects(handle != invalid_handle);
+
+#if defined(_WIN32)
+    auto closeHandle = detail::make_transaction([handle] { ::CloseHandle(handle); });
+    void* view = ::MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    detail::win32_assert(view != nullptr);
+    MEMORY_BASIC_INFORMATION memInfo;
+    SIZE_T infoSize = ::VirtualQuery(view, &memInfo, sizeof memInfo);
+    ::UnmapViewOfFile(view);
+    detail::win32_assert(infoSize != 0);
+    closeHandle.commit();
+    return shared_memory(handle, memInfo.RegionSize);
+#else // assume POSIX
+    auto closeFd = detail::make_transaction([handle] { ::close(handle); });
+    struct stat fileStat;
+    detail::posix_assert(::fstat(handle, &fileStat) == 0);
+    std::size_t size = detail::mapped_size(std::uint64_t(fileStat.st_size), 0);
+    closeFd.commit();
+    return shared_memory(handle, size);
+#endif
+}
+
+file_mapping
+shared_memory::map(file_access access, map_advice advice) const
+{
+    if (size_ == 0)
+    {
+        return file_mapping{ };
+    }
+
+#if defined(_WIN32)
+    void* data = detail::map_section(handle_, 0, size_, access);
+    auto result = file_mapping(data, size_, size_, access);
+#else // assume POSIX
+    std::size_t mapSize;
+    void* data = detail::map_file_descriptor(handle_, 0, size_, access, advice, mapSize);
+    auto result = file_mapping(data, size_, mapSize, access);
+#endif
+    result.advise(advice);
+    return result;
+}
+
+
+} // namespace patton
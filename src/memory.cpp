@@ -1,24 +1,84 @@
 
 #include <new>          // for operator new, bad_alloc
+#include <bit>          // for bit_width()
 #include <cerrno>
+#include <span>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>      // for uint64_t, uintptr_t
 #include <cstddef>      // for size_t, align_val_t
-#include <algorithm>    // for min(), max()
+#include <cstdlib>      // for strtoull()
+#include <limits>
+#include <cstring>      // for memcpy()
+#include <iterator>     // for next(), size()
+#include <algorithm>    // for min(), max(), clamp(), find()
+#include <unordered_map>
 #include <system_error>
 
 #ifdef _WIN32
 # include <Windows.h>
+# include <Psapi.h>    // for QueryWorkingSetEx()
 #else
 // assume POSIX
-# include <sys/mman.h> // for mmap(), munmap(), madvise()
+# include <sys/mman.h> // for mmap(), mremap(), munmap(), mprotect(), madvise(), mlock(), munlock()
+# if defined(__linux__)
+#  include <fcntl.h>             // for open()
+#  include <unistd.h>            // for syscall(), pread(), close()
+#  include <sys/syscall.h>       // for SYS_mbind, SYS_move_pages
+#  include <linux/mempolicy.h>   // for MPOL_PREFERRED, MPOL_BIND, MPOL_INTERLEAVE
+#  include <linux/kernel-page-flags.h>  // for KPF_HUGE, KPF_THP
+#  ifndef MAP_HUGE_SHIFT
+#   define MAP_HUGE_SHIFT 26
+#  endif
+#  ifndef MADV_FREE
+#   define MADV_FREE 8             // Linux 4.5
+#  endif
+#  ifndef MADV_POPULATE_WRITE
+#   define MADV_POPULATE_WRITE 23  // Linux 5.14
+#  endif
+#  ifndef MADV_COLLAPSE
+#   define MADV_COLLAPSE 25        // Linux 6.1
+#  endif
+# endif // defined(__linux__)
 #endif
 
-#include <gsl-lite/gsl-lite.hpp>  // for gsl_Assert(), gsl_FailFast()
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects(), gsl_Assert(), gsl_FailFast()
 
 #include <patton/new.hpp>    // for hardware_large_page_size(), hardware_page_size(), hardware_cache_line_size()
 #include <patton/memory.hpp>
+#include <patton/topology.hpp>
 
 #include <patton/detail/arithmetic.hpp> // for try_ceili()
 #include <patton/detail/errors.hpp>
+#include <patton/detail/transaction.hpp>  // for make_transaction()
+
+
+    // Allocations obtained from the operating system are checked for out-of-bounds writes according to
+    // `PATTON_ALLOCATION_CHECKING`, which is usually set through the CMake cache variable of the same name:
+    //
+    //  - `PATTON_ALLOCATION_CHECKING_NONE` disables checking.
+    //  - `PATTON_ALLOCATION_CHECKING_TRAP` writes a known pattern of trap words to the memory just past the end of every
+    //    allocation and verifies it when the allocation is freed.
+    //  - `PATTON_ALLOCATION_CHECKING_GUARD` protects the pages past the end of every page-granular allocation, reusing the
+    //    rounding slack if it contains a whole page and mapping an additional guard page otherwise. Out-of-bounds writes then
+    //    fault immediately, except for writes to the unused remainder of the last page. Hugetlb allocations and large page
+    //    allocations on Windows cannot be protected at page granularity and fall back to trap words, as do the allocations of
+    //    `aligned_allocator_adaptor<>`.
+    //
+    // By default, trap words are used in debug builds, and allocations are not checked if `NDEBUG` is defined.
+#define PATTON_ALLOCATION_CHECKING_NONE  0
+#define PATTON_ALLOCATION_CHECKING_TRAP  1
+#define PATTON_ALLOCATION_CHECKING_GUARD 2
+#ifndef PATTON_ALLOCATION_CHECKING
+# ifdef NDEBUG
+#  define PATTON_ALLOCATION_CHECKING PATTON_ALLOCATION_CHECKING_NONE
+# else // ^^^ defined(NDEBUG) ^^^ / vvv !defined(NDEBUG) vvv
+#  define PATTON_ALLOCATION_CHECKING PATTON_ALLOCATION_CHECKING_TRAP
+# endif // defined(NDEBUG)
+#endif // !defined(PATTON_ALLOCATION_CHECKING)
 
 
 namespace patton::detail {
@@ -27,8 +87,9 @@ namespace patton::detail {
 constexpr std::size_t maxTrapCount = 4;
 constexpr std::uint32_t trapVal = 0xDEADBEEFu;
 void
-set_out_of_bounds_write_trap(void* data, std::size_t size, std::size_t allocSize) noexcept
+set_out_of_bounds_write_trap([[maybe_unused]] void* data, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t allocSize) noexcept
 {
+#if PATTON_ALLOCATION_CHECKING != PATTON_ALLOCATION_CHECKING_NONE
     std::uint32_t ltrapVal = trapVal;
 
         // Store known data pattern to just-out-of-bounds area.
@@ -37,10 +98,12 @@ set_out_of_bounds_write_trap(void* data, std::size_t size, std::size_t allocSize
     {
         std::memcpy(static_cast<char*>(data) + size + i*sizeof(std::uint32_t), &ltrapVal, sizeof(std::uint32_t));
     }
+#endif // PATTON_ALLOCATION_CHECKING != PATTON_ALLOCATION_CHECKING_NONE
 }
 [[nodiscard]] bool
-check_out_of_bounds_write_trap(void const* data, std::size_t size, std::size_t allocSize) noexcept
+check_out_of_bounds_write_trap([[maybe_unused]] void const* data, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::size_t allocSize) noexcept
 {
+#if PATTON_ALLOCATION_CHECKING != PATTON_ALLOCATION_CHECKING_NONE
         // Check known data pattern in just-out-of-bounds area to detect inadvertent tampering (poor man's ASan).
     std::size_t trapCount = std::min(maxTrapCount, (allocSize - size)/sizeof(std::uint32_t));
     for (std::size_t i = 0; i < trapCount; ++i)
@@ -52,22 +115,654 @@ check_out_of_bounds_write_trap(void const* data, std::size_t size, std::size_t a
             return false;  // an out-of-bounds write has damaged this allocation
         }
     }
+#endif // PATTON_ALLOCATION_CHECKING != PATTON_ALLOCATION_CHECKING_NONE
     return true;
 }
 
+    // Small aligned allocations are served from power-of-two-sized blocks. Blocks are carved out of slabs aligned to the largest
+    // block size, so every block is naturally aligned to its size, and an allocation can use the smallest block which is both
+    // large enough and sufficiently aligned. Because the block size depends only on size and alignment, which are passed to
+    // `aligned_free()` as well, blocks need no header.
+    //
+    // Every thread caches free blocks in per-size-class free lists. Blocks move between the thread caches and a central pool in
+    // batches, so most allocations and deallocations do not need to synchronize with other threads. Slabs are never returned
+    // to the operating system.
+constexpr std::size_t minBlockSize = 16;
+constexpr std::size_t maxBlockSize = 32*1024;
+constexpr int numBlockSizeClasses = 12;  // 16 B, 32 B, ..., 32 KiB
+constexpr std::size_t blockSlabSize = 256*1024;
+
+struct free_block
+{
+    free_block* next;
+};
+
+[[nodiscard]] static bool
+is_small_block_allocation(std::size_t size, std::size_t alignment) noexcept
+{
+    return size <= maxBlockSize && alignment <= maxBlockSize;
+}
+[[nodiscard]] static int
+block_size_class(std::size_t size, std::size_t alignment) noexcept
+{
+    std::size_t blockSize = std::max({ size, alignment, minBlockSize });
+    return std::bit_width(blockSize - 1) - std::bit_width(minBlockSize - 1);
+}
+[[nodiscard]] static constexpr std::size_t
+block_size(int sizeClass) noexcept
+{
+    return minBlockSize << sizeClass;
+}
+[[nodiscard]] static constexpr std::size_t
+block_batch_size(int sizeClass) noexcept
+{
+        // Transfer about 64 KiB per batch, but at least 2 and at most 64 blocks.
+    return std::clamp(std::size_t(64*1024) / block_size(sizeClass), std::size_t(2), std::size_t(64));
+}
+
+class central_block_pool
+{
+private:
+    struct block_list
+    {
+        std::mutex mutex;
+        free_block* head = nullptr;
+    };
+
+    block_list lists_[numBlockSizeClasses];
+
+public:
+        // Removes up to `maxCount` blocks from the central pool and returns them as a list. Allocates a new slab if the pool is
+        // empty.
+    free_block*
+    take_batch(int sizeClass, std::size_t maxCount, std::size_t& count)
+    {
+        auto& list = lists_[sizeClass];
+        auto lock = std::lock_guard(list.mutex);
+        if (list.head == nullptr)
+        {
+            std::size_t blockSize = detail::block_size(sizeClass);
+            auto slab = static_cast<char*>(::operator new(blockSlabSize, std::align_val_t(maxBlockSize)));
+            for (std::size_t offset = blockSlabSize; offset != 0; offset -= blockSize)
+            {
+                auto block = reinterpret_cast<free_block*>(slab + offset - blockSize);
+                block->next = list.head;
+                list.head = block;
+            }
+        }
+        free_block* head = list.head;
+        free_block* tail = head;
+        count = 1;
+        while (count < maxCount && tail->next != nullptr)
+        {
+            tail = tail->next;
+            ++count;
+        }
+        list.head = tail->next;
+        tail->next = nullptr;
+        return head;
+    }
+
+        // Returns the list of blocks from `head` to `tail` to the central pool.
+    void
+    put_batch(int sizeClass, free_block* head, free_block* tail) noexcept
+    {
+        auto& list = lists_[sizeClass];
+        auto lock = std::lock_guard(list.mutex);
+        tail->next = list.head;
+        list.head = head;
+    }
+};
+
+static central_block_pool&
+central_blocks()
+{
+        // Blocks may be freed during static destruction, so the pool must outlive all other static objects.
+    static central_block_pool* pool = new central_block_pool;
+    return *pool;
+}
+
+thread_local bool threadBlockCacheDestroyed = false;
+
+class thread_block_cache
+{
+private:
+    struct block_list
+    {
+        free_block* head = nullptr;
+        std::size_t count = 0;
+    };
+
+    block_list lists_[numBlockSizeClasses];
+
+public:
+    thread_block_cache() = default;
+    thread_block_cache(thread_block_cache const&) = delete;
+    thread_block_cache& operator =(thread_block_cache const&) = delete;
+
+    ~thread_block_cache()
+    {
+        for (int sizeClass = 0; sizeClass != numBlockSizeClasses; ++sizeClass)
+        {
+            auto& list = lists_[sizeClass];
+            if (list.head != nullptr)
+            {
+                free_block* tail = list.head;
+                while (tail->next != nullptr)
+                {
+                    tail = tail->next;
+                }
+                detail::central_blocks().put_batch(sizeClass, list.head, tail);
+            }
+        }
+        threadBlockCacheDestroyed = true;
+    }
+
+    void*
+    allocate(int sizeClass)
+    {
+        auto& list = lists_[sizeClass];
+        if (list.head == nullptr)
+        {
+            list.head = detail::central_blocks().take_batch(sizeClass, detail::block_batch_size(sizeClass), list.count);
+        }
+        free_block* block = list.head;
+        list.head = block->next;
+        --list.count;
+        return block;
+    }
+    void
+    deallocate(int sizeClass, void* data) noexcept
+    {
+        auto& list = lists_[sizeClass];
+        auto block = static_cast<free_block*>(data);
+        block->next = list.head;
+        list.head = block;
+        ++list.count;
+
+            // Keep at most two batches in the thread cache so that blocks freed by one thread can be reused by others.
+        std::size_t batchSize = detail::block_batch_size(sizeClass);
+        if (list.count > 2*batchSize)
+        {
+            free_block* head = list.head;
+            free_block* tail = head;
+            for (std::size_t i = 1; i != batchSize; ++i)
+            {
+                tail = tail->next;
+            }
+            list.head = tail->next;
+            list.count -= batchSize;
+            detail::central_blocks().put_batch(sizeClass, head, tail);
+        }
+    }
+};
+
+    // Returns `nullptr` if the thread cache has already been destroyed, which happens if blocks are allocated or freed by
+    // destructors of other thread-local objects.
+static thread_block_cache*
+local_block_cache() noexcept
+{
+    if (threadBlockCacheDestroyed)
+    {
+        return nullptr;
+    }
+    thread_local thread_block_cache cache;
+    return &cache;
+}
+
 void*
 aligned_alloc(std::size_t size, std::size_t alignment)
 {
-    return ::operator new(size, std::align_val_t(alignment));
+    if (!detail::is_small_block_allocation(size, alignment))
+    {
+        return ::operator new(size, std::align_val_t(alignment));
+    }
+    int sizeClass = detail::block_size_class(size, alignment);
+    if (auto cache = detail::local_block_cache())
+    {
+        return cache->allocate(sizeClass);
+    }
+    std::size_t count;
+    return detail::central_blocks().take_batch(sizeClass, 1, count);
 }
 void
 aligned_free(void* data, std::size_t size, std::size_t alignment) noexcept
 {
-    return ::operator delete(data, size, std::align_val_t(alignment));
+    if (!detail::is_small_block_allocation(size, alignment))
+    {
+        return ::operator delete(data, size, std::align_val_t(alignment));
+    }
+    int sizeClass = detail::block_size_class(size, alignment);
+    if (auto cache = detail::local_block_cache())
+    {
+        return cache->deallocate(sizeClass, data);
+    }
+    auto block = static_cast<free_block*>(data);
+    detail::central_blocks().put_batch(sizeClass, block, block);
+}
+
+enum class page_run_kind
+{
+    pages,
+    large_pages
+};
+
+    // Unmaps a page run which was obtained from `map_pages()` or `large_page_alloc()`.
+static void
+unmap_pages(void* data, std::size_t fullSize) noexcept
+{
+#if defined(_WIN32)
+    (void) fullSize;
+    detail::win32_assert(::VirtualFree(data, 0, MEM_RELEASE));
+#else // assume POSIX
+    detail::posix_assert(::munmap(data, fullSize) == 0);
+#endif
+}
+
+    // Faults in the pages of a page run.
+static void
+populate_pages(void* data, std::size_t fullSize) noexcept
+{
+#if defined(__linux__)
+        // `MADV_POPULATE_WRITE` is not supported before Linux 5.14, in which case we fault in the pages by hand.
+    if (::madvise(data, fullSize, MADV_POPULATE_WRITE) == 0)
+    {
+        return;
+    }
+#endif // defined(__linux__)
+    std::size_t pageSize = hardware_page_size();
+    for (std::size_t offset = 0; offset < fullSize; offset += pageSize)
+    {
+        static_cast<char volatile*>(data)[offset] = 0;
+    }
+}
+
+    // Applies the `populate` and `lock` flags to a page run. If the pages cannot be locked, the page run is unmapped and an
+    // exception is thrown.
+static void
+commit_pages(void* data, std::size_t fullSize, page_flags flags)
+{
+    if ((flags & page_flags::lock) != page_flags{ })
+    {
+            // Locking faults in all pages of the range.
+#if defined(_WIN32)
+        if (!::VirtualLock(data, fullSize))
+        {
+            DWORD ec = ::GetLastError();
+            detail::unmap_pages(data, fullSize);
+            detail::win32_raise(ec);
+        }
+#else // assume POSIX
+        if (::mlock(data, fullSize) != 0)
+        {
+            int ec = errno;
+            detail::unmap_pages(data, fullSize);
+            detail::posix_raise(ec);
+        }
+#endif
+    }
+    else if ((flags & page_flags::populate) != page_flags{ })
+    {
+        detail::populate_pages(data, fullSize);
+    }
+}
+
+    // Undoes the effect of the `lock` flag before a page run is cached.
+static void
+decommit_pages(void* data, std::size_t fullSize, page_flags flags) noexcept
+{
+    if ((flags & page_flags::lock) != page_flags{ })
+    {
+#if defined(_WIN32)
+        (void) ::VirtualUnlock(data, fullSize);
+#else // assume POSIX
+        (void) ::munlock(data, fullSize);
+#endif
+    }
+}
+
+    // Returns the size of the mapping needed for an allocation of `size` bytes which is rounded to `fullSize` bytes, including
+    // an additional guard page if necessary. Allocations which cannot be protected at page granularity are not `guardable`.
+[[nodiscard]] static std::size_t
+checked_map_size([[maybe_unused]] std::size_t size, std::size_t fullSize, [[maybe_unused]] bool guardable)
+{
+#if PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    if (guardable)
+    {
+        std::size_t pageSize = hardware_page_size();
+        std::size_t dataSize = (size + (pageSize - 1)) / pageSize * pageSize;  // cannot overflow because `fullSize` is larger
+        if (fullSize - dataSize < pageSize)
+        {
+            std::size_t mapSize = fullSize + pageSize;
+            if (mapSize < fullSize)
+            {
+                throw std::bad_alloc{ };
+            }
+            return mapSize;
+        }
+    }
+#endif // PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    return fullSize;
+}
+
+    // Sets up out-of-bounds write checking for an allocation of `size` bytes in a mapping of `mapSize` bytes.
+static void
+arm_allocation_check(void* data, std::size_t size, std::size_t mapSize, [[maybe_unused]] bool guardable) noexcept
+{
+#if PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    if (guardable)
+    {
+        std::size_t pageSize = hardware_page_size();
+        std::size_t dataSize = (size + (pageSize - 1)) / pageSize * pageSize;
+# if defined(_WIN32)
+        DWORD oldProtect;
+        detail::win32_assert(::VirtualProtect(static_cast<char*>(data) + dataSize, mapSize - dataSize, PAGE_NOACCESS, &oldProtect));
+# else // assume POSIX
+        detail::posix_assert(::mprotect(static_cast<char*>(data) + dataSize, mapSize - dataSize, PROT_NONE) == 0);
+# endif
+        return;
+    }
+#endif // PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    detail::set_out_of_bounds_write_trap(data, size, mapSize);
+}
+
+    // Verifies that an allocation has not been damaged by out-of-bounds writes, and removes guard pages so that the mapping can
+    // be reused or remapped.
+static void
+disarm_allocation_check(void* data, std::size_t size, std::size_t mapSize, [[maybe_unused]] bool guardable) noexcept
+{
+#if PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    if (guardable)
+    {
+        std::size_t pageSize = hardware_page_size();
+        std::size_t dataSize = (size + (pageSize - 1)) / pageSize * pageSize;
+# if defined(_WIN32)
+        DWORD oldProtect;
+        detail::win32_assert(::VirtualProtect(static_cast<char*>(data) + dataSize, mapSize - dataSize, PAGE_READWRITE, &oldProtect));
+# else // assume POSIX
+        detail::posix_assert(::mprotect(static_cast<char*>(data) + dataSize, mapSize - dataSize, PROT_READ | PROT_WRITE) == 0);
+# endif
+        return;
+    }
+#endif // PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+    if (!detail::check_out_of_bounds_write_trap(data, size, mapSize))
+    {
+        gsl_FailFast();  // an out-of-bounds write has damaged this allocation
+    }
+}
+
+    // Retains recently freed page runs for reuse by allocations of similar size, cf. `set_page_cache_capacity()`.
+class page_run_cache
+{
+private:
+    struct page_run
+    {
+        void* data;
+        std::size_t size;
+        page_run_kind kind;
+    };
+
+        // Bounds the cost of the linear search in `try_take()`.
+    static constexpr std::size_t max_num_runs = 64;
+
+        // A cached run is reused for a smaller allocation only if it is at most this many times as large; the excess pages
+        // are unmapped. Without this bound, a large run would be cut down to serve small allocations.
+    static constexpr std::size_t max_fit_ratio = 2;
+
+    std::atomic<std::size_t> capacity_ = 0;
+    std::mutex mutex_;
+    std::vector<page_run> runs_;  // ordered from least recently to most recently freed
+    std::size_t numBytes_ = 0;
+
+        // Removes the least recently freed runs until the cache fits the given capacity. Must be called with the mutex held.
+    void
+    evict(std::size_t capacity, std::vector<page_run>& evicted)
+    {
+        auto it = runs_.begin();
+        while (it != runs_.end() && (numBytes_ > capacity || std::size_t(runs_.end() - it) > max_num_runs))
+        {
+            numBytes_ -= it->size;
+            evicted.push_back(*it);
+            ++it;
+        }
+        runs_.erase(runs_.begin(), it);
+    }
+    static void
+    release(std::vector<page_run> const& runs) noexcept
+    {
+        for (auto const& run : runs)
+        {
+            detail::unmap_pages(run.data, run.size);
+        }
+    }
+
+public:
+    [[nodiscard]] std::size_t
+    capacity() const noexcept
+    {
+        return capacity_.load(std::memory_order_relaxed);
+    }
+    void
+    set_capacity(std::size_t capacity)
+    {
+        auto evicted = std::vector<page_run>{ };
+        {
+            auto lock = std::lock_guard(mutex_);
+            capacity_.store(capacity, std::memory_order_relaxed);
+            evict(capacity, evicted);
+        }
+        release(evicted);
+    }
+
+    void
+    trim()
+    {
+        auto evicted = std::vector<page_run>{ };
+        {
+            auto lock = std::lock_guard(mutex_);
+            evict(0, evicted);
+        }
+        release(evicted);
+    }
+
+    void*
+    try_take(page_run_kind kind, std::size_t size) noexcept
+    {
+        if (capacity() == 0) return nullptr;
+
+#if defined(_WIN32)
+        std::size_t maxSize = size;  // `VirtualFree()` cannot release part of an allocation
+#else // assume POSIX
+        std::size_t maxSize = size <= std::numeric_limits<std::size_t>::max()/max_fit_ratio ? size*max_fit_ratio : size;
+#endif
+
+            // Pick the smallest run that fits, preferring the most recently freed one among runs of equal size.
+        page_run run;
+        {
+            auto lock = std::lock_guard(mutex_);
+            auto best = runs_.rend();
+            for (auto it = runs_.rbegin(); it != runs_.rend(); ++it)
+            {
+                if (it->kind == kind && it->size >= size && it->size <= maxSize
+                    && (best == runs_.rend() || it->size < best->size))
+                {
+                    best = it;
+                    if (best->size == size) break;
+                }
+            }
+            if (best == runs_.rend()) return nullptr;
+
+            run = *best;
+            numBytes_ -= run.size;
+            runs_.erase(std::next(best).base());
+        }
+        if (run.size != size)
+        {
+            detail::unmap_pages(static_cast<char*>(run.data) + size, run.size - size);
+        }
+        return run.data;
+    }
+    bool
+    try_put(page_run_kind kind, void* data, std::size_t size)
+    {
+        std::size_t capacity = this->capacity();
+        if (size > capacity) return false;
+
+            // Let the operating system reclaim the pages under memory pressure. Until it does, the pages remain mapped, so
+            // reusing the run does not incur page faults.
+#if defined(_WIN32)
+        if (kind == page_run_kind::pages)  // large pages cannot be reset
+        {
+            (void) ::VirtualAlloc(data, size, MEM_RESET, PAGE_READWRITE);
+        }
+#else // assume POSIX
+        (void) ::madvise(data, size, MADV_FREE);  // not supported before Linux 4.5, in which case the pages are simply retained
+#endif
+
+        auto evicted = std::vector<page_run>{ };
+        {
+            auto lock = std::lock_guard(mutex_);
+            runs_.push_back({ data, size, kind });
+            numBytes_ += size;
+            evict(capacity, evicted);
+        }
+        release(evicted);
+        return true;
+    }
+};
+
+static page_run_cache&
+page_cache()
+{
+        // Allocations may be freed during static destruction, so the cache must outlive all other static objects.
+    static page_run_cache* cache = new page_run_cache;
+    return *cache;
+}
+
+#if defined(__linux__)
+    // Allocations from a hugetlb page pool are rounded to the size of their pages, which `large_page_free()` cannot infer from
+    // the allocation size, so we keep track of them. The counter lets us skip the lookup if there are no such allocations.
+struct hugetlb_allocation_registry
+{
+    std::mutex mutex;
+    std::unordered_map<std::uintptr_t, std::size_t> pageSizes;
+    std::atomic<std::size_t> numAllocations = 0;
+};
+static hugetlb_allocation_registry&
+hugetlb_allocations()
+{
+    static hugetlb_allocation_registry registry;
+    return registry;
+}
+
+    // Returns the page size of the given hugetlb allocation, or 0 if `data` was not allocated from a hugetlb page pool.
+static std::size_t
+hugetlb_page_size(void const* data, bool erase) noexcept
+{
+    auto& registry = detail::hugetlb_allocations();
+    if (registry.numAllocations.load(std::memory_order_acquire) == 0) return 0;
+    auto lock = std::lock_guard(registry.mutex);
+    auto it = registry.pageSizes.find(reinterpret_cast<std::uintptr_t>(data));
+    if (it == registry.pageSizes.end()) return 0;
+    std::size_t result = it->second;
+    if (erase)
+    {
+        registry.pageSizes.erase(it);
+        registry.numAllocations.fetch_sub(1, std::memory_order_release);
+    }
+    return result;
+}
+#endif // defined(__linux__)
+
+void*
+huge_page_alloc(std::size_t size, std::size_t pageSize, page_flags flags)
+{
+    auto pageSizes = hardware_large_page_sizes();
+    gsl_Expects(std::find(pageSizes.begin(), pageSizes.end(), pageSize) != pageSizes.end());
+
+#if defined(__linux__)
+    auto fullSizeR = detail::try_ceili(size, pageSize);
+    if (fullSizeR.ec != std::errc{ })
+    {
+        throw std::bad_alloc{ };
+    }
+    int log2PageSize = 0;
+    while ((std::size_t(1) << log2PageSize) < pageSize)
+    {
+        ++log2PageSize;
+    }
+    int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (log2PageSize << MAP_HUGE_SHIFT);
+    if ((flags & page_flags::populate) != page_flags{ })
+    {
+        mapFlags |= MAP_POPULATE;
+    }
+    void* data = ::mmap(NULL, fullSizeR.value, PROT_READ | PROT_WRITE, mapFlags, -1, 0);
+    if (data != MAP_FAILED)
+    {
+            // `MAP_POPULATE` has faulted in the pages already.
+        detail::commit_pages(data, fullSizeR.value, flags & page_flags::lock);
+        auto& registry = detail::hugetlb_allocations();
+        {
+            auto lock = std::lock_guard(registry.mutex);
+            registry.pageSizes.emplace(reinterpret_cast<std::uintptr_t>(data), pageSize);
+            registry.numAllocations.fetch_add(1, std::memory_order_release);
+        }
+        detail::arm_allocation_check(data, size, fullSizeR.value, false);
+        return data;
+    }
+
+        // The mapping fails with `ENOMEM` if the page pool does not have enough pages left, and with `EINVAL` if the kernel
+        // does not support the page size. In either case we fall back to transparent huge pages.
+    int ec = errno;
+    if (ec != ENOMEM && ec != EINVAL)
+    {
+        detail::posix_raise(ec);
+    }
+#elif defined(_WIN32)
+    (void) pageSize;  // Windows supports only a single large page size
+#endif
+    return detail::large_page_alloc(size, flags);
+}
+
+#if defined(__linux__)
+    // Maps a range aligned to the large page size and marks it for transparent huge pages.
+static void*
+map_large_pages(std::size_t fullSize, std::size_t largePageSize)
+{
+        // `mmap()` only guarantees page alignment, but only large-page-aligned ranges can be backed by transparent huge pages.
+        // We therefore map an oversized region and trim it to an aligned range of the requested size.
+    std::size_t mapSize = fullSize + (largePageSize - hardware_page_size());
+    if (mapSize < fullSize)
+    {
+        throw std::bad_alloc{ };
+    }
+    void* mem = ::mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    detail::posix_assert(mem != MAP_FAILED);
+    auto memBegin = reinterpret_cast<std::uintptr_t>(mem);
+    auto dataBegin = (memBegin + (largePageSize - 1)) / largePageSize * largePageSize;
+    if (dataBegin != memBegin)
+    {
+        detail::posix_assert(::munmap(mem, dataBegin - memBegin) == 0);
+    }
+    if (std::size_t tailSize = memBegin + mapSize - (dataBegin + fullSize); tailSize != 0)
+    {
+        detail::posix_assert(::munmap(reinterpret_cast<void*>(dataBegin + fullSize), tailSize) == 0);
+    }
+    void* data = reinterpret_cast<void*>(dataBegin);
+
+    int ec = ::madvise(data, fullSize, MADV_HUGEPAGE);
+    if (ec != 0)
+    {
+        ec = errno;
+        ::munmap(data, fullSize);
+        detail::posix_raise(ec);
+    }
+    return data;
 }
+#endif // defined(__linux__)
 
 void*
-large_page_alloc([[maybe_unused]] std::size_t size)
+large_page_alloc([[maybe_unused]] std::size_t size, [[maybe_unused]] page_flags flags)
 {
 #if defined(__linux__) || defined(_WIN32)
     std::size_t largePageSize = hardware_large_page_size();
@@ -79,22 +774,30 @@ large_page_alloc([[maybe_unused]] std::size_t size)
             throw std::bad_alloc{ };
         }
 # if defined(__linux__)
-        void* data = ::mmap(NULL, fullSizeR.value, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-        detail::posix_assert(data != nullptr);
-        int ec = ::madvise(data, fullSizeR.value, MADV_HUGEPAGE);
-        if (ec != 0)
+        std::size_t mapSize = detail::checked_map_size(size, fullSizeR.value, true);
+        void* data = detail::page_cache().try_take(page_run_kind::large_pages, mapSize);
+        if (data == nullptr)
         {
-            ec = errno;
-            ::munmap(data, fullSizeR.value);
-            detail::posix_raise(ec);
+            data = detail::map_large_pages(mapSize, largePageSize);
         }
-        detail::set_out_of_bounds_write_trap(data, size, fullSizeR.value);
+        detail::commit_pages(data, mapSize, flags);
+        if ((flags & page_flags::collapse) != page_flags{ })
+        {
+                // `MADV_COLLAPSE` is a best-effort request (and not supported before Linux 6.1), so we ignore failure.
+            (void) ::madvise(data, mapSize, MADV_COLLAPSE);
+        }
+        detail::arm_allocation_check(data, size, mapSize, true);
         return data;
 # elif defined(_WIN32)
+            // Large pages are always committed and non-pageable on Windows, so the flags have no effect.
         // TODO: should we do anything about the privileges here? (cf. https://docs.microsoft.com/en-us/windows/win32/memory/large-page-support, https://stackoverflow.com/a/42380052)
-        void* data = ::VirtualAlloc(NULL, fullSizeR.value, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
-        detail::win32_assert(data != nullptr);
-        detail::set_out_of_bounds_write_trap(data, size, fullSizeR.value);
+        void* data = detail::page_cache().try_take(page_run_kind::large_pages, fullSizeR.value);
+        if (data == nullptr)
+        {
+            data = ::VirtualAlloc(NULL, fullSizeR.value, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            detail::win32_assert(data != nullptr);
+        }
+        detail::arm_allocation_check(data, size, fullSizeR.value, false);  // large pages cannot be protected individually
         return data;
 # endif
     }
@@ -102,72 +805,313 @@ large_page_alloc([[maybe_unused]] std::size_t size)
     throw std::system_error(std::make_error_code(std::errc::not_supported));
 }
 void
-large_page_free([[maybe_unused]] void* data, [[maybe_unused]] std::size_t size) noexcept
+large_page_free([[maybe_unused]] void* data, [[maybe_unused]] std::size_t size, [[maybe_unused]] page_flags flags) noexcept
 {
 #if defined(__linux__) || defined(_WIN32)
-    auto allocSizeR = detail::try_ceili(size, hardware_large_page_size());
+    std::size_t pageSize = hardware_large_page_size();
+    bool isHugetlb = false;
+# if defined(__linux__)
+    if (std::size_t hugetlbPageSize = detail::hugetlb_page_size(data, true); hugetlbPageSize != 0)
+    {
+        pageSize = hugetlbPageSize;
+        isHugetlb = true;  // hugetlb pages are not cached because they are a reserved resource
+    }
+    bool guardable = !isHugetlb;
+# else // ^^^ defined(__linux__) ^^^ / vvv defined(_WIN32) vvv
+    bool guardable = false;
+# endif
+    auto allocSizeR = detail::try_ceili(size, pageSize);
     gsl_Assert(allocSizeR.ec == std::errc{ });
-    if (!detail::check_out_of_bounds_write_trap(data, size, allocSizeR.value))
+    std::size_t mapSize = detail::checked_map_size(size, allocSizeR.value, guardable);  // cannot overflow due to preceding check in `large_page_alloc()`
+    detail::disarm_allocation_check(data, size, mapSize, guardable);
+    if (isHugetlb)
     {
-        gsl_FailFast();  // an out-of-bounds write has damaged this allocation
+        detail::unmap_pages(data, mapSize);
+        return;
     }
 # if defined(__linux__)
-    detail::posix_assert(::munmap(data, size) == 0);
-# elif defined(_WIN32)
-    detail::win32_assert(::VirtualFree(data, 0, MEM_RELEASE));
-# endif
+    detail::decommit_pages(data, mapSize, flags);
+# endif // defined(__linux__)
+    if (!detail::page_cache().try_put(page_run_kind::large_pages, data, mapSize))
+    {
+        detail::unmap_pages(data, mapSize);
+    }
 #else // !(defined(__linux__) || defined(_WIN32))
     std::terminate(); // should never happen because `large_page_alloc()` would already have thrown
 #endif
 }
-
 void*
-page_alloc(std::size_t size)
+large_page_realloc(void* data, std::size_t oldSize, std::size_t newSize, page_flags flags)
 {
-    std::size_t pageSize = hardware_page_size();
-    gsl_Assert(pageSize != 0);
-    auto fullSizeR = detail::try_ceili(size, pageSize);
-    if (fullSizeR.ec != std::errc{ })
+    std::size_t hugetlbPageSize = 0;
+#if defined(__linux__)
+    hugetlbPageSize = detail::hugetlb_page_size(data, false);
+    if (std::size_t largePageSize = hardware_large_page_size(); largePageSize != 0 && hugetlbPageSize == 0)
     {
-        throw std::bad_alloc{ };
+        auto oldFullSizeR = detail::try_ceili(oldSize, largePageSize);
+        gsl_Assert(oldFullSizeR.ec == std::errc{ });
+        auto newFullSizeR = detail::try_ceili(newSize, largePageSize);
+        if (newFullSizeR.ec != std::errc{ })
+        {
+            throw std::bad_alloc{ };
+        }
+        std::size_t oldMapSize = detail::checked_map_size(oldSize, oldFullSizeR.value, true);
+        std::size_t newMapSize = detail::checked_map_size(newSize, newFullSizeR.value, true);
+        detail::disarm_allocation_check(data, oldSize, oldMapSize, true);
+
+            // Try to resize the mapping in place first. Otherwise, move it to a new large-page-aligned range. `mremap()` moves
+            // page table entries, so the data is not copied either way.
+        void* newData = ::mremap(data, oldMapSize, newMapSize, 0);
+        if (newData == MAP_FAILED)
+        {
+            auto transaction = detail::make_transaction(
+                [data, oldSize, oldMapSize]
+                {
+                    detail::arm_allocation_check(data, oldSize, oldMapSize, true);
+                });
+            void* target = detail::map_large_pages(newMapSize, largePageSize);
+            newData = ::mremap(data, oldMapSize, newMapSize, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (newData == MAP_FAILED)
+            {
+                int ec = errno;
+                ::munmap(target, newMapSize);
+                detail::posix_raise(ec);
+            }
+            transaction.commit();
+        }
+        if (newMapSize > oldMapSize && (flags & (page_flags::populate | page_flags::lock)) != page_flags{ })
+        {
+            detail::populate_pages(static_cast<char*>(newData) + oldMapSize, newMapSize - oldMapSize);
+        }
+        detail::arm_allocation_check(newData, newSize, newMapSize, true);
+        return newData;
     }
+#endif // defined(__linux__)
+
+        // Hugetlb mappings cannot be resized in general, so we allocate a new range and copy the data.
+    void* newData = hugetlbPageSize != 0
+        ? detail::huge_page_alloc(newSize, hugetlbPageSize, flags)
+        : detail::large_page_alloc(newSize, flags);
+    std::memcpy(newData, data, std::min(oldSize, newSize));
+    detail::large_page_free(data, oldSize, flags);
+    return newData;
+}
+
+    // Maps a new page run of the given size, bypassing the page cache.
+static void*
+map_pages(std::size_t fullSize)
+{
     void* data;
 #if defined(_WIN32)
-    data = ::VirtualAlloc(NULL, fullSizeR.value, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    data = ::VirtualAlloc(NULL, fullSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
     detail::win32_assert(data != nullptr);
 #else  // assume POSIX
-    data = ::mmap(NULL, fullSizeR.value, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    detail::posix_assert(data != nullptr);
+    data = ::mmap(NULL, fullSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    detail::posix_assert(data != MAP_FAILED);
 # if defined(__linux__)
-    int ec = ::madvise(data, fullSizeR.value, MADV_NOHUGEPAGE);
+    int ec = ::madvise(data, fullSize, MADV_NOHUGEPAGE);
     if (ec != 0)
     {
         ec = errno;
-        ::munmap(data, fullSizeR.value);
+        ::munmap(data, fullSize);
         detail::posix_raise(ec);
     }
 # endif // defined(__linux__)
 #endif
-    detail::set_out_of_bounds_write_trap(data, size, fullSizeR.value);
+    return data;
+}
+
+static std::size_t
+page_run_size(std::size_t size)
+{
+    std::size_t pageSize = hardware_page_size();
+    gsl_Assert(pageSize != 0);
+    auto fullSizeR = detail::try_ceili(size, pageSize);
+    if (fullSizeR.ec != std::errc{ })
+    {
+        throw std::bad_alloc{ };
+    }
+    return fullSizeR.value;
+}
+
+    // Returns the mapping size of an existing page-granular allocation.
+static std::size_t
+mapped_page_run_size(std::size_t size) noexcept
+{
+    auto fullSizeR = detail::try_ceili(size, hardware_page_size());
+    gsl_Assert(fullSizeR.ec == std::errc{ });
+    return detail::checked_map_size(size, fullSizeR.value, true);  // cannot overflow due to the check at allocation time
+}
+
+void*
+page_alloc(std::size_t size, page_flags flags)
+{
+    std::size_t mapSize = detail::checked_map_size(size, detail::page_run_size(size), true);
+    void* data = detail::page_cache().try_take(page_run_kind::pages, mapSize);
+    if (data == nullptr)
+    {
+        data = detail::map_pages(mapSize);
+    }
+    detail::commit_pages(data, mapSize, flags);
+    detail::arm_allocation_check(data, size, mapSize, true);
     return data;
 }
 void
-page_free(void* data, std::size_t size) noexcept
+page_free(void* data, std::size_t size, page_flags flags) noexcept
 {
-    auto allocSizeR = detail::try_ceili(size, hardware_page_size());
-    gsl_Assert(allocSizeR.ec == std::errc{ });
-    if (!detail::check_out_of_bounds_write_trap(data, size, allocSizeR.value))
+    std::size_t mapSize = detail::mapped_page_run_size(size);
+    detail::disarm_allocation_check(data, size, mapSize, true);
+    detail::decommit_pages(data, mapSize, flags);
+    if (!detail::page_cache().try_put(page_run_kind::pages, data, mapSize))
     {
-        gsl_FailFast();  // an out-of-bounds write has damaged this allocation
+        detail::unmap_pages(data, mapSize);
     }
+}
+void*
+page_realloc(void* data, std::size_t oldSize, std::size_t newSize, page_flags flags)
+{
+#if defined(__linux__)
+    std::size_t oldMapSize = detail::mapped_page_run_size(oldSize);
+    std::size_t newMapSize = detail::checked_map_size(newSize, detail::page_run_size(newSize), true);
+    detail::disarm_allocation_check(data, oldSize, oldMapSize, true);
+
+        // `mremap()` resizes the mapping in place if possible and moves its page table entries otherwise, so the data is not
+        // copied either way. The mapping retains its `MADV_NOHUGEPAGE` advice and, if applicable, its memory lock.
+    void* newData = ::mremap(data, oldMapSize, newMapSize, MREMAP_MAYMOVE);
+    if (newData == MAP_FAILED)
+    {
+        int ec = errno;
+        detail::arm_allocation_check(data, oldSize, oldMapSize, true);
+        detail::posix_raise(ec);
+    }
+    if (newMapSize > oldMapSize && (flags & page_flags::populate) != page_flags{ })
+    {
+        detail::populate_pages(static_cast<char*>(newData) + oldMapSize, newMapSize - oldMapSize);
+    }
+    detail::arm_allocation_check(newData, newSize, newMapSize, true);
+    return newData;
+#else // !defined(__linux__)
+    void* newData = detail::page_alloc(newSize, flags);
+    std::memcpy(newData, data, std::min(oldSize, newSize));
+    detail::page_free(data, oldSize, flags);
+    return newData;
+#endif // defined(__linux__)
+}
+
+#if defined(__linux__)
+    // Calls `mbind()` through `syscall()` to avoid a dependency on libnuma. The node mask is sized to hold the highest node id
+    // given; an empty list of nodes is passed as an empty mask.
+static long
+mbind(void* data, std::size_t size, int mode, std::span<int const> numaNodes)
+{
+    constexpr std::size_t bitsPerWord = sizeof(unsigned long)*8;  // bits per byte
+    auto nodeMaskWords = std::vector<unsigned long>{ };
+    for (int numaNode : numaNodes)
+    {
+        std::size_t i = std::size_t(numaNode);
+        if (i/bitsPerWord >= nodeMaskWords.size())
+        {
+            nodeMaskWords.resize(i/bitsPerWord + 1);
+        }
+        nodeMaskWords[i/bitsPerWord] |= 1ul << (i % bitsPerWord);
+    }
+        // The kernel ignores the last bit of `maxnode`.
+    return ::syscall(SYS_mbind, data, size, mode, nodeMaskWords.data(), nodeMaskWords.size()*bitsPerWord + 1, 0);
+}
+#endif // defined(__linux__)
+
+static void*
+numa_alloc_on_nodes(std::size_t size, numa_policy policy, std::span<int const> numaNodes)
+{
+        // NUMA allocations bypass the page cache because cached page runs have been placed already.
+    std::size_t mapSize = detail::checked_map_size(size, detail::page_run_size(size), true);
 #if defined(_WIN32)
-    detail::win32_assert(::VirtualFree(data, 0, MEM_RELEASE));
-#else // assume POSIX
-    detail::posix_assert(::munmap(data, size) == 0);
+        // Windows supports only a preferred node per allocation, so we use the first node given.
+    void* data;
+    if (policy == numa_policy::interleave || numaNodes.empty())
+    {
+        data = detail::map_pages(mapSize);
+    }
+    else
+    {
+        data = ::VirtualAllocExNuma(::GetCurrentProcess(), NULL, mapSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, DWORD(numaNodes.front()));
+        detail::win32_assert(data != nullptr);
+    }
+    detail::arm_allocation_check(data, size, mapSize, true);
+    return data;
+#elif defined(__linux__)
+        // The pages have not been touched yet, so setting the memory policy now determines where they will be placed.
+    void* data = detail::map_pages(mapSize);
+    int mode = MPOL_PREFERRED;
+    switch (policy)
+    {
+    case numa_policy::preferred:
+        mode = MPOL_PREFERRED;  // an empty node mask indicates local allocation
+        break;
+    case numa_policy::bind:
+        mode = MPOL_BIND;
+        break;
+    case numa_policy::interleave:
+        mode = MPOL_INTERLEAVE;
+        break;
+    }
+    if (numaNodes.empty() && policy != numa_policy::preferred)
+    {
+        numaNodes = cpu_topology::system().numa_nodes();
+    }
+    if (detail::mbind(data, mapSize, mode, numaNodes) != 0)
+    {
+            // `ENOSYS` indicates that the kernel was built without NUMA support, in which case there is only one node anyway.
+            // Otherwise, failure is fatal only for the `bind` policy, which is a guarantee rather than a hint.
+        int ec = errno;
+        if (policy == numa_policy::bind && ec != ENOSYS)
+        {
+            detail::unmap_pages(data, mapSize);
+            detail::posix_raise(ec);
+        }
+    }
+    detail::arm_allocation_check(data, size, mapSize, true);
+    return data;
+#else
+    (void) policy;
+    (void) numaNodes;
+    void* data = detail::map_pages(mapSize);
+    detail::arm_allocation_check(data, size, mapSize, true);
+    return data;
 #endif
 }
 
+void*
+numa_alloc(std::size_t size, numa_policy policy, std::uint64_t nodeMask)
+{
+    auto numaNodes = std::vector<int>{ };
+    for (int numaNode = 0; numaNode != 64; ++numaNode)
+    {
+        if ((nodeMask & (std::uint64_t(1) << numaNode)) != 0)
+        {
+            numaNodes.push_back(numaNode);
+        }
+    }
+    return detail::numa_alloc_on_nodes(size, policy, numaNodes);
+}
+void
+numa_free(void* data, std::size_t size) noexcept
+{
+    std::size_t mapSize = detail::mapped_page_run_size(size);
+    detail::disarm_allocation_check(data, size, mapSize, true);
+    detail::unmap_pages(data, mapSize);
+}
 
+void*
+numa_page_alloc(std::size_t size, int numaNode)
+{
+    gsl_Expects(numaNode >= 0);
+
+    return detail::numa_alloc_on_nodes(size, numa_policy::preferred, std::span(&numaNode, 1));
+}
+
+
+#if !defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
 std::size_t
 lookup_special_alignments(std::size_t a) noexcept
 {
@@ -195,6 +1139,216 @@ alignment_in_bytes(std::size_t a) noexcept
 {
     return std::max(std::size_t(1), floor_2p(lookup_special_alignments(a)));
 }
+#endif // !defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
 
 
 } // namespace patton::detail
+
+namespace patton {
+
+
+std::vector<int>
+page_numa_nodes(void const* data, std::size_t size)
+{
+    std::size_t pageSize = hardware_page_size();
+    auto first = reinterpret_cast<std::uintptr_t>(data) / pageSize * pageSize;
+    auto last = reinterpret_cast<std::uintptr_t>(data) + size;
+    std::size_t numPages = size != 0 ? (last - first + pageSize - 1) / pageSize : 0;
+    auto result = std::vector<int>(numPages, -1);
+    if (numPages == 0) return result;
+
+#if defined(_WIN32)
+    auto info = std::vector<PSAPI_WORKING_SET_EX_INFORMATION>(numPages);
+    for (std::size_t i = 0; i < numPages; ++i)
+    {
+        info[i].VirtualAddress = reinterpret_cast<void*>(first + i*pageSize);
+    }
+    detail::win32_assert(::QueryWorkingSetEx(::GetCurrentProcess(), info.data(), DWORD(numPages*sizeof(PSAPI_WORKING_SET_EX_INFORMATION))));
+    for (std::size_t i = 0; i < numPages; ++i)
+    {
+        if (info[i].VirtualAttributes.Valid)
+        {
+            result[i] = int(info[i].VirtualAttributes.Node);
+        }
+    }
+#elif defined(__linux__)
+        // `move_pages()` without target nodes only reports the node of every page, or a negative error code, e.g. `-ENOENT` if
+        // the page has not been touched yet.
+    auto pages = std::vector<void*>(numPages);
+    for (std::size_t i = 0; i < numPages; ++i)
+    {
+        pages[i] = reinterpret_cast<void*>(first + i*pageSize);
+    }
+    if (::syscall(SYS_move_pages, 0, numPages, pages.data(), nullptr, result.data(), 0) != 0)
+    {
+        int ec = errno;
+        if (ec != ENOSYS)
+        {
+            detail::posix_raise(ec);
+        }
+        std::fill(result.begin(), result.end(), 0);  // without NUMA support, there is only one node
+    }
+    for (int& node : result)
+    {
+        if (node < 0) node = -1;
+    }
+#endif
+    return result;
+}
+
+void
+set_page_cache_capacity(std::size_t bytes)
+{
+    detail::page_cache().set_capacity(bytes);
+}
+
+std::size_t
+page_cache_capacity() noexcept
+{
+    return detail::page_cache().capacity();
+}
+
+void
+trim_page_cache()
+{
+    detail::page_cache().trim();
+}
+
+std::size_t
+large_page_allocation_page_size([[maybe_unused]] void const* data) noexcept
+{
+#if defined(__linux__)
+        // Allocations which were not served from a hugetlb page pool rely on transparent huge pages, which the kernel may or may
+        // not have provided.
+    return detail::hugetlb_page_size(data, false);
+#else // !defined(__linux__)
+    return hardware_large_page_size();
+#endif // defined(__linux__)
+}
+
+#if defined(__linux__)
+    // Determines exactly which pages of the range `[first, last)` are part of a transparent huge page or a hugetlb page by
+    // looking up their page frames in `/proc/self/pagemap` and the flags of the frames in `/proc/kpageflags`. Returns `false` if
+    // the page frames cannot be determined, which is the case for processes without the `CAP_SYS_ADMIN` capability.
+static bool
+try_get_large_page_backed_size(std::uintptr_t first, std::uintptr_t last, std::size_t& result)
+{
+    int pagemapFd = ::open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (pagemapFd < 0) return false;
+    auto closePagemap = detail::make_transaction([pagemapFd] { ::close(pagemapFd); });  // not committed: always closes the file
+    int kpageflagsFd = ::open("/proc/kpageflags", O_RDONLY | O_CLOEXEC);
+    if (kpageflagsFd < 0) return false;
+    auto closeKpageflags = detail::make_transaction([kpageflagsFd] { ::close(kpageflagsFd); });  // not committed: always closes the file
+
+    constexpr std::uint64_t pagePresent = std::uint64_t(1) << 63;
+    constexpr std::uint64_t pageFrameMask = (std::uint64_t(1) << 55) - 1;
+    constexpr std::uint64_t largePageFlags = (std::uint64_t(1) << KPF_HUGE) | (std::uint64_t(1) << KPF_THP);
+
+    std::size_t pageSize = hardware_page_size();
+    std::uintptr_t firstPage = first/pageSize;
+    std::uintptr_t lastPage = (last + pageSize - 1)/pageSize;
+    std::uint64_t entries[512];
+    std::size_t lresult = 0;
+    for (std::uintptr_t chunk = firstPage; chunk < lastPage; chunk += std::size(entries))
+    {
+        std::size_t numEntries = std::min<std::size_t>(std::size(entries), lastPage - chunk);
+        if (::pread(pagemapFd, entries, numEntries*sizeof(std::uint64_t), off_t(chunk*sizeof(std::uint64_t))) != ssize_t(numEntries*sizeof(std::uint64_t)))
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i != numEntries; ++i)
+        {
+            if ((entries[i] & pagePresent) == 0) continue;
+            std::uint64_t pageFrame = entries[i] & pageFrameMask;
+            if (pageFrame == 0) return false;  // page frames are hidden from unprivileged processes
+
+            std::uint64_t flags;
+            if (::pread(kpageflagsFd, &flags, sizeof flags, off_t(pageFrame*sizeof flags)) != ssize_t(sizeof flags))
+            {
+                return false;
+            }
+            if ((flags & largePageFlags) != 0)
+            {
+                std::uintptr_t pageBegin = (chunk + i)*pageSize;
+                lresult += std::min(last, pageBegin + pageSize) - std::max(first, pageBegin);
+            }
+        }
+    }
+    result = lresult;
+    return true;
+}
+#endif // defined(__linux__)
+
+std::size_t
+large_page_backed_size(void const* data, std::size_t size)
+{
+    if (size == 0) return 0;
+
+#if defined(_WIN32)
+    std::size_t largePageSize = hardware_large_page_size();
+    if (largePageSize == 0) return 0;
+    auto first = reinterpret_cast<std::uintptr_t>(data) / largePageSize * largePageSize;
+    auto last = reinterpret_cast<std::uintptr_t>(data) + size;
+    std::size_t result = 0;
+    for (auto pos = first; pos < last; pos += largePageSize)
+    {
+        auto info = PSAPI_WORKING_SET_EX_INFORMATION{ };
+        info.VirtualAddress = reinterpret_cast<void*>(pos);
+        detail::win32_assert(::QueryWorkingSetEx(::GetCurrentProcess(), &info, sizeof info));
+        if (info.VirtualAttributes.Valid && info.VirtualAttributes.LargePage)
+        {
+            result += std::min(last, pos + largePageSize) - std::max(pos, reinterpret_cast<std::uintptr_t>(data));
+        }
+    }
+    return result;
+#elif defined(__linux__)
+    auto first = reinterpret_cast<std::uintptr_t>(data);
+    auto last = first + size;
+    std::size_t exactResult;
+    if (try_get_large_page_backed_size(first, last, exactResult))
+    {
+        return exactResult;
+    }
+
+        // Without access to the page frames, we fall back to smaps. It reports huge page usage per mapping, so we can only
+        // attribute it to the given range if the range covers the mapping. For mappings which extend beyond the range, we cap the
+        // huge page usage at the size of the overlap, which may overestimate the large page backing of the range.
+    auto smaps = std::ifstream("/proc/self/smaps");
+    if (!smaps)
+    {
+        detail::posix_raise(errno);
+    }
+    std::size_t result = 0;
+    std::size_t overlap = 0;
+    std::size_t mappingLargePageBytes = 0;
+    std::string line;
+    while (std::getline(smaps, line))
+    {
+        char* end;
+        unsigned long long mappingBegin = std::strtoull(line.c_str(), &end, 16);
+        if (*end == '-')
+        {
+                // New mapping header, e.g. "7f5c8c000000-7f5c8c200000 rw-p 00000000 00:00 0".
+            result += std::min(overlap, mappingLargePageBytes);
+            unsigned long long mappingEnd = std::strtoull(end + 1, &end, 16);
+            overlap = mappingBegin < last && first < mappingEnd
+                ? std::min<std::uintptr_t>(last, mappingEnd) - std::max<std::uintptr_t>(first, mappingBegin)
+                : 0;
+            mappingLargePageBytes = 0;
+        }
+        else if (overlap != 0
+            && (line.starts_with("AnonHugePages:") || line.starts_with("Shared_Hugetlb:") || line.starts_with("Private_Hugetlb:")))
+        {
+            mappingLargePageBytes += std::strtoull(line.c_str() + line.find(':') + 1, nullptr, 10) * 1024;  // values are given in kB
+        }
+    }
+    result += std::min(overlap, mappingLargePageBytes);
+    return result;
+#else
+    (void) data;
+    return 0;
+#endif
+}
+
+
+} // namespace patton
@@ -0,0 +1,105 @@
+
+#include <new>          // for bad_alloc
+#include <memory>       // for align()
+#include <cstddef>      // for size_t
+#include <system_error>
+
+#include <gsl-lite/gsl-lite.hpp>  // for gsl_Expects(), gsl_Assert()
+
+#include <patton/new.hpp>  // for hardware_large_page_size()
+#include <patton/memory.hpp>
+#include <patton/memory_resource.hpp>
+
+#include <patton/detail/arithmetic.hpp>  // for try_ceili()
+
+
+namespace patton {
+
+
+large_page_arena_resource::large_page_arena_resource(std::size_t _chunkSize, page_flags _flags)
+    : chunkSize_(_chunkSize), flags_(_flags), current_(nullptr), remaining_(0)
+{
+    std::size_t largePageSize = hardware_large_page_size();
+    if (largePageSize == 0)
+    {
+        throw std::system_error(std::make_error_code(std::errc::not_supported));
+    }
+    if (chunkSize_ == 0)
+    {
+        chunkSize_ = largePageSize;
+    }
+    auto chunkSizeR = detail::try_ceili(chunkSize_, largePageSize);
+    if (chunkSizeR.ec != std::errc{ })
+    {
+        throw std::bad_alloc{ };
+    }
+    chunkSize_ = chunkSizeR.value;
+}
+
+large_page_arena_resource::~large_page_arena_resource()
+{
+    release();
+}
+
+void*
+large_page_arena_resource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t largePageSize = hardware_large_page_size();
+    gsl_Expects(alignment <= largePageSize);
+
+    if (void* result = std::align(alignment, bytes, current_, remaining_))
+    {
+        current_ = static_cast<char*>(current_) + bytes;
+        remaining_ -= bytes;
+        return result;
+    }
+
+        // Chunks are aligned to the large page size, so the first allocation in a chunk is always suitably aligned.
+    std::size_t size = chunkSize_;
+    if (bytes > chunkSize_)
+    {
+        auto sizeR = detail::try_ceili(bytes, largePageSize);
+        if (sizeR.ec != std::errc{ })
+        {
+            throw std::bad_alloc{ };
+        }
+        size = sizeR.value;
+    }
+    chunks_.reserve(chunks_.size() + 1);
+    void* data = detail::large_page_alloc(size, flags_);
+    chunks_.push_back({ data, size });
+
+        // Keep allocating from the current chunk if the new chunk has less space left.
+    if (size - bytes > remaining_)
+    {
+        current_ = static_cast<char*>(data) + bytes;
+        remaining_ = size - bytes;
+    }
+    return data;
+}
+
+void
+large_page_arena_resource::release() noexcept
+{
+    for (auto const& chunk : chunks_)
+    {
+        detail::large_page_free(chunk.data, chunk.size, flags_);
+    }
+    chunks_.clear();
+    current_ = nullptr;
+    remaining_ = 0;
+}
+
+std::size_t
+large_page_arena_resource::reserved_size() const noexcept
+{
+    std::size_t result = 0;
+    for (auto const& chunk : chunks_)
+    {
+        result += chunk.size;
+    }
+    return result;
+}
+
+
+} // namespace patton
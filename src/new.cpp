@@ -4,16 +4,23 @@
 #include <cstdlib>    // for sscanf()
 #include <cstddef>    // for size_t
 #include <cstring>    // for strcmp()
+#include <span>
 #include <string>
+#include <vector>
 #include <fstream>
+#include <algorithm>  // for sort()
+#include <filesystem>
+#include <system_error>
 #include <iostream>
 #include <stdexcept>  // for runtime_error
 
-#include <gsl-lite/gsl-lite.hpp>  // for narrow<>(), gsl_FailFast()
+#include <gsl-lite/gsl-lite.hpp>  // for narrow<>(), narrow_failfast<>(), gsl_Expects(), gsl_FailFast()
 
 #include <patton/new.hpp>
 #include <patton/memory.hpp>
+#include <patton/topology.hpp>
 
+#include <patton/detail/new.hpp>
 #include <patton/detail/errors.hpp>
 #include <patton/detail/lazy-init.hpp>
 
@@ -35,123 +42,301 @@
 #endif
 
 
+namespace patton::detail {
+
+
+std::size_t
+query_hardware_large_page_size()
+{
+    std::size_t result;
+#if defined(_WIN32)
+    result = GetLargePageMinimum();
+#elif defined(__linux__)
+        // I can't believe that parsing /proc/meminfo is the accepted way to query the default hugepage size and other
+        // parameters.
+    auto f = std::ifstream("/proc/meminfo");
+    if (!f) throw std::runtime_error("cannot open /proc/meminfo");  // something is really wrong if we cannot open that file
+    auto line = std::string{ };
+    result = 0;  // indicating that no "Hugepagesize" entry was found
+    while (std::getline(f, line))
+    {
+        long hugePageSize = 0;
+        char unit[16+1];
+        int nFields = std::sscanf(line.c_str(), "Hugepagesize : %ld %16s", &hugePageSize, unit);
+        if (nFields == 2)
+        {
+                // This is the only unit the kernel currently emits, so I don't bother with speculative M[i]B etc.
+            if (std::strcmp(unit, "kB") == 0)
+            {
+                hugePageSize *= 1024l;
+                result = gsl::narrow<std::size_t>(hugePageSize);
+                break;
+            }
+            else throw std::runtime_error("error parsing /proc/meminfo: unrecognized unit '" + std::string(unit) + "'");
+        }
+    }
+#elif defined(__APPLE__)
+    result = 0;  // MacOS does support huge pages ("superpages") but we currently didn't write any code to support them
+#else
+# error Unsupported operating system.
+#endif
+    if (result % hardware_page_size() != 0)
+    {
+        gsl_FailFast();  // In this library we assume that the large page size is a multiple of page size, and thus a multiple of cache line size as well.
+    }
+    return result;
+}
+
+std::size_t
+query_hardware_page_size()
+{
+    std::size_t result;
+#if defined(_WIN32)
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    result = sysInfo.dwPageSize;
+#elif defined(__linux__)
+    result = sysconf(_SC_PAGESIZE);
+#elif defined(__APPLE__)
+    result = getpagesize();
+#else
+# error Unsupported operating system.
+#endif
+    if (result % hardware_cache_line_size() != 0)
+    {
+        gsl_FailFast();  // In this library we assume that page size is a multiple of cache line size.
+    }
+    return result;
+}
+
+#if !defined(_WIN32) // `query_hardware_cache_line_size()` for Windows is defined in cpuinfo.cpp
+std::size_t
+query_hardware_cache_line_size()
+{
+# if defined(__linux__)
+    long result = 0;
+#  ifdef _SC_LEVEL1_DCACHE_LINESIZE
+    result = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+    if (result > 0) return gsl::narrow<std::size_t>(result);
+#  endif // _SC_LEVEL1_DCACHE_LINESIZE
+    FILE* f = std::fopen("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", "r");
+    if (f == nullptr) throw std::runtime_error("cannot open /sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
+    int nf = std::fscanf(f, "%ld", &result);
+    std::fclose(f);
+    if (nf != 1 || result == 0) throw std::runtime_error("error parsing /sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
+    return gsl::narrow<std::size_t>(result);
+# elif defined(__APPLE__)
+    std::size_t result = 0;
+    std::size_t nbResult = sizeof result;
+    int ec = sysctlbyname("hw.cachelinesize", &result, &nbResult, 0, 0);
+    if (ec != 0) throw std::runtime_error("cannot query hw.cachelinesize");
+    return result;
+# else
+#  error Unsupported operating system.
+# endif
+}
+#endif // !defined(_WIN32)
+
+void
+check_hardware_constants() noexcept
+{
+#if defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+    if (detail::query_hardware_cache_line_size() != PATTON_HARDWARE_CACHE_LINE_SIZE)
+    {
+        gsl_FailFast();  // The cache line size of the running hardware differs from the value given at compile time.
+    }
+#endif // defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+#if defined(PATTON_HARDWARE_PAGE_SIZE)
+    if (detail::query_hardware_page_size() != PATTON_HARDWARE_PAGE_SIZE)
+    {
+        gsl_FailFast();  // The page size of the running hardware differs from the value given at compile time.
+    }
+#endif // defined(PATTON_HARDWARE_PAGE_SIZE)
+#if defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
+    if (detail::query_hardware_large_page_size() != PATTON_HARDWARE_LARGE_PAGE_SIZE)
+    {
+        gsl_FailFast();  // The large page size of the running hardware differs from the value given at compile time.
+    }
+#endif // defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
+}
+
+
+} // namespace patton::detail
+
 namespace patton {
 
 
+#if !defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
 static std::atomic<std::size_t>
 hardware_large_page_size_value = std::size_t(-1);
 
 std::size_t
 hardware_large_page_size() noexcept
 {
-    static constexpr auto initFunc = []
+    return detail::lazy_init(hardware_large_page_size_value, std::size_t(-1), detail::query_hardware_large_page_size);
+}
+#endif // !defined(PATTON_HARDWARE_LARGE_PAGE_SIZE)
+
+std::span<std::size_t const>
+hardware_large_page_sizes() noexcept
+{
+    static auto const sizes = []
     {
-        std::size_t result;
+        auto result = std::vector<std::size_t>{ };
 #if defined(_WIN32)
-        result = GetLargePageMinimum();
+        if (std::size_t largePageSize = ::GetLargePageMinimum(); largePageSize != 0)
+        {
+            result.push_back(largePageSize);
+        }
 #elif defined(__linux__)
-            // I can't believe that parsing /proc/meminfo is the accepted way to query the default hugepage size and other
-            // parameters.
-        auto f = std::ifstream("/proc/meminfo");
-        if (!f) throw std::runtime_error("cannot open /proc/meminfo");  // something is really wrong if we cannot open that file
-        auto line = std::string{ };
-        result = 0;  // indicating that no "Hugepagesize" entry was found
-        while (std::getline(f, line))
+            // Every supported huge page size has a directory named "hugepages-<size>kB".
+        std::error_code ec;
+        for (auto const& entry : std::filesystem::directory_iterator("/sys/kernel/mm/hugepages", ec))
         {
-            long hugePageSize = 0;
-            char unit[16+1];
-            int nFields = std::sscanf(line.c_str(), "Hugepagesize : %ld %16s", &hugePageSize, unit);
-            if (nFields == 2)
+            unsigned long long sizeInKiB = 0;
+            if (std::sscanf(entry.path().filename().string().c_str(), "hugepages-%llukB", &sizeInKiB) == 1 && sizeInKiB != 0)
             {
-                    // This is the only unit the kernel currently emits, so I don't bother with speculative M[i]B etc.
-                if (std::strcmp(unit, "kB") == 0)
-                {
-                    hugePageSize *= 1024l;
-                    result = gsl::narrow<std::size_t>(hugePageSize);
-                    break;
-                }
-                else throw std::runtime_error("error parsing /proc/meminfo: unrecognized unit '" + std::string(unit) + "'");
+                result.push_back(gsl::narrow_failfast<std::size_t>(sizeInKiB * 1024));
             }
         }
+        std::sort(result.begin(), result.end());
 #elif defined(__APPLE__)
-        result = 0;  // MacOS does support huge pages ("superpages") but we currently didn't write any code to support them
+            // no support for superpages yet, cf. `query_hardware_large_page_size()`
 #else
 # error Unsupported operating system.
 #endif
-        if (result % hardware_page_size() != 0)
-        {
-            gsl_FailFast();  // In this library we assume that the large page size is a multiple of page size, and thus a multiple of cache line size as well.
-        }
         return result;
-
-    };
-    return detail::lazy_init(hardware_large_page_size_value, std::size_t(-1), initFunc);
+    }();
+    return sizes;
 }
 
-
+#if !defined(PATTON_HARDWARE_PAGE_SIZE)
 static std::atomic<std::size_t>
 hardware_page_size_value = std::size_t(-1);
 
 std::size_t
 hardware_page_size() noexcept
+{
+    return detail::lazy_init(hardware_page_size_value, std::size_t(-1), detail::query_hardware_page_size);
+}
+#endif // !defined(PATTON_HARDWARE_PAGE_SIZE)
+
+#if !defined(_WIN32) && !defined(PATTON_HARDWARE_CACHE_LINE_SIZE) // `hardware_cache_line_size()` for Windows is defined in cpuinfo.cpp
+static std::atomic<std::size_t>
+hardware_cache_line_size_value = std::size_t(-1);
+
+std::size_t
+hardware_cache_line_size() noexcept
+{
+    return detail::lazy_init(hardware_cache_line_size_value, std::size_t(-1), detail::query_hardware_cache_line_size);
+}
+#endif // !defined(_WIN32) && !defined(PATTON_HARDWARE_CACHE_LINE_SIZE)
+
+static std::atomic<std::size_t>
+hardware_destructive_interference_size_value = std::size_t(-1);
+
+std::size_t
+hardware_destructive_interference_size() noexcept
 {
     static constexpr auto initFunc = []
     {
-        std::size_t result;
-#if defined(_WIN32)
-        SYSTEM_INFO sysInfo;
-        GetSystemInfo(&sysInfo);
-        result = sysInfo.dwPageSize;
-#elif defined(__linux__)
-        result = sysconf(_SC_PAGESIZE);
-#elif defined(__APPLE__)
-        result = getpagesize();
+#if defined(_M_IX86) || defined(_M_AMD64) || defined(__i386__) || defined(__x86_64__)
+            // The spatial prefetcher of Intel CPUs completes every cache line fetched to a 128-byte-aligned pair. AMD CPUs have
+            // similar adjacent-line prefetchers, so we make no attempt to distinguish by vendor.
+        std::size_t result = 2*hardware_cache_line_size();
 #else
-# error Unsupported operating system.
+        std::size_t result = hardware_cache_line_size();
 #endif
-        if (result % hardware_cache_line_size() != 0)
+        if (result > max_hardware_destructive_interference_size)
         {
-            gsl_FailFast();  // In this library we assume that page size is a multiple of cache line size.
+            gsl_FailFast();  // In this library we assume that `max_hardware_destructive_interference_size` is an upper bound.
         }
         return result;
     };
-    return detail::lazy_init(hardware_page_size_value, std::size_t(-1), initFunc);
+    return detail::lazy_init(hardware_destructive_interference_size_value, std::size_t(-1), initFunc);
+}
+
+
+    // Cache queries for levels up to this value are cached; queries for higher levels are rare enough to be answered directly.
+static constexpr int max_cached_cache_level = 4;
+
+    // Returns the smallest non-zero value of `func(cache)` for all data or unified caches of the given level, or 0.
+template <typename F>
+static std::size_t
+min_over_caches(int level, F&& func)
+{
+    std::size_t result = 0;
+    for (auto const& cache : cpu_topology::system().caches())
+    {
+        if (cache.level != level || cache.type == cache_type::instruction) continue;
+        std::size_t value = func(cache);
+        if (value != 0 && (result == 0 || value < result))
+        {
+            result = value;
+        }
+    }
+    return result;
 }
 
-#if !defined(_WIN32) // `hardware_cache_line_size()` for Windows is defined in cpuinfo.cpp
 static std::atomic<std::size_t>
-hardware_cache_line_size_value = std::size_t(-1);
+hardware_cache_size_values[max_cached_cache_level] = { std::size_t(-1), std::size_t(-1), std::size_t(-1), std::size_t(-1) };
 
 std::size_t
-hardware_cache_line_size() noexcept
+hardware_cache_size(int level) noexcept
 {
-    static constexpr auto initFunc = []
+    gsl_Expects(level >= 1);
+
+    auto initFunc = [level]
     {
-# if defined(__linux__)
-        long result = 0;
-#  ifdef _SC_LEVEL1_DCACHE_LINESIZE
-        result = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
-        if (result > 0) return gsl::narrow<std::size_t>(result);
-#  endif // _SC_LEVEL1_DCACHE_LINESIZE
-        FILE* f = std::fopen("/sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size", "r");
-        if (f == nullptr) throw std::runtime_error("cannot open /sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
-        int nf = std::fscanf(f, "%ld", &result);
-        std::fclose(f);
-        if (nf != 1 || result == 0) throw std::runtime_error("error parsing /sys/devices/system/cpu/cpu0/cache/index0/coherency_line_size");
-        return gsl::narrow<std::size_t>(result);
-# elif defined(__APPLE__)
-        std::size_t result = 0;
-        std::size_t nbResult = sizeof result;
-        int ec = sysctlbyname("hw.cachelinesize", &result, &nbResult, 0, 0);
-        if (ec != 0) throw std::runtime_error("cannot query hw.cachelinesize");
-        return result;
-# else
-#  error Unsupported operating system.
-# endif
+        return patton::min_over_caches(level,
+            [](cache_info const& cache)
+            {
+                return cache.size;
+            });
     };
-    return detail::lazy_init(hardware_cache_line_size_value, std::size_t(-1), initFunc);
+    if (level > max_cached_cache_level) return initFunc();
+    return detail::lazy_init(hardware_cache_size_values[level - 1], std::size_t(-1), initFunc);
+}
+
+static std::atomic<std::size_t>
+hardware_cache_size_per_thread_values[max_cached_cache_level] = { std::size_t(-1), std::size_t(-1), std::size_t(-1), std::size_t(-1) };
+
+std::size_t
+hardware_cache_size_per_thread(int level) noexcept
+{
+    gsl_Expects(level >= 1);
+
+    auto initFunc = [level]
+    {
+        return patton::min_over_caches(level,
+            [](cache_info const& cache)
+            {
+                return cache.size / cache.hardware_threads.size();
+            });
+    };
+    if (level > max_cached_cache_level) return initFunc();
+    return detail::lazy_init(hardware_cache_size_per_thread_values[level - 1], std::size_t(-1), initFunc);
+}
+
+static std::atomic<int>
+hardware_cache_associativity_values[max_cached_cache_level] = { -1, -1, -1, -1 };
+
+int
+hardware_cache_associativity(int level) noexcept
+{
+    gsl_Expects(level >= 1);
+
+    auto initFunc = [level]
+    {
+        return gsl::narrow_failfast<int>(patton::min_over_caches(level,
+            [](cache_info const& cache)
+            {
+                return gsl::narrow_failfast<std::size_t>(cache.associativity);
+            }));
+    };
+    if (level > max_cached_cache_level) return initFunc();
+    return detail::lazy_init(hardware_cache_associativity_values[level - 1], -1, initFunc);
 }
-#endif // !defined(_WIN32)
 
 
 } // namespace patton
@@ -8,13 +8,16 @@
 #endif // DEBUG_WAIT_CHAIN
 
 #include <new>
+#include <span>
 #include <string>
+#include <vector>
 #include <memory>        // for unique_ptr<>
 #include <atomic>
 #include <thread>
 #include <cstddef>       // for size_t, ptrdiff_t
 #include <cstring>       // for wcslen(), swprintf()
-#include <utility>       // for move()
+#include <utility>       // for move(), exchange()
+#include <numeric>       // for iota()
 #include <algorithm>     // for min(), max()
 #include <exception>     // for terminate()
 #include <stdexcept>     // for range_error
@@ -48,10 +51,12 @@
 
 #include <gsl-lite/gsl-lite.hpp>  // for index, narrow_failfast<>(), narrow_cast<>()
 
-#include <patton/buffer.hpp>        // for aligned_buffer<>
+#include <patton/memory.hpp>        // for numa_alloc(), numa_page_alloc(), numa_free()
+#include <patton/topology.hpp>
 #include <patton/thread_squad.hpp>
 
 #include <patton/detail/errors.hpp>
+#include <patton/detail/thread.hpp>  // for affinity_domain_members()
 
 
 #ifdef _MSC_VER
@@ -137,8 +142,8 @@ private:
     cpu_set_t* data_;
 
 public:
-    cpu_set()
-        : cpuCount_(std::thread::hardware_concurrency())
+    explicit cpu_set(std::size_t _cpuCount = std::thread::hardware_concurrency())
+        : cpuCount_(_cpuCount)
     {
         data_ = CPU_ALLOC(cpuCount_);
         if (data_ == nullptr)
@@ -148,6 +153,17 @@ public:
         std::size_t lsize = size();
         CPU_ZERO_S(lsize, data_);
     }
+    explicit cpu_set(std::span<std::size_t const> coreIndices)
+        : cpu_set(std::max<std::size_t>(std::thread::hardware_concurrency(),
+              coreIndices.empty() ? 0 : *std::max_element(coreIndices.begin(), coreIndices.end()) + 1))
+    {
+        for (std::size_t coreIdx : coreIndices)
+        {
+            set_cpu_flag(coreIdx);
+        }
+    }
+    cpu_set(cpu_set const&) = delete;
+    cpu_set& operator =(cpu_set const&) = delete;
     std::size_t
     size() const noexcept
     {
@@ -175,17 +191,21 @@ public:
 
 #ifdef THREAD_PINNING_SUPPORTED
 [[maybe_unused]] static void
-setThreadAffinity(std::thread::native_handle_type handle, std::size_t coreIdx)
+setThreadAffinity(std::thread::native_handle_type handle, std::span<std::size_t const> coreIndices)
 {
 # if defined(_WIN32)
-    if (coreIdx >= sizeof(DWORD_PTR) * 8)  // bits per byte
+    DWORD_PTR mask = 0;
+    for (std::size_t coreIdx : coreIndices)
     {
-        throw std::range_error("cannot currently handle more than 8*sizeof(void*) CPUs on Windows");
+        if (coreIdx >= sizeof(DWORD_PTR) * 8)  // bits per byte
+        {
+            throw std::range_error("cannot currently handle more than 8*sizeof(void*) CPUs on Windows");
+        }
+        mask |= DWORD_PTR(1) << coreIdx;
     }
-    detail::win32_assert(SetThreadAffinityMask((HANDLE) handle, DWORD_PTR(1) << coreIdx) != 0);
+    detail::win32_assert(SetThreadAffinityMask((HANDLE) handle, mask) != 0);
 # elif defined(USE_PTHREAD_SETAFFINITY)
-    cpu_set cpuSet;
-    cpuSet.set_cpu_flag(coreIdx);
+    cpu_set cpuSet(coreIndices);
     detail::posix_check(::pthread_setaffinity_np((pthread_t) handle, cpuSet.size(), cpuSet.data()));
 # else
 #  error Unsupported operating system.
@@ -194,10 +214,9 @@ setThreadAffinity(std::thread::native_handle_type handle, std::size_t coreIdx)
 
 # ifdef USE_PTHREAD_SETAFFINITY
 static void
-setThreadAttrAffinity(pthread_attr_t& attr, std::size_t coreIdx)
+setThreadAttrAffinity(pthread_attr_t& attr, std::span<std::size_t const> coreIndices)
 {
-    cpu_set cpuSet;
-    cpuSet.set_cpu_flag(coreIdx);
+    cpu_set cpuSet(coreIndices);
     detail::posix_check(::pthread_attr_setaffinity_np(&attr, cpuSet.size(), cpuSet.data()));
 }
 # endif // USE_PTHREAD_SETAFFINITY
@@ -394,13 +413,10 @@ private:
 #else
 # error Unsupported operating system
 #endif
-    std::size_t coreAffinity_;
+    std::vector<std::size_t> coreAffinity_;  // empty if the thread is not pinned
 
 public:
-    os_thread()
-        : coreAffinity_{ std::size_t(-1) }
-    {
-    }
+    os_thread() = default;
 
     bool
     is_running() const noexcept
@@ -415,11 +431,11 @@ public:
     }
 
     void
-    set_core_affinity(std::size_t _coreAffinity)
+    set_core_affinity(std::vector<std::size_t> _coreAffinity)
     {
         gsl_Expects(!is_running());
 
-        coreAffinity_ = _coreAffinity;
+        coreAffinity_ = std::move(_coreAffinity);
     }
 
     void
@@ -428,10 +444,10 @@ public:
         gsl_Expects(!is_running());
 
 #if defined(_WIN32)
-        DWORD threadCreationFlags = coreAffinity_ != std::size_t(-1) ? CREATE_SUSPENDED : 0;
+        DWORD threadCreationFlags = !coreAffinity_.empty() ? CREATE_SUSPENDED : 0;
         handle_ = detail::win32_handle((HANDLE) ::_beginthreadex(NULL, 0, proc, ctx, threadCreationFlags, nullptr));
         detail::win32_assert(handle_ != nullptr);
-        if (coreAffinity_ != std::size_t(-1))
+        if (!coreAffinity_.empty())
         {
             detail::setThreadAffinity(handle_.get(), coreAffinity_);
             DWORD result = ::ResumeThread(handle_.get());
@@ -440,7 +456,7 @@ public:
 #elif defined(USE_PTHREAD)
         PThreadAttr attr;
 # ifdef USE_PTHREAD_SETAFFINITY
-        if (coreAffinity_ != std::size_t(-1))
+        if (!coreAffinity_.empty())
         {
             detail::setThreadAttrAffinity(attr.attr, coreAffinity_);
         }
@@ -502,7 +518,7 @@ thread_squad_thread_func(void* data);
 class thread_squad_impl : public thread_squad_impl_base
 {
 public:
-    class alignas(std::hardware_destructive_interference_size) thread_data
+    class alignas(max_hardware_destructive_interference_size) thread_data
     {
         friend thread_squad_impl;
 
@@ -510,25 +526,29 @@ public:
             // structure
         thread_squad_impl& threadSquad_;
         int threadIdx_;
-        int numSubthreads_;
+        int numaNode_ = -1;            // NUMA node of the hardware thread the thread is pinned to, or -1 if unknown
+        std::vector<int> subthreads_;  // immediate subthreads in ascending order; the subtree of every subthread extends up to the next one
 
             // resources
         os_thread osThread_;
+        bool notifiedByFork_ = false;  // set if the first task was signaled by `fork_all_threads()` rather than by the superordinate thread
 
-            // synchronization data
-        std::atomic<int> incoming_;  // new task notification
-        std::atomic<int> outgoing_;  // task completion notification
-        std::atomic<int> upward_;    // synchronization point collection
+            // synchronization data written by the superordinate thread
+        alignas(max_hardware_destructive_interference_size) std::atomic<int> incoming_;  // new task notification
         std::atomic<int> downward_;  // synchronization point distribution
+
+            // synchronization data written by this thread
+        alignas(max_hardware_destructive_interference_size) std::atomic<int> outgoing_;  // task completion notification
+        std::atomic<int> upward_;    // synchronization point collection
         void* syncData_;             // synchronization data made accessible to the superordinate thread between collection and distribution
 
     public:
         thread_data(thread_squad_impl& _impl) noexcept
             : threadSquad_(_impl),
               incoming_(0),
+              downward_(0),
               outgoing_(0),
               upward_(0),
-              downward_(0),
               syncData_(nullptr)
         {
         }
@@ -554,6 +574,14 @@ public:
             threadSquad_.join_subthreads(threadIdx_, numThreadsToWaitFor);
         }
 
+            // Returns whether the current task was signaled by `fork_all_threads()`, in which case the subthreads have been
+            // signaled as well.
+        bool
+        consume_fork_notification() noexcept
+        {
+            return std::exchange(notifiedByFork_, false);
+        }
+
         thread_squad_task&
         task_wait() noexcept
         {
@@ -602,8 +630,18 @@ public:
 private:
     static constexpr int treeBreadth = 8;
 
-        // synchronization data
-    aligned_buffer<thread_data, cache_line_alignment> threadData_;
+    struct thread_data_deleter
+    {
+        void
+        operator ()(thread_data* data) noexcept
+        {
+            data->~thread_data();
+            detail::numa_free(data, sizeof(thread_data));
+        }
+    };
+
+        // synchronization data; every thread has its own pages, which are placed on the NUMA node of the thread if it is pinned
+    std::vector<std::unique_ptr<thread_data, thread_data_deleter>> threadData_;
     wait_mode waitMode_;
 
         // task-specific data
@@ -624,108 +662,158 @@ private:
         return (stride + (treeBreadth - 1)) / treeBreadth;
     }
 
+        // Arranges the given units, identified by their root threads in ascending order, in a tree of breadth `treeBreadth`
+        // rooted at the first unit. The subtree of every unit is a contiguous range of threads.
     void
-    init(int first, int last, int stride) noexcept
+    link_units(std::span<int const> unitRoots)
     {
-        if (stride != 1)
+        int numUnits = gsl::narrow_failfast<int>(unitRoots.size());
+        if (numUnits <= 1) return;
+
+        int substride = next_substride(numUnits);
+        for (int i = 0; i < numUnits; i += substride)
         {
-            int substride = next_substride(stride);
-            for (int i = first; i < last; i += substride)
-            {
-                init(i, std::min(i + substride, last), substride);
-            }
+            link_units(unitRoots.subspan(i, std::min(substride, numUnits - i)));
+        }
+        for (int i = substride; i < numUnits; i += substride)
+        {
+            threadData_[unitRoots[0]]->subthreads_.push_back(unitRoots[i]);
         }
-        threadData_[first].numSubthreads_ = stride;
     }
 
-    template <typename F>
+        // Builds the synchronization tree. Threads on the same NUMA node are combined first, and only the first thread of every
+        // NUMA node communicates with other nodes, which limits interconnect traffic to O(#nodes) per synchronization. Threads are
+        // never reordered, so reductions still combine results in thread order.
     void
-    to_subthreads(int callingThreadIdx, int _concurrency, F func) noexcept
+    init(std::span<int const> numaNodes)
     {
-        int stride = threadData_[callingThreadIdx].numSubthreads_;
-        int last = std::min(callingThreadIdx + stride, _concurrency);
-        while (stride != 1)
+        auto threadIndices = std::vector<int>(numaNodes.size());
+        std::iota(threadIndices.begin(), threadIndices.end(), 0);
+        auto nodeRoots = std::vector<int>{ };
+        for (int first = 0; first < numThreads; )
         {
-            int substride = next_substride(stride);
-            for (int i = callingThreadIdx + substride; i < last; i += substride)
+            int last = first + 1;
+            while (last < numThreads && numaNodes[last] == numaNodes[first])
             {
-                func(callingThreadIdx, i);
+                ++last;
             }
-            last = std::min(callingThreadIdx + substride, last);
-            stride = substride;
+            link_units(std::span(threadIndices).subspan(first, last - first));
+            nodeRoots.push_back(first);
+            first = last;
         }
+        link_units(nodeRoots);
     }
 
     template <typename F>
     void
-    from_subthreads_impl(int first, int last, int stride, F const& func) noexcept
+    to_subthreads(int callingThreadIdx, int _concurrency, F func) noexcept
     {
-        int substride = next_substride(stride);
-        if (stride != 1)
+            // Notify the most distant subthreads first because they have the largest subtrees.
+        auto const& subthreads = threadData_[callingThreadIdx]->subthreads_;
+        for (auto it = subthreads.rbegin(); it != subthreads.rend(); ++it)
         {
-            from_subthreads_impl(first, std::min(first + substride, last), substride, func);
-        }
-        for (int i = first + substride; i < last; i += substride)
-        {
-            func(first, i);
+            if (*it < _concurrency)
+            {
+                func(callingThreadIdx, *it);
+            }
         }
     }
+
     template <typename F>
     void
     from_subthreads(int callingThreadIdx, int _concurrency, F func) noexcept
     {
-        int stride = threadData_[callingThreadIdx].numSubthreads_;
-        from_subthreads_impl(callingThreadIdx, std::min(callingThreadIdx + stride, _concurrency), stride, func);
+            // Visiting subthreads in ascending order means that results are combined in thread order.
+        for (int i : threadData_[callingThreadIdx]->subthreads_)
+        {
+            if (i >= _concurrency) break;
+            func(callingThreadIdx, i);
+        }
     }
 
     void
     broadcast_to_thread(task_context_synchronizer& synchronizer, [[maybe_unused]] int callingThreadIdx, int targetThreadIdx) noexcept
     {
-        THREAD_SQUAD_DBG("patton thread squad, thread %d: synchronization: notifying %d with downward sense %d\n", callingThreadIdx, targetThreadIdx, (1 ^ threadData_[targetThreadIdx].downward_.load(std::memory_order_relaxed)));
-        synchronizer.broadcast(threadData_[targetThreadIdx].syncData_);
-        detail::toggle_and_notify(threadData_[targetThreadIdx].downward_);
+        THREAD_SQUAD_DBG("patton thread squad, thread %d: synchronization: notifying %d with downward sense %d\n", callingThreadIdx, targetThreadIdx, (1 ^ threadData_[targetThreadIdx]->downward_.load(std::memory_order_relaxed)));
+        synchronizer.broadcast(threadData_[targetThreadIdx]->syncData_);
+        detail::toggle_and_notify(threadData_[targetThreadIdx]->downward_);
     }
 
     void
     collect_from_thread(task_context_synchronizer& synchronizer, [[maybe_unused]] int callingThreadIdx, int targetThreadIdx) noexcept
     {
-        int prevSense = threadData_[targetThreadIdx].downward_.load(std::memory_order_relaxed);
+        int prevSense = threadData_[targetThreadIdx]->downward_.load(std::memory_order_relaxed);
         THREAD_SQUAD_DBG("patton thread squad, thread %d: synchronization: awaiting %d for upward sense %d\n", callingThreadIdx, targetThreadIdx, (1 ^ prevSense));
-        detail::wait_and_load(threadData_[targetThreadIdx].upward_, prevSense, waitMode_);
+        detail::wait_and_load(threadData_[targetThreadIdx]->upward_, prevSense, waitMode_);
         THREAD_SQUAD_DBG("patton thread squad, thread %d: synchronization: awaited %d\n", callingThreadIdx, targetThreadIdx);
-        synchronizer.collect(threadData_[targetThreadIdx].syncData_);
+        synchronizer.collect(threadData_[targetThreadIdx]->syncData_);
     }
 
 public:
     thread_squad_impl(thread_squad::params const& params)
         : thread_squad_impl_base{ params.num_threads },
-          threadData_(gsl::narrow_failfast<std::size_t>(params.num_threads), std::in_place, *this),
           waitMode_(params.spin_wait ? wait_mode::spin_wait : wait_mode::wait)
     {
+        auto numaNodes = std::vector<int>(gsl::narrow_failfast<std::size_t>(numThreads), -1);
+#ifdef THREAD_PINNING_SUPPORTED
+        auto hardwareThreadIds = std::vector<std::size_t>(gsl::narrow_failfast<std::size_t>(numThreads));
+        if (params.pin_to_hardware_threads)
+        {
+            auto const& topology = cpu_topology::system();
+            for (int i = 0; i < numThreads; ++i)
+            {
+                hardwareThreadIds[i] = detail::get_hardware_thread_id(
+                    i, params.max_num_hardware_threads, params.hardware_thread_mappings);
+                int id = gsl::narrow_failfast<int>(hardwareThreadIds[i]);
+                if (topology.contains(id))
+                {
+                    numaNodes[i] = topology.hardware_thread(id).numa_node;
+                }
+            }
+        }
+#endif // THREAD_PINNING_SUPPORTED
+
+        threadData_.reserve(gsl::narrow_failfast<std::size_t>(numThreads));
         for (int i = 0; i < numThreads; ++i)
         {
-            threadData_[i].threadIdx_ = i;
+            void* mem = numaNodes[i] >= 0
+                ? detail::numa_page_alloc(sizeof(thread_data), numaNodes[i])
+                : detail::numa_alloc(sizeof(thread_data), numa_policy::preferred, 0);
+            threadData_.emplace_back(::new(mem) thread_data(*this));
+            threadData_[i]->threadIdx_ = i;
+            threadData_[i]->numaNode_ = numaNodes[i];
         }
+
 #ifdef THREAD_PINNING_SUPPORTED
         if (params.pin_to_hardware_threads)
         {
             for (int i = 0; i < numThreads; ++i)
             {
-                std::size_t coreAffinity = detail::get_hardware_thread_id(
-                    i, params.max_num_hardware_threads, params.hardware_thread_mappings);
-                THREAD_SQUAD_DBG("patton thread squad, thread -1: pin %d to CPU %d\n", i, int(coreAffinity));
-                threadData_[i].osThread_.set_core_affinity(coreAffinity);
+                std::size_t hardwareThreadId = hardwareThreadIds[i];
+                auto domainMembers = detail::affinity_domain_members(gsl::narrow_failfast<int>(hardwareThreadId), params.pinning_domain);
+                auto coreAffinity = std::vector<std::size_t>(domainMembers.size());
+                std::transform(domainMembers.begin(), domainMembers.end(), coreAffinity.begin(),
+                    [](int id) { return gsl::narrow_failfast<std::size_t>(id); });
+                THREAD_SQUAD_DBG("patton thread squad, thread -1: pin %d to CPU %d and %d sibling(s)\n", i, int(hardwareThreadId), int(coreAffinity.size()) - 1);
+                threadData_[i]->osThread_.set_core_affinity(std::move(coreAffinity));
             }
         }
 #endif // THREAD_PINNING_SUPPORTED
 
-        init(0, numThreads, numThreads);
+        init(numaNodes);
+    }
+
+    int
+    numa_node(int threadIdx) const noexcept
+    {
+        int numaNode = threadData_[threadIdx]->numaNode_;
+        return numaNode >= 0 ? numaNode : patton::current_numa_node();
     }
 
     bool
     is_running() const noexcept
     {
-        return threadData_[0].osThread_.is_running();
+        return threadData_[0]->osThread_.is_running();
     }
 
     void
@@ -734,13 +822,14 @@ public:
         int numThreadsToWake = num_threads_for_task();
         for (int i = 0; i < numThreadsToWake; ++i)
         {
-            THREAD_SQUAD_DBG("patton thread squad, thread -1: notifying %d with incoming sense %d\n", i, (1 ^ threadData_[i].incoming_.load(std::memory_order_relaxed)));
-            detail::toggle_and_notify(threadData_[i].incoming_);
+            THREAD_SQUAD_DBG("patton thread squad, thread -1: notifying %d with incoming sense %d\n", i, (1 ^ threadData_[i]->incoming_.load(std::memory_order_relaxed)));
+            threadData_[i]->notifiedByFork_ = true;
+            detail::toggle_and_notify(threadData_[i]->incoming_);
         }
         for (int i = 0; i < numThreads; ++i)
         {
             THREAD_SQUAD_DBG("patton thread squad, thread -1: forking %d\n", i);
-            threadData_[i].osThread_.fork(thread_squad_thread_func, thread_context_for(i));
+            threadData_[i]->osThread_.fork(thread_squad_thread_func, thread_context_for(i));
         }
     }
 
@@ -750,24 +839,24 @@ public:
     //    for (int i = 0; i < numThreads; ++i)
     //    {
     //        THREAD_SQUAD_DBG("patton thread squad, thread -1: joining %d\n", i);
-    //        threadData_[i].osThread_.join();
+    //        threadData_[i]->osThread_.join();
     //    }
     //}
 
     void
     notify_thread([[maybe_unused]] int callingThreadIdx, int targetThreadIdx) noexcept
     {
-        THREAD_SQUAD_DBG("patton thread squad, thread %d: notifying %d with incoming sense %d\n", callingThreadIdx, targetThreadIdx, (1 ^ threadData_[targetThreadIdx].incoming_.load(std::memory_order_relaxed)));
-        detail::toggle_and_notify(threadData_[targetThreadIdx].incoming_);
+        THREAD_SQUAD_DBG("patton thread squad, thread %d: notifying %d with incoming sense %d\n", callingThreadIdx, targetThreadIdx, (1 ^ threadData_[targetThreadIdx]->incoming_.load(std::memory_order_relaxed)));
+        detail::toggle_and_notify(threadData_[targetThreadIdx]->incoming_);
     }
 
     void
     wait_for_thread([[maybe_unused]] int callingThreadIdx, int targetThreadIdx, wait_mode waitMode = wait_mode::spin_wait) noexcept
     {
-        int currentSense = threadData_[targetThreadIdx].incoming_.load(std::memory_order_relaxed);
+        int currentSense = threadData_[targetThreadIdx]->incoming_.load(std::memory_order_relaxed);
         int prevSense = 1 ^ currentSense;
         THREAD_SQUAD_DBG("patton thread squad, thread %d: awaiting %d for outgoing sense %d\n", callingThreadIdx, targetThreadIdx, currentSense);
-        detail::wait_and_load(threadData_[targetThreadIdx].outgoing_, prevSense, waitMode);
+        detail::wait_and_load(threadData_[targetThreadIdx]->outgoing_, prevSense, waitMode);
         THREAD_SQUAD_DBG("patton thread squad, thread %d: awaited %d\n", callingThreadIdx, targetThreadIdx);
 
             // Merge results unless we are on the main thread.
@@ -781,7 +870,7 @@ public:
     join_thread([[maybe_unused]] int callingThreadIdx, int targetThreadIdx) noexcept
     {
         THREAD_SQUAD_DBG("patton thread squad, thread %d: joining %d\n", callingThreadIdx, targetThreadIdx);
-        threadData_[targetThreadIdx].osThread_.join();
+        threadData_[targetThreadIdx]->osThread_.join();
     }
 
     void
@@ -836,10 +925,10 @@ public:
             // Make the synchronizer data available for the duration of the synchronization.
         if (callingThreadIdx > 0)
         {
-            threadData_[callingThreadIdx].syncData_ = synchronizer.sync_data();
-            int oldValue = detail::toggle_and_notify(threadData_[callingThreadIdx].upward_);
-            detail::wait_and_load(threadData_[callingThreadIdx].downward_, oldValue, waitMode_);
-            threadData_[callingThreadIdx].syncData_ = nullptr;
+            threadData_[callingThreadIdx]->syncData_ = synchronizer.sync_data();
+            int oldValue = detail::toggle_and_notify(threadData_[callingThreadIdx]->upward_);
+            detail::wait_and_load(threadData_[callingThreadIdx]->downward_, oldValue, waitMode_);
+            threadData_[callingThreadIdx]->syncData_ = nullptr;
         }
     }
     void
@@ -870,7 +959,7 @@ public:
 
     void* thread_context_for(int threadIdx)
     {
-        return &threadData_[threadIdx];
+        return threadData_[threadIdx].get();
     }
 };
 
@@ -885,7 +974,10 @@ run_thread(thread_squad_impl::thread_data& threadData)
             auto& task = threadData.task_wait();  // must not be referenced after signaling completion!
             joinRequested = task.params.join_requested;
             THREAD_SQUAD_DBG("patton thread squad, thread %d: beginning pass %d\n", threadData.thread_idx(), pass);
-            if (pass > 0)
+
+                // Threads which did not participate in the first task are woken up by their superordinate thread later, and
+                // then they must wake up their own subthreads.
+            if (!threadData.consume_fork_notification())
             {
                 threadData.notify_subthreads();
             }
@@ -894,7 +986,7 @@ run_thread(thread_squad_impl::thread_data& threadData)
         }
         threadData.task_signal_completion();
 
-            // We only require `pass > 0` on all passes after the first one, so clamp the value to avoid UB and wraparound.
+            // The pass count is only used for diagnostic purposes, so clamp the value to avoid UB and wraparound.
         if (pass < std::numeric_limits<int>::max())
         {
             ++pass;
@@ -922,6 +1014,9 @@ run_thread(thread_squad_impl::thread_data& threadData)
 //
 //      Subthread counts:   9 1 1 3 1 1 3 1 1     8 1 2 1 4 1 2 1     8 1 2 1 4 1 2     6 1 1 3 1 1
 //
+//      If the threads are pinned to hardware threads on different NUMA nodes, every contiguous run of threads on the same node
+//      is first arranged in such a tree, and the roots of the runs are then arranged in a tree of their own.
+//
 
 
 static void
@@ -1030,7 +1125,7 @@ task_context_synchronizer::broadcast([[maybe_unused]] void* dst) noexcept
 }
 
 
-struct alignas(std::hardware_destructive_interference_size) thread_squad_nop : thread_squad_task
+struct alignas(max_hardware_destructive_interference_size) thread_squad_nop : thread_squad_task
 {
 public:
     ~thread_squad_nop() = default;
@@ -1072,6 +1167,13 @@ thread_squad::task_context::broadcast(detail::task_context_synchronizer& synchro
     impl.synchronize_broadcast(synchronizer, threadIdx_);
 }
 
+int
+thread_squad::task_context::numa_node() const noexcept
+{
+    auto& impl = static_cast<detail::thread_squad_impl const&>(impl_);
+    return impl.numa_node(threadIdx_);
+}
+
 
 detail::thread_squad_handle
 thread_squad::create(thread_squad::params p)
@@ -0,0 +1,174 @@
+
+#include <patton/memory.hpp>
+
+#include <string>
+#include <cstdint>    // for uintptr_t
+#include <fstream>
+#include <sstream>
+
+#include <patton/new.hpp>  // for hardware_page_size()
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+
+    // This test is compiled once for every allocation checking mode, together with a copy of the library compiled for the same
+    // mode; cf. "test/CMakeLists.txt".
+#define PATTON_ALLOCATION_CHECKING_NONE  0
+#define PATTON_ALLOCATION_CHECKING_TRAP  1
+#define PATTON_ALLOCATION_CHECKING_GUARD 2
+#ifndef PATTON_ALLOCATION_CHECKING
+# error PATTON_ALLOCATION_CHECKING must be defined
+#endif // !defined(PATTON_ALLOCATION_CHECKING)
+
+
+namespace {
+
+
+std::size_t
+page_ceil(std::size_t size)
+{
+    std::size_t pageSize = patton::hardware_page_size();
+    return (size + (pageSize - 1)) / pageSize * pageSize;
+}
+
+#if defined(__linux__)
+    // Returns the permissions of the mapping which contains the given address as listed in "/proc/self/maps", e.g. "rw-p", or
+    // an empty string if the address is not mapped.
+std::string
+mapping_permissions(void const* address)
+{
+    auto addr = reinterpret_cast<std::uintptr_t>(address);
+    auto f = std::ifstream("/proc/self/maps");
+    auto line = std::string{ };
+    while (std::getline(f, line))
+    {
+        auto ls = std::istringstream(line);
+        std::uintptr_t begin, end;
+        char dash;
+        auto permissions = std::string{ };
+        ls >> std::hex >> begin >> dash >> end >> permissions;
+        if (addr >= begin && addr < end)
+        {
+            return permissions;
+        }
+    }
+    return { };
+}
+#endif // defined(__linux__)
+
+    // Writes to every byte of the allocation and verifies that the memory past its end is checked as the mode demands.
+void
+check_armed_allocation(char* data, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        data[i] = char(i);
+    }
+    std::size_t dataSize = page_ceil(size);
+
+#if PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD
+# if defined(__linux__)
+    CHECK(mapping_permissions(data) == "rw-p");
+    CHECK(mapping_permissions(data + dataSize - 1) == "rw-p");
+    CHECK(mapping_permissions(data + dataSize) == "---p");
+# endif // defined(__linux__)
+#elif PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_TRAP
+    CHECK(patton::detail::check_out_of_bounds_write_trap(data, size, dataSize));
+    if (dataSize != size)
+    {
+            // Damage the trap word just past the end and restore it.
+        char saved = data[size];
+        data[size] = char(~saved);
+        CHECK_FALSE(patton::detail::check_out_of_bounds_write_trap(data, size, dataSize));
+        data[size] = saved;
+        CHECK(patton::detail::check_out_of_bounds_write_trap(data, size, dataSize));
+    }
+# if defined(__linux__)
+    CHECK(mapping_permissions(data + dataSize - 1) == "rw-p");
+# endif // defined(__linux__)
+#else // PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_NONE
+    if (dataSize != size)
+    {
+        data[size] = 1;  // not checked
+    }
+    CHECK(patton::detail::check_out_of_bounds_write_trap(data, size, dataSize));
+# if defined(__linux__)
+    CHECK(mapping_permissions(data + dataSize - 1) == "rw-p");
+# endif // defined(__linux__)
+#endif
+}
+
+void
+check_contents(char const* data, std::size_t size)
+{
+    bool contentsPreserved = true;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        contentsPreserved = contentsPreserved && data[i] == char(i);
+    }
+    CHECK(contentsPreserved);
+}
+
+
+TEST_CASE("page_allocator<> checks allocations for out-of-bounds writes")
+{
+    std::size_t pageSize = patton::hardware_page_size();
+    std::size_t size = GENERATE_COPY(pageSize - 64, 3*pageSize);
+    CAPTURE(size);
+    auto alloc = patton::page_allocator<char>{ };
+
+    SECTION("allocate and deallocate")
+    {
+        char* data = alloc.allocate(size);
+        check_armed_allocation(data, size);
+        alloc.deallocate(data, size);
+    }
+    SECTION("reallocate")
+    {
+        char* data = alloc.allocate(size);
+        check_armed_allocation(data, size);
+
+        std::size_t largerSize = size + 2*pageSize + 32;
+        data = alloc.reallocate(data, size, largerSize);
+        check_contents(data, size);
+        check_armed_allocation(data, largerSize);
+
+        std::size_t smallerSize = size/2;
+        data = alloc.reallocate(data, largerSize, smallerSize);
+        check_contents(data, smallerSize);
+        check_armed_allocation(data, smallerSize);
+
+        alloc.deallocate(data, smallerSize);
+    }
+    SECTION("page cache")
+    {
+        REQUIRE(patton::page_cache_capacity() == 0);
+        patton::set_page_cache_capacity(16*pageSize);
+
+        char* data = alloc.allocate(size);
+        check_armed_allocation(data, size);
+        alloc.deallocate(data, size);
+#if PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD && defined(__linux__)
+        CHECK(mapping_permissions(data + page_ceil(size)) == "rw-p");  // guard pages are removed from cached runs
+#endif // PATTON_ALLOCATION_CHECKING == PATTON_ALLOCATION_CHECKING_GUARD && defined(__linux__)
+
+        char* newData = alloc.allocate(size);
+        CHECK(newData == data);
+        check_armed_allocation(newData, size);
+        alloc.deallocate(newData, size);
+
+#if !defined(_WIN32)  // Windows only reuses cached runs of the same size
+        std::size_t smallerSize = size/2 + 1;
+        newData = alloc.allocate(smallerSize);
+        CHECK(newData == data);
+        check_armed_allocation(newData, smallerSize);
+        alloc.deallocate(newData, smallerSize);
+#endif // !defined(_WIN32)
+
+        patton::set_page_cache_capacity(0);
+    }
+}
+
+
+} // anonymous namespace
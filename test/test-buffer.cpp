@@ -1,5 +1,17 @@
 
 #include <patton/buffer.hpp>
+#include <patton/new.hpp>  // for hardware_page_size(), hardware_large_page_size(), hardware_cache_size(), hardware_cache_associativity()
+#include <patton/topology.hpp>
+#include <patton/thread_squad.hpp>
+
+#include <atomic>
+#include <stdexcept>  // for runtime_error
+#include <span>
+#include <tuple>
+#include <vector>
+#include <cstdint>    // for uintptr_t
+#include <utility>    // for move()
+#include <algorithm>  // for all_of(), equal()
 
 #include <gsl-lite/gsl-lite.hpp>
 
@@ -14,6 +26,79 @@ namespace {
 namespace gsl = ::gsl_lite;
 
 
+struct counted_element
+{
+    static inline std::atomic<int> numConstructed = 0;
+    static inline std::atomic<int> numAlive = 0;
+    static inline int throwAt = -1;
+
+    int value;
+
+    counted_element(int _value)
+        : value(_value)
+    {
+        if (numConstructed++ == throwAt) throw std::runtime_error("construction failed");
+        ++numAlive;
+    }
+    counted_element(counted_element const& rhs)
+        : value(rhs.value)
+    {
+        if (numConstructed++ == throwAt) throw std::runtime_error("construction failed");
+        ++numAlive;
+    }
+    ~counted_element()
+    {
+        --numAlive;
+    }
+};
+
+    // Counts the allocations and reallocations made through the wrapped page allocator.
+struct allocation_counts
+{
+    static inline int numAllocations = 0;
+    static inline int numReallocations = 0;
+};
+template <typename T, template <typename> class A>
+class counting_allocator : public A<T>
+{
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = counting_allocator<U, A>;
+    };
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(counting_allocator<U, A> const& rhs) noexcept
+        : A<T>(rhs)
+    {
+    }
+
+    [[nodiscard]] T*
+    allocate(std::size_t n)
+    {
+        ++allocation_counts::numAllocations;
+        return A<T>::allocate(n);
+    }
+    [[nodiscard]] T*
+    reallocate(T* ptr, std::size_t oldN, std::size_t newN)
+    {
+        ++allocation_counts::numReallocations;
+        return A<T>::reallocate(ptr, oldN, newN);
+    }
+
+    template <typename U>
+    friend bool
+    operator ==(counting_allocator const& lhs, counting_allocator<U, A> const& rhs) noexcept
+    {
+        return static_cast<A<T> const&>(lhs) == static_cast<A<U> const&>(rhs);
+    }
+};
+
+
 TEST_CASE("aligned_buffer<> properly aligns elements")
 {
     constexpr std::size_t alignment = 4 * sizeof(int);
@@ -40,5 +125,294 @@ TEST_CASE("aligned_row_buffer<> properly aligns elements")
     // TODO: add checks
 }
 
+TEST_CASE("aligned_row_buffer<> pads power-of-two rows to avoid cache set aliasing")
+{
+    std::size_t cacheLineSize = patton::hardware_cache_line_size();
+    std::size_t numCols = GENERATE(std::size_t(0), std::size_t(5), std::size_t(1024), std::size_t(4096));
+
+    auto aligned = patton::aligned_row_buffer<float, patton::cache_line_alignment>(16, numCols);
+    auto padded = patton::aligned_row_buffer<float, patton::cache_line_alignment>(16, numCols, patton::row_stride_policy::anti_aliased, std::in_place, 1.f);
+    CHECK(aligned.row_stride() == (numCols*sizeof(float) + cacheLineSize - 1)/cacheLineSize*cacheLineSize);
+    CHECK(padded.row_stride() >= aligned.row_stride());
+    CHECK(padded.row_stride() % cacheLineSize == 0);
+    CHECK(padded.columns() == numCols);
+    for (std::size_t i = 0; i != padded.rows(); ++i)
+    {
+        CHECK(reinterpret_cast<std::uintptr_t>(padded[i].data()) % cacheLineSize == 0);
+        CHECK(std::all_of(padded[i].begin(), padded[i].end(), [](float v) { return v == 1.f; }));
+    }
+
+    std::size_t l1Size = patton::hardware_cache_size(1);
+    int l1Associativity = patton::hardware_cache_associativity(1);
+    if (numCols >= 1024 && l1Size != 0 && l1Associativity > 0)
+    {
+        std::size_t l1WaySize = l1Size/std::size_t(l1Associativity);
+        CHECK(aligned.row_stride() % l1WaySize == 0);
+        CHECK(padded.row_stride() % l1WaySize != 0);
+    }
+    if (numCols == 5)
+    {
+        CHECK(padded.row_stride() == aligned.row_stride());
+    }
+}
+
+TEST_CASE("aligned_row_buffer<> supports a row stride policy with every form of initialization")
+{
+    using buffer = patton::aligned_row_buffer<int, patton::cache_line_alignment>;
+    constexpr auto policy = patton::row_stride_policy::anti_aliased;
+    auto alloc = patton::aligned_allocator<int, patton::cache_line_alignment>{ };
+    auto squad = patton::thread_squad({ .num_threads = 2 });
+    auto reference = buffer(16, 1024, policy);
+
+    auto check = [&reference](buffer const& buf)
+    {
+        CHECK(buf.rows() == 16);
+        CHECK(buf.columns() == 1024);
+        CHECK(buf.row_stride() == reference.row_stride());
+        for (std::size_t i = 0; i != buf.rows(); ++i)
+        {
+            CHECK(std::all_of(buf[i].begin(), buf[i].end(), [](int v) { return v == 42; }));
+        }
+    };
+    check(buffer(16, 1024, policy, 42));
+    check(buffer(16, 1024, policy, 42, alloc));
+    check(buffer(16, 1024, policy, std::in_place, 42));
+    check(buffer(16, 1024, policy, alloc, std::in_place, 42));
+    check(buffer(squad, 16, 1024, policy, 42));
+    check(buffer(squad, 16, 1024, policy, 42, alloc));
+    check(buffer(squad, 16, 1024, policy, std::in_place, 42));
+    check(buffer(squad, 16, 1024, policy, alloc, std::in_place, 42));
+}
+
+
+TEST_CASE("aligned_vector<> keeps elements aligned while growing")
+{
+    constexpr std::size_t alignment = 64;
+    auto v = patton::aligned_vector<int, alignment>{ };
+    CHECK(v.empty());
+    for (int i = 0; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+    CHECK(v.size() == 100);
+    CHECK(v.capacity() >= 100);
+    bool allAligned = true;
+    bool allPreserved = true;
+    int i = 0;
+    for (int const& element : v)
+    {
+        allAligned = allAligned && reinterpret_cast<std::uintptr_t>(&element) % alignment == 0;
+        allPreserved = allPreserved && element == i++;
+    }
+    CHECK(allAligned);
+    CHECK(allPreserved);
+
+    v.push_back(v.front());  // argument refers to an element of the vector
+    CHECK(v.back() == 0);
+    v.resize(2*v.capacity(), v[1]);
+    CHECK(v.back() == 1);
+    v.resize(3);
+    CHECK(v.size() == 3);
+    v.pop_back();
+    CHECK(v.back() == 1);
+    v.reserve(1000);
+    CHECK(v.capacity() == 1000);
+    CHECK(v[1] == 1);
+    v.clear();
+    CHECK(v.empty());
+}
+
+TEST_CASE("aligned_vector<> moves or copies non-trivial elements")
+{
+    counted_element::numConstructed = 0;
+    counted_element::numAlive = 0;
+    counted_element::throwAt = -1;
+    {
+        auto v = patton::aligned_vector<counted_element, 32>{ };
+        for (int i = 0; i < 20; ++i)
+        {
+            v.emplace_back(i);
+        }
+        CHECK(counted_element::numAlive == 20);
+        CHECK(v[19].value == 19);
+
+        counted_element::throwAt = counted_element::numConstructed + 2;
+        CHECK_THROWS_AS(v.resize(25, counted_element(42)), std::runtime_error);
+        CHECK(v.size() == 20);
+        CHECK(counted_element::numAlive == 20);
+        counted_element::throwAt = -1;
+
+        auto w = std::move(v);
+        CHECK(w.size() == 20);
+        CHECK(v.empty());
+    }
+    CHECK(counted_element::numAlive == 0);
+}
+
+TEST_CASE("aligned_vector<> remaps page-backed storage")
+{
+        // Growth must go through `reallocate()` rather than allocating new storage and copying the elements.
+    auto grow = [](auto& v, std::size_t n)
+    {
+        allocation_counts::numAllocations = 0;
+        allocation_counts::numReallocations = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v.push_back(int(i));
+        }
+        CHECK(allocation_counts::numAllocations == 1);
+        CHECK(allocation_counts::numReallocations > 0);
+        bool allPreserved = true;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            allPreserved = allPreserved && v[i] == int(i);
+        }
+        CHECK(allPreserved);
+    };
+
+    SECTION("page_allocator<>")
+    {
+        std::size_t pageSize = patton::hardware_page_size();
+        auto v = patton::aligned_vector<int, alignof(int), counting_allocator<int, patton::page_allocator>>{ };
+        grow(v, 16*pageSize/sizeof(int) + 1);
+        CHECK(reinterpret_cast<std::uintptr_t>(&v[0]) % pageSize == 0);
+    }
+    SECTION("large_page_allocator<>")
+    {
+        std::size_t largePageSize = patton::hardware_large_page_size();
+        if (largePageSize == 0) return;
+
+        auto v = patton::aligned_vector<int, alignof(int), counting_allocator<int, patton::large_page_allocator>>{ };
+        grow(v, 3*largePageSize/sizeof(int) + 1);
+        CHECK(reinterpret_cast<std::uintptr_t>(&v[0]) % largePageSize == 0);
+    }
+}
+
+
+TEST_CASE("aligned_soa_buffer<> stores fields in separate aligned arrays")
+{
+    std::size_t cacheLineSize = patton::hardware_cache_line_size();
+    std::size_t numElements = GENERATE(0, 1, 17, 1000);
+    auto buf = patton::aligned_soa_buffer<std::tuple<float, double, char>, patton::cache_line_alignment>(numElements);
+    CHECK(buf.size() == numElements);
+    CHECK(buf.field<0>().size() == numElements);
+    CHECK(buf.field<2>().size() == numElements);
+    CHECK(buf.end() - buf.begin() == std::ptrdiff_t(numElements));
+    if (numElements == 0)
+    {
+        return;
+    }
+
+    CHECK(reinterpret_cast<std::uintptr_t>(buf.field<0>().data()) % cacheLineSize == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(buf.field<1>().data()) % cacheLineSize == 0);
+    CHECK(reinterpret_cast<std::uintptr_t>(buf.field<2>().data()) % cacheLineSize == 0);
+    CHECK(std::all_of(buf.field<1>().begin(), buf.field<1>().end(), [](double x) { return x == 0.; }));
+
+    int i = 0;
+    for (auto [x, y, c] : buf)
+    {
+        x = float(i);
+        y = 2.*i;
+        c = char(i % 100);
+        ++i;
+    }
+    CHECK(buf.field<0>()[numElements - 1] == float(numElements - 1));
+    CHECK(buf.field<1>()[numElements - 1] == 2.*double(numElements - 1));
+    CHECK(std::get<2>(buf.back()) == char((numElements - 1) % 100));
+
+    buf[0] = std::tuple(-1.f, -2., 'x');
+    CHECK(buf.field<0>()[0] == -1.f);
+    CHECK(std::get<1>(buf.front()) == -2.);
+
+    auto const& cbuf = buf;
+    auto it = cbuf.begin() + std::ptrdiff_t(numElements - 1);
+    patton::aligned_soa_buffer<std::tuple<float, double, char>, patton::cache_line_alignment>::const_iterator cit = buf.begin();
+    CHECK(it - cit == std::ptrdiff_t(numElements - 1));
+    CHECK(&std::get<0>(*it) == &buf.field<0>()[numElements - 1]);
+    CHECK(std::get<0>(cit[0]) == -1.f);
+
+    auto moved = std::move(buf);
+    CHECK(buf.empty());
+    CHECK(moved.size() == numElements);
+    CHECK(moved.field<0>()[0] == -1.f);
+}
+
+
+TEST_CASE("buffers can be constructed in parallel by a thread squad")
+{
+    int numThreads = GENERATE(1, 3, 8);
+    auto squad = patton::thread_squad({ .num_threads = numThreads });
+
+    SECTION("aligned_buffer<>")
+    {
+        std::size_t numElements = GENERATE(0, 1, 5, 1000);
+        auto buf = patton::aligned_buffer<int, patton::cache_line_alignment>(squad, numElements, 42);
+        CHECK(buf.size() == numElements);
+        CHECK(std::all_of(buf.begin(), buf.end(), [](int x) { return x == 42; }));
+    }
+    SECTION("aligned_row_buffer<>")
+    {
+        std::size_t numRows = GENERATE(0, 1, 5, 100);
+        auto buf = patton::aligned_row_buffer<int, patton::cache_line_alignment>(squad, numRows, 7, std::in_place, 42);
+        CHECK(buf.rows() == numRows);
+        for (auto row : buf)
+        {
+            CHECK(std::all_of(row.begin(), row.end(), [](int x) { return x == 42; }));
+        }
+    }
+    SECTION("aligned_soa_buffer<>")
+    {
+        std::size_t numElements = GENERATE(0, 1, 5, 1000);
+        auto buf = patton::aligned_soa_buffer<std::tuple<int, double>, patton::cache_line_alignment>(squad, numElements, { 42, 1.5 });
+        CHECK(buf.size() == numElements);
+        CHECK(std::all_of(buf.field<0>().begin(), buf.field<0>().end(), [](int x) { return x == 42; }));
+        CHECK(std::all_of(buf.field<1>().begin(), buf.field<1>().end(), [](double x) { return x == 1.5; }));
+    }
+    SECTION("elements are destroyed if construction fails")
+    {
+        counted_element::numConstructed = 0;
+        counted_element::throwAt = GENERATE(0, 17, 99);
+        CHECK_THROWS_AS((patton::aligned_buffer<counted_element, alignof(counted_element)>(squad, 100, std::in_place, 1)), std::runtime_error);
+        CHECK(counted_element::numAlive == 0);
+        counted_element::numConstructed = 0;
+        CHECK_THROWS_AS((patton::aligned_row_buffer<counted_element, alignof(counted_element)>(squad, 10, 10, std::in_place, 1)), std::runtime_error);
+        CHECK(counted_element::numAlive == 0);
+        counted_element::throwAt = -1;
+    }
+}
+
+
+TEST_CASE("replicated_buffer<> holds a replica on every NUMA node")
+{
+    int numThreads = GENERATE(1, 3);
+    auto squad = patton::thread_squad({ .num_threads = numThreads });
+    auto const& topology = patton::cpu_topology::system();
+
+    auto values = std::vector<int>(10000);
+    for (std::size_t i = 0; i != values.size(); ++i)
+    {
+        values[i] = static_cast<int>(i);
+    }
+    auto buf = patton::replicated_buffer<int>(squad, std::span<int const>(values));
+    CHECK(buf.size() == values.size());
+    CHECK(std::equal(buf.numa_nodes().begin(), buf.numa_nodes().end(), topology.numa_nodes().begin(), topology.numa_nodes().end()));
+    for (int numaNode : buf.numa_nodes())
+    {
+        auto const& replica = buf.replica(numaNode);
+        CHECK(std::equal(replica.begin(), replica.end(), values.begin(), values.end()));
+    }
+    auto local = buf.local();
+    CHECK(std::equal(local.begin(), local.end(), values.begin(), values.end()));
+    auto localIsNodeReplica = std::vector<int>(static_cast<std::size_t>(numThreads));
+    squad.run([&](patton::thread_squad::task_context& ctx)
+    {
+        localIsNodeReplica[static_cast<std::size_t>(ctx.thread_index())] = buf.local(ctx).data() == &buf.replica(ctx.numa_node()).front();
+    });
+    CHECK(std::all_of(localIsNodeReplica.begin(), localIsNodeReplica.end(), [](int x) { return x != 0; }));
+
+    auto filled = patton::replicated_buffer<int>(squad, 100, 42);
+    CHECK(std::all_of(filled.local().begin(), filled.local().end(), [](int x) { return x == 42; }));
+}
+
 
 } // anonymous namespace
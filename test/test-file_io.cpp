@@ -0,0 +1,148 @@
+
+#include <patton/file_io.hpp>
+#include <patton/buffer.hpp>  // for aligned_row_buffer<>
+#include <patton/memory.hpp>  // for page_allocator<>, cache_line_alignment
+#include <patton/new.hpp>     // for hardware_page_size(), hardware_cache_line_size()
+#include <patton/thread_squad.hpp>
+
+#include <span>
+#include <string>
+#include <vector>
+#include <cstddef>       // for byte
+#include <cstdint>       // for uint32_t
+#include <fstream>
+#include <numeric>       // for iota()
+#include <algorithm>     // for equal()
+#include <filesystem>
+#include <system_error>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+
+namespace {
+
+
+class temp_file
+{
+private:
+    std::filesystem::path path_;
+
+public:
+    explicit temp_file(std::string const& name, void const* data, std::size_t size)
+        : path_(std::filesystem::temp_directory_path() / ("patton-test-" + name))
+    {
+        auto stream = std::ofstream(path_, std::ios::binary | std::ios::trunc);
+        stream.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+    }
+    ~temp_file()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    std::filesystem::path const&
+    path() const noexcept
+    {
+        return path_;
+    }
+};
+
+
+TEST_CASE("read_file<>() reads files with all threads of a squad")
+{
+    std::size_t pageSize = patton::hardware_page_size();
+    int numThreads = GENERATE(1, 4);
+    std::size_t numElements = GENERATE_COPY(std::size_t(0), pageSize/4, 10*pageSize/4 + 3);
+    auto values = std::vector<std::uint32_t>(numElements);
+    std::iota(values.begin(), values.end(), std::uint32_t(1));
+    auto file = temp_file("read_file", values.data(), values.size()*sizeof(std::uint32_t));
+
+    auto squad = patton::thread_squad({ .num_threads = numThreads });
+    auto params = patton::direct_input_file::params{ .extent_size = 2*pageSize };
+    auto buf = patton::read_file<std::uint32_t>(squad, file.path(), { }, params);
+    CHECK(buf.size() == numElements);
+    CHECK(std::equal(buf.begin(), buf.end(), values.begin(), values.end()));
+}
+
+TEST_CASE("read_file<>() rejects files which do not hold whole elements")
+{
+    char bytes[] = { 1, 2, 3, 4, 5 };
+    auto file = temp_file("read_file-odd", bytes, sizeof bytes);
+    auto squad = patton::thread_squad({ .num_threads = 1 });
+    CHECK_THROWS_AS(patton::read_file<std::uint32_t>(squad, file.path()), std::system_error);
+}
+
+TEST_CASE("direct_input_file reads byte ranges at page-aligned offsets")
+{
+    std::size_t pageSize = patton::hardware_page_size();
+    auto bytes = std::vector<unsigned char>(5*pageSize + 17);
+    for (std::size_t i = 0; i != bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(i*7);
+    }
+    auto file = temp_file("direct_input_file", bytes.data(), bytes.size());
+
+    auto input = patton::direct_input_file(file.path(), { .extent_size = 1 });
+    CHECK(input.size() == bytes.size());
+    CHECK(input.extent_size() == pageSize);
+
+    auto squad = patton::thread_squad({ .num_threads = 3 });
+    auto alloc = patton::page_allocator<std::byte>{ };
+    std::size_t size = 3*pageSize + 5;
+    std::byte* data = alloc.allocate(size);
+    input.read(squad, std::span<std::byte>(data, size), pageSize);
+    CHECK(std::equal(data, data + size, reinterpret_cast<std::byte const*>(bytes.data()) + pageSize));
+    alloc.deallocate(data, size);
+
+    CHECK_THROWS_AS(patton::direct_input_file(file.path().string() + ".missing"), std::system_error);
+}
+
+TEST_CASE("Row buffer snapshots can be mapped back without copying")
+{
+    std::size_t rows = GENERATE(std::size_t(0), std::size_t(1), std::size_t(37));
+    std::size_t cols = GENERATE(std::size_t(5), std::size_t(1024));
+    auto policy = GENERATE(patton::row_stride_policy::aligned, patton::row_stride_policy::anti_aliased);
+    auto src = patton::aligned_row_buffer<float, patton::cache_line_alignment>(rows, cols, policy);
+    for (std::size_t i = 0; i != rows; ++i)
+    {
+        std::iota(src[i].begin(), src[i].end(), float(i*cols));
+    }
+    auto path = std::filesystem::temp_directory_path() / "patton-test-snapshot";
+    auto squad = patton::thread_squad({ .num_threads = 3 });
+    patton::write_snapshot(squad, path, src);
+
+    auto header = patton::read_snapshot_header(path);
+    CHECK(header.rows == rows);
+    CHECK(header.columns == cols);
+    CHECK(header.element_size == sizeof(float));
+    CHECK(header.alignment == patton::hardware_cache_line_size());
+    CHECK(header.row_stride == src.row_stride());
+    CHECK(std::filesystem::file_size(path) == header.data_offset + rows*header.row_stride);
+
+    {
+        auto mapped = patton::map_snapshot<float, patton::cache_line_alignment>(path);
+        CHECK(mapped.rows() == rows);
+        CHECK(mapped.columns() == cols);
+        CHECK(mapped.row_stride() == src.row_stride());
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            CHECK(std::equal(mapped[i].begin(), mapped[i].end(), src[i].begin(), src[i].end()));
+        }
+    }
+
+    CHECK_THROWS_AS((patton::map_snapshot<double, patton::cache_line_alignment>(path)), std::system_error);
+    CHECK_THROWS_AS((patton::map_snapshot<float, 4096>(path)), std::system_error);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("read_snapshot_header() rejects other files")
+{
+    char bytes[100] = { };
+    auto file = temp_file("not-a-snapshot", bytes, sizeof bytes);
+    CHECK_THROWS_AS(patton::read_snapshot_header(file.path()), std::system_error);
+}
+
+
+} // anonymous namespace
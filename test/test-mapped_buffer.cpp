@@ -0,0 +1,226 @@
+
+#include <patton/mapped_buffer.hpp>
+#include <patton/buffer.hpp>
+#include <patton/new.hpp>  // for hardware_large_page_size(), cache_line_alignment
+
+#include <string>
+#include <vector>
+#include <cstdint>       // for uintptr_t
+#include <fstream>
+#include <numeric>       // for iota()
+#include <algorithm>     // for equal()
+#include <filesystem>
+#include <system_error>
+
+#if !defined(_WIN32)
+# include <unistd.h>  // for dup()
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+
+namespace {
+
+
+bool
+is_aligned(void const* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+class temp_file
+{
+private:
+    std::filesystem::path path_;
+
+public:
+    explicit temp_file(std::string const& name, void const* data, std::size_t size)
+        : path_(std::filesystem::temp_directory_path() / ("patton-test-" + name))
+    {
+        auto stream = std::ofstream(path_, std::ios::binary | std::ios::trunc);
+        stream.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+    }
+    ~temp_file()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    std::filesystem::path const&
+    path() const noexcept
+    {
+        return path_;
+    }
+
+    std::vector<char>
+    contents() const
+    {
+        auto stream = std::ifstream(path_, std::ios::binary);
+        return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    }
+};
+
+
+TEST_CASE("mapped_buffer<> maps the elements of a file")
+{
+    auto values = std::vector<float>(10000);
+    std::iota(values.begin(), values.end(), 0.f);
+    auto file = temp_file("mapped_buffer", values.data(), values.size()*sizeof(float));
+
+    SECTION("read-only")
+    {
+        auto buf = patton::mapped_buffer<float const, alignof(float)>(file.path(), patton::map_advice::sequential | patton::map_advice::willneed);
+        CHECK(buf.mapping().access() == patton::file_access::read_only);
+        CHECK(buf.size() == values.size());
+        CHECK(std::equal(buf.begin(), buf.end(), values.begin(), values.end()));
+        CHECK(buf.back() == 9999.f);
+    }
+    SECTION("copy-on-write")
+    {
+        auto buf = patton::mapped_buffer<float, alignof(float)>(file.path());
+        CHECK(buf.mapping().access() == patton::file_access::copy_on_write);
+        buf[0] = 42.f;
+        CHECK(buf.front() == 42.f);
+        auto contents = file.contents();
+        CHECK(std::equal(contents.begin(), contents.end(), reinterpret_cast<char const*>(values.data())));
+    }
+    SECTION("shared")
+    {
+        {
+            auto buf = patton::mapped_buffer<float, alignof(float)>(file.path(), patton::file_access::shared);
+            buf[0] = 42.f;
+            buf.mapping().flush();
+        }
+        values[0] = 42.f;
+        auto contents = file.contents();
+        CHECK(std::equal(contents.begin(), contents.end(), reinterpret_cast<char const*>(values.data())));
+    }
+    SECTION("huge-page alignment")
+    {
+        auto buf = patton::mapped_buffer<float const, alignof(float)>(file.path(), patton::map_advice::hugepage);
+        std::size_t largePageSize = patton::hardware_large_page_size();
+#if defined(__linux__)
+        if (largePageSize != 0)
+        {
+            CHECK(is_aligned(&buf.front(), largePageSize));
+        }
+#endif // defined(__linux__)
+        CHECK(std::equal(buf.begin(), buf.end(), values.begin(), values.end()));
+    }
+}
+
+TEST_CASE("mapped_buffer<> pads elements like aligned_buffer<>")
+{
+    auto src = patton::aligned_buffer<int, patton::cache_line_alignment>(100);
+    std::iota(src.begin(), src.end(), 0);
+    auto file = temp_file("mapped_buffer-padded", &src.front(), static_cast<std::size_t>(reinterpret_cast<char const*>(&src.back() + 1) - reinterpret_cast<char const*>(&src.front())));
+
+        // The file lacks the padding of the last element.
+    CHECK_THROWS_AS((patton::mapped_buffer<int const, patton::cache_line_alignment>(file.path())), std::system_error);
+
+    auto paddedFile = temp_file("mapped_buffer-padded", &src.front(), 100*patton::hardware_cache_line_size());
+    auto buf = patton::mapped_buffer<int const, patton::cache_line_alignment>(paddedFile.path());
+    CHECK(buf.size() == 100);
+    CHECK(std::equal(buf.begin(), buf.end(), src.begin(), src.end()));
+    CHECK(is_aligned(&buf[1], patton::hardware_cache_line_size()));
+}
+
+TEST_CASE("mapped_row_buffer<> maps the rows of a file")
+{
+    std::size_t rows = 20;
+    std::size_t cols = 7;
+    auto src = patton::aligned_row_buffer<double, patton::cache_line_alignment>(rows, cols);
+    for (std::size_t i = 0; i != rows; ++i)
+    {
+        std::iota(src[i].begin(), src[i].end(), double(i*cols));
+    }
+    std::size_t bytesPerRow = static_cast<std::size_t>(reinterpret_cast<char const*>(src[1].data()) - reinterpret_cast<char const*>(src[0].data()));
+    auto file = temp_file("mapped_row_buffer", src[0].data(), rows*bytesPerRow);
+
+    auto buf = patton::mapped_row_buffer<double const, patton::cache_line_alignment>(file.path(), cols);
+    CHECK(buf.rows() == rows);
+    CHECK(buf.columns() == cols);
+    for (std::size_t i = 0; i != rows; ++i)
+    {
+        CHECK(std::equal(buf[i].begin(), buf[i].end(), src[i].begin(), src[i].end()));
+        CHECK(is_aligned(buf[i].data(), patton::hardware_cache_line_size()));
+    }
+    std::size_t numRows = 0;
+    for (auto row : buf)
+    {
+        CHECK(row.size() == cols);
+        ++numRows;
+    }
+    CHECK(numRows == rows);
+}
+
+TEST_CASE("mapped_buffer<> maps empty files")
+{
+    auto file = temp_file("mapped_buffer-empty", nullptr, 0);
+    auto buf = patton::mapped_buffer<float const, alignof(float)>(file.path());
+    CHECK(buf.empty());
+    CHECK(buf.begin() == buf.end());
+}
+
+TEST_CASE("shared_memory can be mapped more than once")
+{
+    std::size_t rows = 20;
+    std::size_t cols = 7;
+    using row_buffer = patton::mapped_row_buffer<double, patton::cache_line_alignment>;
+    using const_row_buffer = patton::mapped_row_buffer<double const, patton::cache_line_alignment>;
+    auto mem = patton::shared_memory(row_buffer::required_size(rows, cols));
+    CHECK(mem.size() == rows*patton::hardware_cache_line_size());
+
+    auto writer = row_buffer(mem.map(), cols);
+    CHECK(writer.rows() == rows);
+    CHECK(writer[rows - 1][cols - 1] == 0.);  // shared memory is zero-initialized
+    for (std::size_t i = 0; i != rows; ++i)
+    {
+        std::iota(writer[i].begin(), writer[i].end(), double(i*cols));
+    }
+
+    SECTION("from the same handle")
+    {
+        auto reader = const_row_buffer(mem.map(patton::file_access::read_only, patton::map_advice::hugepage), cols);
+        REQUIRE(reader.rows() == rows);
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            CHECK(std::equal(reader[i].begin(), reader[i].end(), writer[i].begin(), writer[i].end()));
+            CHECK(is_aligned(reader[i].data(), patton::hardware_cache_line_size()));
+        }
+        writer[3][2] = 42.;
+        CHECK(reader[3][2] == 42.);
+    }
+#if !defined(_WIN32)
+    SECTION("from a duplicated handle")
+    {
+        auto other = patton::shared_memory::from_native_handle(::dup(mem.native_handle()));
+        mem = patton::shared_memory{ };  // mappings and other handles keep the memory alive
+        CHECK(mem.native_handle() == patton::shared_memory::invalid_handle);
+        CHECK(other.size() == row_buffer::required_size(rows, cols));
+        auto reader = const_row_buffer(other.map(patton::file_access::read_only), cols);
+        REQUIRE(reader.rows() == rows);
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            CHECK(std::equal(reader[i].begin(), reader[i].end(), writer[i].begin(), writer[i].end()));
+        }
+    }
+#endif // !defined(_WIN32)
+    SECTION("copy-on-write")
+    {
+        auto copy = row_buffer(mem.map(patton::file_access::copy_on_write), cols);
+        copy[0][0] = 42.;
+        CHECK(writer[0][0] == 0.);
+    }
+}
+
+TEST_CASE("mapped_buffer<>::required_size() accounts for padding")
+{
+    CHECK(patton::mapped_buffer<float, alignof(float)>::required_size(10) == 10*sizeof(float));
+    CHECK(patton::mapped_buffer<float, patton::cache_line_alignment>::required_size(10) == 10*patton::hardware_cache_line_size());
+    CHECK(patton::mapped_row_buffer<float, alignof(float)>::required_size(3, 5) == 15*sizeof(float));
+    CHECK_THROWS_AS((patton::mapped_buffer<float, alignof(float)>::required_size(std::size_t(-1))), std::bad_alloc);
+}
+
+
+} // anonymous namespace
@@ -1,8 +1,16 @@
 
 #include <patton/memory.hpp>
 
+#include <string>
 #include <vector>
-#include <memory>  // for allocator<>
+#include <memory>     // for allocator<>
+#include <cstdint>    // for uintptr_t
+#include <thread>
+#include <fstream>
+#include <algorithm>  // for find(), is_sorted(), min(), fill(), all_of()
+
+#include <patton/new.hpp>       // for hardware_page_size(), hardware_large_page_size()
+#include <patton/topology.hpp>
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
@@ -12,6 +20,32 @@
 namespace {
 
 
+    // Returns whether transparent huge pages can be used, at least for `madvise()`d memory.
+bool
+transparent_huge_pages_enabled()
+{
+#if defined(__linux__)
+    auto f = std::ifstream("/sys/kernel/mm/transparent_hugepage/enabled");
+    auto setting = std::string{ };
+    return std::getline(f, setting) && setting.find("[never]") == std::string::npos;
+#else // !defined(__linux__)
+    return false;
+#endif // defined(__linux__)
+}
+
+#if defined(__linux__)
+    // Returns the number of free pages in the hugetlb page pool of the given page size.
+std::size_t
+free_hugetlb_pages(std::size_t pageSize)
+{
+    auto f = std::ifstream("/sys/kernel/mm/hugepages/hugepages-" + std::to_string(pageSize/1024) + "kB/free_hugepages");
+    std::size_t result = 0;
+    f >> result;
+    return result;
+}
+#endif // defined(__linux__)
+
+
 TEST_CASE("aligned_allocator<> properly aligns allocations")
 {
     constexpr std::size_t alignment = 4 * sizeof(int);
@@ -24,6 +58,82 @@ TEST_CASE("aligned_allocator<> properly aligns allocations")
     // TODO: add checks
 }
 
+TEST_CASE("aligned_allocator<> serves small allocations from thread-local caches")
+{
+    constexpr std::size_t alignment = 64;
+    using Allocator = patton::aligned_allocator<char, alignment>;
+
+    auto alloc = Allocator{ };
+    std::size_t size = GENERATE(0, 1, 64, 100, 4096, 32*1024, 32*1024 + 1);
+    CAPTURE(size);
+    char* data = alloc.allocate(size);
+    CHECK(reinterpret_cast<std::uintptr_t>(data) % alignment == 0);
+    std::fill(data, data + size, 'x');
+    alloc.deallocate(data, size);
+    if (size <= 32*1024)
+    {
+        char* newData = alloc.allocate(size);
+        CHECK(newData == data);
+        alloc.deallocate(newData, size);
+    }
+}
+
+TEST_CASE("aligned_allocator<> can be used concurrently")
+{
+    constexpr int numThreads = 4;
+    constexpr int numBlocks = 1000;
+    using Allocator = patton::aligned_allocator<int, 64>;
+
+        // Every thread frees the blocks allocated by the previous thread, so blocks migrate between thread caches.
+    auto blocks = std::vector<std::vector<int*>>(numThreads);
+    auto succeeded = std::vector<char>(numThreads);
+    auto allocThread = [&](int i)
+    {
+        auto alloc = Allocator{ };
+        bool success = true;
+        for (int j = 0; j < numBlocks; ++j)
+        {
+            int* block = alloc.allocate(std::size_t(j % 20 + 1));
+            success = success && reinterpret_cast<std::uintptr_t>(block) % 64 == 0;
+            std::fill(block, block + j % 20 + 1, i);
+            blocks[i].push_back(block);
+        }
+        succeeded[i] = success;
+    };
+    auto freeThread = [&](int i)
+    {
+        auto alloc = Allocator{ };
+        bool success = true;
+        for (int j = 0; j < numBlocks; ++j)
+        {
+            int* block = blocks[i][j];
+            success = success && std::all_of(block, block + j % 20 + 1, [i](int v) { return v == i; });
+            alloc.deallocate(block, std::size_t(j % 20 + 1));
+        }
+        succeeded[i] = succeeded[i] && success;
+    };
+
+    auto threads = std::vector<std::thread>{ };
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(allocThread, i);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(freeThread, (i + 1) % numThreads);
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(std::all_of(succeeded.begin(), succeeded.end(), [](char s) { return s != 0; }));
+}
+
 TEST_CASE("aligned_allocator_adaptor<> properly aligns allocations")
 {
     constexpr std::size_t alignment = 4 * sizeof(int);
@@ -36,6 +146,231 @@ TEST_CASE("aligned_allocator_adaptor<> properly aligns allocations")
     // TODO: add checks
 }
 
+TEST_CASE("numa_allocator<> places pages on NUMA nodes")
+{
+    auto const& topology = patton::cpu_topology::system();
+    int numaNode = topology.numa_nodes().front();
+    auto policy = GENERATE(patton::numa_policy::preferred, patton::numa_policy::bind, patton::numa_policy::interleave);
+    std::size_t numElements = GENERATE(std::size_t(1), std::size_t(100000));
+
+    auto alloc = patton::numa_allocator<int>(policy, numaNode);
+    CHECK(alloc == patton::numa_allocator<char>(alloc));
+    CHECK(alloc != patton::numa_allocator<int>{ });
+
+    auto v = std::vector<int, patton::numa_allocator<int>>(numElements, 42, alloc);
+    CHECK(reinterpret_cast<std::uintptr_t>(v.data()) % patton::hardware_page_size() == 0);
+
+    auto nodes = patton::page_numa_nodes(v.data(), v.size()*sizeof(int));
+    CHECK(nodes.size() == (v.size()*sizeof(int) + patton::hardware_page_size() - 1) / patton::hardware_page_size());
+    for (int node : nodes)
+    {
+            // The policy is a hint except for `bind`, and the location of pages cannot be determined on every platform.
+        CHECK((node == -1 || topology.numa_nodes().end() != std::find(topology.numa_nodes().begin(), topology.numa_nodes().end(), node)));
+        if (policy == patton::numa_policy::bind && node != -1)
+        {
+            CHECK(node == numaNode);
+        }
+    }
+}
+
+TEST_CASE("aligned_allocator_adaptor<> works with numa_allocator<>")
+{
+    using Allocator = patton::aligned_allocator_adaptor<int, patton::large_page_alignment, patton::numa_allocator<int>>;
+
+        // Without large pages, `large_page_alignment` amounts to page alignment.
+    std::size_t alignment = patton::hardware_large_page_size();
+    if (alignment == 0) alignment = patton::hardware_page_size();
+
+    std::size_t numElements = GENERATE(range(0, 9));
+    auto v = std::vector<int, Allocator>(numElements, 1);
+    if (numElements != 0)
+    {
+        CHECK(reinterpret_cast<std::uintptr_t>(v.data()) % alignment == 0);
+    }
+}
+
+TEST_CASE("page_numa_nodes() reports untouched pages")
+{
+    auto alloc = patton::page_allocator<char>{ };
+    std::size_t size = 4*patton::hardware_page_size();
+    char* data = alloc.allocate(size);
+    data[0] = 1;
+    auto nodes = patton::page_numa_nodes(data + 1, size - 2);
+    CHECK(nodes.size() == 4);
+    CHECK(nodes[3] == -1);
+    alloc.deallocate(data, size);
+}
+
+TEST_CASE("page_allocator<> pre-faults allocations")
+{
+    auto flags = GENERATE(patton::page_flags::populate, patton::page_flags::lock, patton::page_flags::populate | patton::page_flags::lock);
+    auto alloc = patton::page_allocator<char>(flags);
+    CHECK(alloc.flags() == flags);
+    CHECK(alloc != patton::page_allocator<char>{ });
+    CHECK(patton::page_allocator<int>(alloc) == alloc);
+
+    std::size_t size = 4*patton::hardware_page_size();
+    char* data = alloc.allocate(size);
+#if defined(__linux__)
+    auto nodes = patton::page_numa_nodes(data, size);
+    CHECK(std::find(nodes.begin(), nodes.end(), -1) == nodes.end());
+#endif // defined(__linux__)
+    data[size - 1] = 1;
+    alloc.deallocate(data, size);
+}
+
+TEST_CASE("page_allocator<> locks cached page runs again")
+{
+    std::size_t size = 4*patton::hardware_page_size();
+    patton::set_page_cache_capacity(size);
+    auto alloc = patton::page_allocator<char>(patton::page_flags::lock);
+    char* data = alloc.allocate(size);
+    alloc.deallocate(data, size);
+    data = alloc.allocate(size);
+#if defined(__linux__)
+    auto nodes = patton::page_numa_nodes(data, size);
+    CHECK(std::find(nodes.begin(), nodes.end(), -1) == nodes.end());
+#endif // defined(__linux__)
+    alloc.deallocate(data, size);
+    patton::set_page_cache_capacity(0);
+}
+
+TEST_CASE("large_page_allocator<> returns large-page-aligned allocations")
+{
+    std::size_t largePageSize = patton::hardware_large_page_size();
+    if (largePageSize == 0) return;
+
+    auto flags = GENERATE(patton::page_flags::none, patton::page_flags::populate, patton::page_flags::populate | patton::page_flags::collapse);
+    std::size_t size = GENERATE_COPY(std::size_t(1), largePageSize, 3*largePageSize + 1);
+
+    auto alloc = patton::large_page_allocator<char>(flags);
+    CHECK(alloc == patton::large_page_allocator<int>(alloc));
+    char* data = alloc.allocate(size);
+    CHECK(reinterpret_cast<std::uintptr_t>(data) % largePageSize == 0);
+    data[0] = 1;
+    data[size - 1] = 1;
+    std::size_t largePageBytes = patton::large_page_backed_size(data, size);
+    if ((flags & patton::page_flags::collapse) != patton::page_flags::none && transparent_huge_pages_enabled())
+    {
+        CHECK(largePageBytes == size);
+    }
+    else
+    {
+        CHECK(largePageBytes <= size);
+    }
+    alloc.deallocate(data, size);
+}
+
+TEST_CASE("large_page_allocator<> falls back to transparent huge pages if the hugetlb pool is exhausted")
+{
+    auto pageSizes = patton::hardware_large_page_sizes();
+    CHECK(std::is_sorted(pageSizes.begin(), pageSizes.end()));
+    for (std::size_t pageSize : pageSizes)
+    {
+        CAPTURE(pageSize);
+        CHECK(pageSize % patton::hardware_page_size() == 0);
+
+        auto alloc = patton::large_page_allocator<char>(pageSize, patton::page_flags::populate);
+        CHECK(alloc.page_size() == pageSize);
+        CHECK(alloc != patton::large_page_allocator<char>{ });
+        std::size_t size = pageSize + 1;
+#if defined(__linux__)
+            // The allocation needs two pages from the pool; if there are fewer, it must fall back to transparent huge pages.
+        bool expectHugetlb = free_hugetlb_pages(pageSize) >= 2;
+#endif // defined(__linux__)
+        char* data = alloc.allocate(size);
+        std::size_t obtainedPageSize = patton::large_page_allocation_page_size(data);
+#if defined(__linux__)
+        CAPTURE(expectHugetlb);
+        CHECK(obtainedPageSize == (expectHugetlb ? pageSize : 0));
+#else // !defined(__linux__)
+        CHECK(obtainedPageSize == patton::hardware_large_page_size());
+#endif // defined(__linux__)
+        CHECK(reinterpret_cast<std::uintptr_t>(data) % std::min(pageSize, patton::hardware_large_page_size()) == 0);
+        data[size - 1] = 1;
+        alloc.deallocate(data, size);
+    }
+}
+
+TEST_CASE("large_page_backed_size() reports no large pages for page allocations")
+{
+    auto alloc = patton::page_allocator<char>{ };
+    std::size_t size = 4*patton::hardware_page_size();
+    char* data = alloc.allocate(size);
+    data[0] = 1;
+    CHECK(patton::large_page_backed_size(data, size) == 0);
+    CHECK(patton::large_page_backed_size(data, 0) == 0);
+    alloc.deallocate(data, size);
+}
+
+TEST_CASE("page_allocator<> reuses cached page runs")
+{
+    REQUIRE(patton::page_cache_capacity() == 0);
+    std::size_t pageSize = patton::hardware_page_size();
+    patton::set_page_cache_capacity(16*pageSize);
+    CHECK(patton::page_cache_capacity() == 16*pageSize);
+
+    auto alloc = patton::page_allocator<char>{ };
+    std::size_t size = 4*pageSize - 1;
+    char* data = alloc.allocate(size);
+    data[size - 1] = 1;
+    alloc.deallocate(data, size);
+
+    SECTION("allocation of the same size is served from the cache")
+    {
+        char* newData = alloc.allocate(4*pageSize - 2);
+        CHECK(newData == data);
+        alloc.deallocate(newData, 4*pageSize - 2);
+    }
+#if !defined(_WIN32)  // `VirtualFree()` cannot release part of an allocation, so Windows only reuses runs of the same size
+    SECTION("smaller allocation is served from a cached run at most twice as large")
+    {
+        char* newData = alloc.allocate(3*pageSize);
+        CHECK(newData == data);
+        newData[3*pageSize - 1] = 1;
+        alloc.deallocate(newData, 3*pageSize);
+    }
+#endif // !defined(_WIN32)
+    SECTION("allocation much smaller than the cached runs is not served from the cache")
+    {
+        char* newData = alloc.allocate(pageSize);
+        CHECK(newData != data);
+        alloc.deallocate(newData, pageSize);
+    }
+    SECTION("allocation larger than the cached runs is not served from the cache")
+    {
+        char* newData = alloc.allocate(5*pageSize);
+        CHECK(newData != data);
+        alloc.deallocate(newData, 5*pageSize);
+    }
+    SECTION("trimming releases cached page runs")
+    {
+        patton::trim_page_cache();
+        CHECK(patton::page_cache_capacity() == 16*pageSize);
+        char* newData = alloc.allocate(size);
+        newData[size - 1] = 1;
+        alloc.deallocate(newData, size);
+    }
+    SECTION("NUMA allocations bypass the cache")
+    {
+        auto numaAlloc = patton::numa_allocator<char>{ };
+        char* numaData = numaAlloc.allocate(size);
+        CHECK(numaData != data);
+        numaAlloc.deallocate(numaData, size);
+    }
+    SECTION("runs exceeding the capacity are not cached")
+    {
+        std::size_t largeSize = 32*pageSize;
+        char* largeData = alloc.allocate(largeSize);
+        alloc.deallocate(largeData, largeSize);
+        char* newData = alloc.allocate(size);
+        CHECK(newData == data);
+        alloc.deallocate(newData, size);
+    }
+
+    patton::set_page_cache_capacity(0);
+}
+
 // TODO: add tests for allocate_unique<>()
 
 
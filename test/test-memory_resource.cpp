@@ -0,0 +1,118 @@
+
+#include <patton/memory_resource.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>          // for uintptr_t
+#include <memory_resource>
+
+#include <patton/new.hpp>  // for hardware_page_size(), hardware_large_page_size(), hardware_cache_line_size()
+
+#include <catch2/catch_test_macros.hpp>
+
+
+namespace {
+
+
+bool
+is_aligned(void const* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+
+TEST_CASE("aligned_memory_resource properly aligns allocations")
+{
+    std::size_t alignment = patton::hardware_cache_line_size();
+    auto resource = patton::aligned_memory_resource(alignment);
+    CHECK(resource.alignment() == alignment);
+    CHECK(resource.is_equal(patton::aligned_memory_resource(alignment)));
+    CHECK(!resource.is_equal(patton::aligned_memory_resource(2*alignment)));
+    CHECK(!resource.is_equal(*std::pmr::new_delete_resource()));
+
+    auto v = std::pmr::vector<char>(3, &resource);
+    CHECK(is_aligned(v.data(), alignment));
+    void* p = resource.allocate(16, 4*alignment);
+    CHECK(is_aligned(p, 4*alignment));
+    resource.deallocate(p, 16, 4*alignment);
+}
+
+TEST_CASE("page_memory_resource returns page-aligned allocations")
+{
+    auto resource = patton::page_memory_resource(patton::page_flags::populate);
+    CHECK(resource.flags() == patton::page_flags::populate);
+    CHECK(resource.is_equal(patton::page_memory_resource(patton::page_flags::populate)));
+    CHECK(!resource.is_equal(patton::page_memory_resource{ }));
+
+    auto v = std::pmr::vector<int>(100, 42, &resource);
+    CHECK(is_aligned(v.data(), patton::hardware_page_size()));
+    CHECK(v.back() == 42);
+}
+
+TEST_CASE("large_page_memory_resource returns large-page-aligned allocations")
+{
+    if (patton::hardware_large_page_size() == 0) return;
+
+    auto resource = patton::large_page_memory_resource{ };
+    CHECK(resource.page_size() == 0);
+    CHECK(!resource.is_equal(patton::large_page_memory_resource(patton::page_flags::populate)));
+
+    auto v = std::pmr::vector<int>(100, 42, &resource);
+    CHECK(is_aligned(v.data(), patton::hardware_large_page_size()));
+    CHECK(v.back() == 42);
+}
+
+TEST_CASE("large_page_arena_resource carves allocations out of large page chunks")
+{
+    std::size_t largePageSize = patton::hardware_large_page_size();
+    if (largePageSize == 0) return;
+
+    auto arena = patton::large_page_arena_resource{ };
+    CHECK(arena.chunk_size() == largePageSize);
+    CHECK(arena.reserved_size() == 0);
+    CHECK(arena.is_equal(arena));
+    CHECK(!arena.is_equal(patton::large_page_arena_resource{ }));
+
+    SECTION("small allocations share a chunk")
+    {
+        void* p1 = arena.allocate(24, 8);
+        CHECK(is_aligned(p1, largePageSize));
+        void* p2 = arena.allocate(1, 1);
+        CHECK(static_cast<char*>(p2) == static_cast<char*>(p1) + 24);
+        void* p3 = arena.allocate(64, 64);
+        CHECK(is_aligned(p3, 64));
+        CHECK(static_cast<char*>(p3) - static_cast<char*>(p1) == 64);
+        CHECK(arena.reserved_size() == largePageSize);
+
+        auto m = std::pmr::map<int, std::pmr::string>(&arena);
+        for (int i = 0; i < 100; ++i)
+        {
+            m.emplace(i, std::pmr::string(100, 'x'));
+        }
+        CHECK(arena.reserved_size() == largePageSize);
+    }
+    SECTION("allocations larger than the chunk size obtain a chunk of their own")
+    {
+        void* p1 = arena.allocate(8, 8);
+        void* p2 = arena.allocate(2*largePageSize, 8);
+        CHECK(is_aligned(p2, largePageSize));
+        CHECK(arena.reserved_size() == 3*largePageSize);
+        void* p3 = arena.allocate(8, 8);
+        CHECK(static_cast<char*>(p3) == static_cast<char*>(p1) + 8);
+    }
+    SECTION("release() returns all chunks")
+    {
+        auto v = std::pmr::vector<double>(&arena);
+        v.resize(largePageSize);  // forces reallocation into several chunks
+        v = { };
+        CHECK(arena.reserved_size() > largePageSize);
+        arena.release();
+        CHECK(arena.reserved_size() == 0);
+        void* p = arena.allocate(8, 8);
+        CHECK(is_aligned(p, largePageSize));
+    }
+}
+
+
+} // anonymous namespace
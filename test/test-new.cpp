@@ -1,5 +1,6 @@
 
 #include <patton/new.hpp>
+#include <patton/memory.hpp>
 
 #include <iostream>
 
@@ -24,6 +25,16 @@ TEST_CASE("hardware_cache_line_size() returns correct value")
 #endif // defined(_M_IX86) || defined(_M_AMD64) || defined(__i386__) || defined(__x86_64__)
 }
 
+TEST_CASE("hardware_destructive_interference_size() returns sane value")
+{
+    std::size_t destructiveInterferenceSize = patton::hardware_destructive_interference_size();
+    std::cout << "Destructive interference size: " << destructiveInterferenceSize << " B\n";
+
+    CHECK(is_power_of_2(destructiveInterferenceSize));
+    CHECK(destructiveInterferenceSize >= patton::hardware_cache_line_size());
+    CHECK(destructiveInterferenceSize <= patton::max_hardware_destructive_interference_size);
+}
+
 TEST_CASE("hardware_page_size() returns correct value")
 {
     std::size_t pageSize = patton::hardware_page_size();
@@ -42,3 +53,38 @@ TEST_CASE("hardware_large_page_size() returns sane value")
 
     if (largePageSize != 0) CHECK(is_power_of_2(largePageSize));
 }
+
+#if defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
+TEST_CASE("special alignments are resolved at compile time if hardware constants are given")
+{
+    static_assert(patton::hardware_cache_line_size() == PATTON_HARDWARE_CACHE_LINE_SIZE);
+    static_assert(patton::detail::alignment_in_bytes(patton::cache_line_alignment) == PATTON_HARDWARE_CACHE_LINE_SIZE);
+    static_assert(patton::provides_static_alignment(patton::page_alignment, PATTON_HARDWARE_PAGE_SIZE));
+    static_assert(patton::provides_static_alignment(patton::page_alignment, patton::cache_line_alignment));
+
+    CHECK(patton::detail::hardware_constants_checked);
+}
+#endif // defined(PATTON_DETAIL_HARDWARE_CONSTANTS_KNOWN)
+
+TEST_CASE("hardware_cache_size() and related functions return sane values")
+{
+    for (int level = 1; level <= 3; ++level)
+    {
+        std::size_t cacheSize = patton::hardware_cache_size(level);
+        std::size_t cacheSizePerThread = patton::hardware_cache_size_per_thread(level);
+        int associativity = patton::hardware_cache_associativity(level);
+        std::cout << "L" << level << " cache size: " << cacheSize << " B (" << cacheSizePerThread << " B per thread), "
+                  << associativity << "-way associative\n";
+
+        CHECK(cacheSizePerThread <= cacheSize);
+        CHECK(associativity >= 0);
+        if (cacheSize != 0)
+        {
+            CHECK(cacheSize % patton::hardware_cache_line_size() == 0);
+            CHECK(cacheSizePerThread != 0);
+        }
+    }
+    CHECK(patton::hardware_cache_size(9) == 0);
+    CHECK(patton::hardware_cache_size_per_thread(9) == 0);
+    CHECK(patton::hardware_cache_associativity(9) == 0);
+}
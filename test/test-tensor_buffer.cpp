@@ -0,0 +1,125 @@
+
+#include <patton/tensor_buffer.hpp>
+#include <patton/new.hpp>  // for hardware_cache_line_size(), cache_line_alignment
+#include <patton/thread_squad.hpp>
+
+#include <array>
+#include <utility>    // for move()
+#include <cstdint>    // for uintptr_t
+#include <cstddef>    // for size_t
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+
+namespace {
+
+
+bool
+is_aligned(void const* p, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+
+TEST_CASE("aligned_tensor_buffer<> aligns the innermost dimension")
+{
+    std::size_t cacheLineSize = patton::hardware_cache_line_size();
+    auto buf = patton::aligned_tensor_buffer<float, 3, patton::cache_line_alignment>({ 4, 5, 3 });
+    CHECK(buf.rank() == 3);
+    CHECK(buf.extent(0) == 4);
+    CHECK(buf.extent(2) == 3);
+    CHECK(buf.size() == 60);
+    CHECK(buf.stride(2) == 1);
+    CHECK(buf.stride(1) == cacheLineSize/sizeof(float));
+    CHECK(buf.stride(0) == 5*buf.stride(1));
+    for (std::size_t i = 0; i != 4; ++i)
+    {
+        for (std::size_t j = 0; j != 5; ++j)
+        {
+            CHECK(is_aligned(&buf(i, j, 0), cacheLineSize));
+            for (std::size_t k = 0; k != 3; ++k)
+            {
+                CHECK(buf(i, j, k) == 0.f);
+                buf(i, j, k) = float(100*i + 10*j + k);
+            }
+        }
+    }
+    CHECK(buf[{ 3, 4, 2 }] == 342.f);
+    CHECK(buf[2][1][0] == 210.f);
+    CHECK(&buf[2][1][2] == &buf(2, 1, 2));
+
+    auto plane = buf.view()[1];
+    CHECK(plane.extents() == std::array<std::size_t, 2>{ 5, 3 });
+    CHECK(plane(4, 1) == 141.f);
+}
+
+TEST_CASE("aligned_tensor_buffer<> pads strides to the given extents")
+{
+    std::size_t cacheLineSize = patton::hardware_cache_line_size();
+    auto buf = patton::aligned_tensor_buffer<double, 3, patton::cache_line_alignment>({ 2, 6, 8 }, { 0, 7, 9 });
+    std::size_t lineStride = (9*sizeof(double) + cacheLineSize - 1)/cacheLineSize*cacheLineSize/sizeof(double);
+    CHECK(buf.stride(1) == lineStride);
+    CHECK(buf.stride(0) == 7*lineStride);
+    CHECK(buf.size() == 2*6*8);
+
+    auto unaligned = patton::aligned_tensor_buffer<char, 2, 1>({ 3, 5 });
+    CHECK(unaligned.stride(0) == 5);
+
+    auto empty = patton::aligned_tensor_buffer<int, 2, patton::cache_line_alignment>({ 0, 10 });
+    CHECK(empty.empty());
+}
+
+TEST_CASE("tensor_view<> slices and partitions along any axis")
+{
+    int numThreads = GENERATE(1, 3);
+    auto squad = patton::thread_squad({ .num_threads = numThreads });
+    auto buf = patton::aligned_tensor_buffer<int, 3, patton::cache_line_alignment>(squad, { 7, 4, 5 });
+
+    std::size_t axis = GENERATE(std::size_t(0), std::size_t(1), std::size_t(2));
+    squad.run([&](patton::thread_squad::task_context& ctx)
+    {
+        auto part = buf.partition(ctx, axis);
+        for (std::size_t i = 0; i != part.extent(0); ++i)
+        {
+            for (std::size_t j = 0; j != part.extent(1); ++j)
+            {
+                for (std::size_t k = 0; k != part.extent(2); ++k)
+                {
+                    ++part(i, j, k);
+                }
+            }
+        }
+    });
+    std::size_t numVisited = 0;
+    for (std::size_t i = 0; i != 7; ++i)
+    {
+        for (std::size_t j = 0; j != 4; ++j)
+        {
+            for (std::size_t k = 0; k != 5; ++k)
+            {
+                CHECK(buf(i, j, k) == 1);
+                numVisited += std::size_t(buf(i, j, k));
+            }
+        }
+    }
+    CHECK(numVisited == buf.size());
+
+    auto slice = patton::tensor_view<int const, 3>(buf.view()).slice(2, 1, 4);
+    CHECK(slice.extents() == std::array<std::size_t, 3>{ 7, 4, 3 });
+    CHECK(&slice(6, 3, 0) == &buf(6, 3, 1));
+}
+
+TEST_CASE("aligned_tensor_buffer<> is movable")
+{
+    auto buf = patton::aligned_tensor_buffer<int, 2, patton::cache_line_alignment>({ 3, 3 });
+    buf(1, 1) = 42;
+    auto moved = std::move(buf);
+    CHECK(moved(1, 1) == 42);
+    CHECK(buf.empty());
+    buf = std::move(moved);
+    CHECK(buf(1, 1) == 42);
+}
+
+
+} // anonymous namespace
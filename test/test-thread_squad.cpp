@@ -1,13 +1,27 @@
 
+#include <patton/new.hpp>     // for hardware_page_size()
 #include <patton/thread.hpp>
+#include <patton/memory.hpp>  // for page_allocator<>, page_numa_nodes(), set_page_cache_capacity()
+#include <patton/topology.hpp>
 #include <patton/thread_squad.hpp>
 
+#include <span>
+#include <atomic>
 #include <thread>
 #include <mutex>
+#include <vector>
+#include <cstdint>     // for uintptr_t
+#include <utility>     // for pair<>
+#include <numeric>     // for iota()
 #include <algorithm>
+#include <functional>  // for logical_and<>
 #include <unordered_set>
 #include <unordered_map>
 
+#ifdef __linux__
+# include <sched.h>  // for sched_getaffinity(), CPU_ISSET()
+#endif // __linux__
+
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/generators/catch_generators_range.hpp>
@@ -18,6 +32,57 @@
 #endif // defined(_WIN32) || defined(__linux__)
 
 
+#ifdef __linux__
+std::vector<int>
+current_thread_affinity()
+{
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    REQUIRE(::sched_getaffinity(0, sizeof cpuSet, &cpuSet) == 0);
+    auto result = std::vector<int>{ };
+    for (int cpu = 0; cpu != CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &cpuSet))
+        {
+            result.push_back(cpu);
+        }
+    }
+    return result;
+}
+
+std::vector<int>
+expected_domain_members(patton::cpu_topology const& topology, int hardwareThreadId, patton::affinity_domain domain)
+{
+    auto members = std::span<int const>{ };
+    if (topology.contains(hardwareThreadId))
+    {
+        switch (domain)
+        {
+        case patton::affinity_domain::hardware_thread:
+            break;
+        case patton::affinity_domain::core:
+            members = topology.core_hardware_threads(topology.hardware_thread(hardwareThreadId).core);
+            break;
+        case patton::affinity_domain::last_level_cache:
+            if (auto cache = topology.last_level_cache(hardwareThreadId))
+            {
+                members = cache->hardware_threads;
+            }
+            break;
+        case patton::affinity_domain::numa_node:
+            members = topology.numa_node_hardware_threads(topology.hardware_thread(hardwareThreadId).numa_node);
+            break;
+        }
+    }
+    if (members.empty())
+    {
+        return { hardwareThreadId };
+    }
+    return { members.begin(), members.end() };
+}
+#endif // __linux__
+
+
 template <typename T>
 struct non_default_initializable
 {
@@ -207,3 +272,270 @@ TEST_CASE("thread_squad")
         }
     }
 }
+
+TEST_CASE("thread_squad reductions combine results in thread order")
+{
+    int numThreads = GENERATE(1, 9, 70);
+    CAPTURE(numThreads);
+
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ numThreads
+    };
+#ifdef THREAD_PINNING_SUPPORTED
+    params.pin_to_hardware_threads = GENERATE(false, true);
+#endif // !THREAD_PINNING_SUPPORTED
+
+        // Concatenation is associative but not commutative.
+    auto concat = [](std::vector<int> lhs, std::vector<int> rhs)
+    {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return lhs;
+    };
+
+    auto threadSquad = patton::thread_squad(params);
+    for (int concurrency = 1; concurrency <= numThreads; concurrency += (concurrency < 10 ? 1 : 7))
+    {
+        CAPTURE(concurrency);
+        auto expected = std::vector<int>(concurrency);
+        std::iota(expected.begin(), expected.end(), 0);
+
+        auto result = threadSquad.transform_reduce(
+            [](patton::thread_squad::task_context const& ctx)
+            {
+                return std::vector<int>{ ctx.thread_index() };
+            },
+            std::vector<int>{ },
+            concat,
+            concurrency);
+        CHECK(result == expected);
+
+        bool syncResultIsInOrderForEveryThread = threadSquad.transform_reduce(
+            [&concat, &expected](patton::thread_squad::task_context& ctx)
+            {
+                return ctx.reduce(std::vector<int>{ ctx.thread_index() }, concat) == expected;
+            },
+            true,
+            std::logical_and<>{ },
+            concurrency);
+        CHECK(syncResultIsInOrderForEveryThread);
+    }
+}
+
+TEST_CASE("thread_squad reductions destroy every result exactly once")
+{
+        // Results this large are kept in page-allocated slots.
+    struct large_result
+    {
+        std::atomic<int>* numLive;
+        char payload[4096];
+
+        explicit large_result(std::atomic<int>& _numLive)
+            : numLive(&_numLive), payload{ }
+        {
+            ++*numLive;
+        }
+        large_result(large_result const& rhs)
+            : numLive(rhs.numLive), payload{ }
+        {
+            ++*numLive;
+        }
+        large_result&
+        operator =(large_result const&) = default;
+        ~large_result()
+        {
+            --*numLive;
+        }
+    };
+
+    int numThreads = GENERATE(1, 9);
+    CAPTURE(numThreads);
+
+    std::atomic<int> numLive = 0;
+    {
+        auto threadSquad = patton::thread_squad(patton::thread_squad::params{ /*.num_threads = */ numThreads });
+        auto result = threadSquad.transform_reduce(
+            [&numLive](patton::thread_squad::task_context&)
+            {
+                return large_result(numLive);
+            },
+            large_result(numLive),
+            [](large_result lhs, large_result const&)
+            {
+                return lhs;
+            });
+        CHECK(numLive == 1);
+    }
+    CHECK(numLive == 0);
+}
+
+TEST_CASE("thread_squad reductions place large result slots on the NUMA nodes of their threads")
+{
+    struct large_result
+    {
+        char payload[4096];
+    };
+    using slot_data = patton::detail::thread_reduce_data<large_result>;
+
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ static_cast<int>(std::thread::hardware_concurrency())
+    };
+#ifdef THREAD_PINNING_SUPPORTED
+    params.pin_to_hardware_threads = true;
+#endif // THREAD_PINNING_SUPPORTED
+    auto threadSquad = patton::thread_squad(params);
+    std::size_t numThreads = static_cast<std::size_t>(threadSquad.num_threads());
+
+        // Fill the page cache with a run of the size of the slot buffer which has been placed by the main thread.
+    std::size_t pageSize = patton::hardware_page_size();
+    std::size_t stride = (sizeof(slot_data) + pageSize - 1)/pageSize*pageSize;
+    REQUIRE(patton::page_cache_capacity() == 0);
+    patton::set_page_cache_capacity(4*numThreads*stride);
+    auto alloc = patton::page_allocator<char>{ };
+    char* cachedRun = alloc.allocate(numThreads*stride);
+    std::fill(cachedRun, cachedRun + numThreads*stride, char(1));
+    alloc.deallocate(cachedRun, numThreads*stride);
+
+    auto numaNodes = std::vector<int>(numThreads, -1);
+    {
+        auto slots = patton::detail::thread_reduce_buffer<large_result>(threadSquad.num_threads());
+        CHECK(static_cast<char*>(slots.slot(0)) != cachedRun);
+        threadSquad.run(
+            [&slots, &numaNodes]
+            (patton::thread_squad::task_context ctx)
+            {
+                std::size_t i = static_cast<std::size_t>(ctx.thread_index());
+                std::fill_n(static_cast<char*>(slots.slot(i)), sizeof(slot_data), char(1));
+                numaNodes[i] = patton::current_numa_node();
+            });
+        for (std::size_t i = 0; i != numThreads; ++i)
+        {
+            CAPTURE(i);
+            auto pageNumaNodes = patton::page_numa_nodes(slots.slot(i), sizeof(slot_data));
+            CHECK(reinterpret_cast<std::uintptr_t>(slots.slot(i)) % pageSize == 0);
+#ifdef THREAD_PINNING_SUPPORTED
+            if (numaNodes[i] >= 0 && pageNumaNodes.front() >= 0)
+            {
+                CHECK(std::all_of(pageNumaNodes.begin(), pageNumaNodes.end(), [&](int node) { return node == numaNodes[i]; }));
+            }
+#endif // THREAD_PINNING_SUPPORTED
+        }
+    }
+
+    patton::set_page_cache_capacity(0);
+}
+
+TEST_CASE("thread_squad wakes up threads which did not participate in the first task")
+{
+    int numThreads = GENERATE(9, 70);
+    CAPTURE(numThreads);
+
+    std::mutex mutex;
+    auto threadIndices = std::unordered_set<int>{ };
+    auto action = [&]
+    (patton::thread_squad::task_context ctx)
+    {
+        auto lock = std::unique_lock<std::mutex>(mutex);
+        threadIndices.insert(ctx.thread_index());
+    };
+
+        // Only the first thread is signaled when the threads are forked; the others are woken up by their superordinate
+        // threads in the second task.
+    auto threadSquad = patton::thread_squad(patton::thread_squad::params{ /*.num_threads = */ numThreads });
+    threadSquad.run(action, 1);
+    CHECK(threadIndices.size() == 1);
+    threadSquad.run(action);
+    CHECK(threadIndices.size() == static_cast<std::size_t>(numThreads));
+}
+
+#ifdef THREAD_PINNING_SUPPORTED
+TEST_CASE("thread_squad with coarse pinning domains")
+{
+    int numHardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ numHardwareThreads
+    };
+    params.pin_to_hardware_threads = true;
+    params.pinning_domain = GENERATE(
+        patton::affinity_domain::hardware_thread,
+        patton::affinity_domain::core,
+        patton::affinity_domain::last_level_cache,
+        patton::affinity_domain::numa_node);
+    CAPTURE(params.pinning_domain);
+
+    std::mutex mutex;
+    auto threadIndex_Count = std::unordered_map<int, int>{ };
+#ifdef __linux__
+    auto threadIndex_Affinity = std::unordered_map<int, std::vector<int>>{ };
+#endif // __linux__
+    auto action = [&]
+    (patton::thread_squad::task_context ctx)
+    {
+#ifdef __linux__
+        auto affinity = current_thread_affinity();
+#endif // __linux__
+        auto lock = std::unique_lock<std::mutex>(mutex);
+        ++threadIndex_Count[ctx.thread_index()];
+#ifdef __linux__
+        threadIndex_Affinity[ctx.thread_index()] = std::move(affinity);
+#endif // __linux__
+    };
+
+    int numTasks = 5;
+    auto threadSquad = patton::thread_squad(params);
+    for (int i = 0; i < numTasks; ++i)
+    {
+        threadSquad.run(action);
+    }
+
+    CHECK(threadIndex_Count.size() == static_cast<std::size_t>(numHardwareThreads));
+    for (auto const& index_count : threadIndex_Count)
+    {
+        CHECK(index_count.second == numTasks);
+    }
+
+#ifdef __linux__
+        // Every thread must be bound to exactly the hardware threads of one domain.
+    auto const& topology = patton::cpu_topology::system();
+    for (auto const& [threadIndex, affinity] : threadIndex_Affinity)
+    {
+        CAPTURE(threadIndex);
+        REQUIRE(!affinity.empty());
+        CHECK(affinity == expected_domain_members(topology, affinity.front(), params.pinning_domain));
+    }
+#endif // __linux__
+}
+#endif // THREAD_PINNING_SUPPORTED
+
+#ifdef THREAD_PINNING_SUPPORTED
+TEST_CASE("thread_squad reports the NUMA nodes of pinned threads")
+{
+    auto const& topology = patton::cpu_topology::system();
+    auto params = patton::thread_squad::params{
+        /*.num_threads = */ static_cast<int>(std::thread::hardware_concurrency())
+    };
+    params.pin_to_hardware_threads = true;
+
+        // The per-thread data of the squad is placed on the NUMA node reported by `numa_node()`, so it must be the node the
+        // thread actually runs on.
+    std::mutex mutex;
+    auto threadIndex_NumaNodes = std::unordered_map<int, std::pair<int, int>>{ };
+    auto threadSquad = patton::thread_squad(params);
+    threadSquad.run(
+        [&]
+        (patton::thread_squad::task_context ctx)
+        {
+            auto numaNodes = std::pair{ ctx.numa_node(), patton::current_numa_node() };
+            auto lock = std::unique_lock<std::mutex>(mutex);
+            threadIndex_NumaNodes[ctx.thread_index()] = numaNodes;
+        });
+
+    CHECK(threadIndex_NumaNodes.size() == static_cast<std::size_t>(params.num_threads));
+    for (auto const& [threadIndex, numaNodes] : threadIndex_NumaNodes)
+    {
+        CAPTURE(threadIndex);
+        CHECK(numaNodes.first == numaNodes.second);
+        CHECK(std::find(topology.numa_nodes().begin(), topology.numa_nodes().end(), numaNodes.first) != topology.numa_nodes().end());
+    }
+}
+#endif // THREAD_PINNING_SUPPORTED
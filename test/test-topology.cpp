@@ -0,0 +1,180 @@
+
+#include <span>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>   // for equal()
+#include <filesystem>
+
+#include <patton/topology.hpp>
+
+#include <gsl-lite/gsl-lite.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+
+namespace {
+
+
+namespace fs = std::filesystem;
+
+
+void
+write_file(fs::path const& path, std::string const& contents)
+{
+    fs::create_directories(path.parent_path());
+    auto f = std::ofstream(path);
+    f << contents << '\n';
+}
+
+bool
+equal(std::span<int const> lhs, std::vector<int> const& rhs)
+{
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+
+    // Two packages with two cores each, two hardware threads per core, a shared L3 cache per package, and one NUMA node per
+    // package. SMT siblings are numbered the way Linux usually does it on x86, i.e. cpu i and cpu i+4 share a core.
+struct synthetic_sysfs
+{
+    fs::path root;
+
+    synthetic_sysfs()
+        : root(fs::temp_directory_path() / "patton-test-topology")
+    {
+        fs::remove_all(root);
+        auto cpuRoot = root / "devices/system/cpu";
+        write_file(cpuRoot / "online", "0-7");
+        for (int id = 0; id < 8; ++id)
+        {
+            int package = (id % 4) / 2;
+            int core = id % 2;
+            auto cpuPath = cpuRoot / ("cpu" + std::to_string(id));
+            write_file(cpuPath / "topology/physical_package_id", std::to_string(package));
+            write_file(cpuPath / "topology/core_id", std::to_string(core));
+
+            auto siblings = std::to_string(id % 4) + "," + std::to_string(id % 4 + 4);
+            auto writeCache = [&](int index, int level, char const* type, char const* size, char const* shared)
+            {
+                auto cachePath = cpuPath / ("cache/index" + std::to_string(index));
+                write_file(cachePath / "level", std::to_string(level));
+                write_file(cachePath / "type", type);
+                write_file(cachePath / "size", size);
+                write_file(cachePath / "coherency_line_size", "64");
+                write_file(cachePath / "ways_of_associativity", "8");
+                write_file(cachePath / "shared_cpu_list", shared);
+            };
+            writeCache(0, 1, "Data", "32K", siblings.c_str());
+            writeCache(1, 1, "Instruction", "32K", siblings.c_str());
+            writeCache(2, 2, "Unified", "1024K", siblings.c_str());
+            writeCache(3, 3, "Unified", "16M", package == 0 ? "0-1,4-5" : "2-3,6-7");
+        }
+        auto nodeRoot = root / "devices/system/node";
+        write_file(nodeRoot / "online", "0-1");
+        write_file(nodeRoot / "node0/cpulist", "0-1,4-5");
+        write_file(nodeRoot / "node1/cpulist", "2-3,6-7");
+    }
+    ~synthetic_sysfs()
+    {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+};
+
+
+} // anonymous namespace
+
+
+TEST_CASE("cpu_topology::from_sysfs() reads synthetic sysfs tree")
+{
+    auto sysfs = synthetic_sysfs{ };
+    auto topology = patton::cpu_topology::from_sysfs(sysfs.root.string());
+
+    REQUIRE(topology.hardware_threads().size() == 8);
+    CHECK(topology.contains(7));
+    CHECK(!topology.contains(8));
+    CHECK(!topology.contains(-1));
+
+    SECTION("cores")
+    {
+        REQUIRE(topology.num_cores() == 4);
+        for (int id = 0; id < 4; ++id)
+        {
+            int core = topology.hardware_thread(id).core;
+            CHECK(core == id);
+            CHECK(topology.hardware_thread(id + 4).core == core);
+            CHECK(equal(topology.core_hardware_threads(core), { id, id + 4 }));
+        }
+    }
+    SECTION("packages")
+    {
+        CHECK(equal(topology.packages(), { 0, 1 }));
+        CHECK(equal(topology.package_hardware_threads(0), { 0, 1, 4, 5 }));
+        CHECK(equal(topology.package_hardware_threads(1), { 2, 3, 6, 7 }));
+        CHECK(topology.contains(7));
+        CHECK(!topology.contains(8));
+        CHECK(!topology.contains(-1));
+    }
+    SECTION("NUMA nodes")
+    {
+        CHECK(equal(topology.numa_nodes(), { 0, 1 }));
+        CHECK(topology.hardware_thread(5).numa_node == 0);
+        CHECK(topology.hardware_thread(6).numa_node == 1);
+        CHECK(equal(topology.numa_node_hardware_threads(1), { 2, 3, 6, 7 }));
+    }
+    SECTION("caches")
+    {
+            // 4 cores with L1d, L1i, and L2 each, plus one L3 cache per package
+        CHECK(topology.caches().size() == 4*3 + 2);
+
+        auto l1d = topology.cache(5, 1);
+        REQUIRE(l1d != nullptr);
+        CHECK(l1d->type == patton::cache_type::data);
+        CHECK(l1d->size == 32*1024);
+        CHECK(l1d->line_size == 64);
+        CHECK(l1d->associativity == 8);
+        CHECK(l1d->hardware_threads == std::vector<int>{ 1, 5 });
+
+        auto l1i = topology.cache(5, 1, patton::cache_type::instruction);
+        REQUIRE(l1i != nullptr);
+        CHECK(l1i->type == patton::cache_type::instruction);
+
+        auto l2 = topology.cache(5, 2);
+        REQUIRE(l2 != nullptr);
+        CHECK(l2->type == patton::cache_type::unified);
+        CHECK(l2->size == 1024*1024);
+
+        CHECK(topology.cache(5, 4) == nullptr);
+
+        auto llc = topology.last_level_cache(6);
+        REQUIRE(llc != nullptr);
+        CHECK(llc->level == 3);
+        CHECK(llc->size == 16*1024*1024);
+        CHECK(llc->hardware_threads == std::vector<int>{ 2, 3, 6, 7 });
+        CHECK(llc == topology.last_level_cache(2));
+    }
+}
+
+TEST_CASE("cpu_topology::from_sysfs() throws if the CPU list is missing")
+{
+    auto root = std::filesystem::temp_directory_path() / "patton-test-topology-missing";
+    CHECK_THROWS_AS(patton::cpu_topology::from_sysfs(root.string()), std::runtime_error);
+}
+
+TEST_CASE("cpu_topology::system() is consistent")
+{
+    auto const& topology = patton::cpu_topology::system();
+    REQUIRE(!topology.hardware_threads().empty());
+    CHECK(topology.num_cores() > 0);
+    CHECK(topology.num_cores() <= gsl::ssize(topology.hardware_threads()));
+    CHECK(!topology.packages().empty());
+    CHECK(!topology.numa_nodes().empty());
+
+    for (auto const& hardwareThread : topology.hardware_threads())
+    {
+        CHECK(topology.contains(hardwareThread.id));
+        auto coreHardwareThreads = topology.core_hardware_threads(hardwareThread.core);
+        CHECK(std::find(coreHardwareThreads.begin(), coreHardwareThreads.end(), hardwareThread.id) != coreHardwareThreads.end());
+    }
+}